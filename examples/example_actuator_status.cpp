@@ -2,7 +2,8 @@
  * @file example_actuator_status.cpp
  * @brief Monitor actuator status via subscribeRobotState()
  *
- * Essential: state.actuators[], state.hasActuatorError()
+ * Essential: state.actuators[], state.hasActuatorError(),
+ *            onActuatorFault() / onActuatorRecovered()
  */
 
 #include <iostream>
@@ -10,6 +11,8 @@
 #include <thread>
 #include <csignal>
 #include <atomic>
+#include <deque>
+#include <mutex>
 #include "raisin_sdk/raisin_client.hpp"
 
 std::atomic<bool> running{true};
@@ -18,6 +21,16 @@ void signalHandler(int) {
     running = false;
 }
 
+// Recent fault/recovery events, shown below the table
+std::mutex eventMutex;
+std::deque<std::string> events;
+
+void logEvent(const std::string& line) {
+    std::lock_guard<std::mutex> lock(eventMutex);
+    events.push_back(line);
+    if (events.size() > 8) events.pop_front();
+}
+
 void printActuatorTable(const raisin_sdk::ExtendedRobotState& state) {
     // Clear screen and move cursor to top
     std::cout << "\033[2J\033[H";
@@ -68,6 +81,16 @@ void printActuatorTable(const raisin_sdk::ExtendedRobotState& state) {
         std::cout << "All actuators OK (standby/ready)" << std::endl;
     }
 
+    {
+        std::lock_guard<std::mutex> lock(eventMutex);
+        if (!events.empty()) {
+            std::cout << std::endl << "Recent events:" << std::endl;
+            for (const auto& line : events) {
+                std::cout << "  " << line << std::endl;
+            }
+        }
+    }
+
     std::cout << std::endl << "(Ctrl+C to stop)" << std::endl;
 }
 
@@ -90,18 +113,30 @@ int main(int argc, char* argv[]) {
     }
 
     // ===== ESSENTIAL =====
-    std::atomic<int> updateCounter{0};
-    client.subscribeRobotState([&](const raisin_sdk::ExtendedRobotState& state) {
-        if (++updateCounter % 10 == 0) {
-            printActuatorTable(state);
-        }
+    // Events fire only when a status word changes, not on every message
+    client.onActuatorFault([](const raisin_sdk::ActuatorStatusChange& change) {
+        logEvent("\033[31mFAULT\033[0m     " + change.actuator->name + ": " +
+                 raisin_sdk::getActuatorStatusName(change.previous_status) + " -> " +
+                 raisin_sdk::getActuatorStatusName(change.status));
+    });
+    client.onActuatorRecovered([](const raisin_sdk::ActuatorStatusChange& change) {
+        logEvent("\033[32mRECOVERED\033[0m " + change.actuator->name + ": " +
+                 raisin_sdk::getActuatorStatusName(change.previous_status) + " -> " +
+                 raisin_sdk::getActuatorStatusName(change.status));
     });
     // ==================
 
     std::cout << "Monitoring actuator status..." << std::endl;
 
+    // Redraw once per second from the latest state (no per-message work)
+    raisin_sdk::ExtendedRobotState state;
+    uint64_t seen = 0;
     while (running) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (client.getExtendedRobotStateVersion() != seen) {
+            seen = client.getExtendedRobotState(state);
+            printActuatorTable(state);
+        }
+        std::this_thread::sleep_for(std::chrono::seconds(1));
     }
 
     std::cout << std::endl << "Shutting down..." << std::endl;
@@ -1,8 +1,8 @@
 /**
  * @file example_battery.cpp
- * @brief Monitor battery status via subscribeRobotState()
+ * @brief Monitor battery status via enableBatteryEstimator()
  *
- * Essential: state.voltage, current, min_voltage, max_voltage, body_temperature
+ * Essential: estimate.soc, remaining_runtime_sec, energy_per_metre_wh
  */
 
 #include <iostream>
@@ -10,6 +10,7 @@
 #include <thread>
 #include <csignal>
 #include <atomic>
+#include <cmath>
 #include "raisin_sdk/raisin_client.hpp"
 
 std::atomic<bool> running{true};
@@ -37,22 +38,34 @@ int main(int argc, char* argv[]) {
     }
 
     // ===== ESSENTIAL =====
-    client.subscribeRobotState([](const raisin_sdk::ExtendedRobotState& state) {
-        double percentage = (state.voltage - state.min_voltage) /
-                           (state.max_voltage - state.min_voltage) * 100.0;
-
-        std::cout << "\r" << std::fixed << std::setprecision(1)
-                  << "Voltage: " << state.voltage << "V (" << percentage << "%)"
-                  << " | Current: " << state.current << "A"
-                  << " | Temp: " << state.body_temperature << "C          " << std::flush;
-    });
+    // Coulomb counting + load-compensated voltage; set capacity_ah to the pack rating
+    raisin_sdk::BatteryEstimatorConfig config;
+    config.capacity_ah = 20.0;
+    auto battery = client.enableBatteryEstimator(config);
     // ==================
 
     std::cout << "Monitoring battery status... (Ctrl+C to stop)" << std::endl;
     std::cout << std::endl;
 
+    raisin_sdk::ExtendedRobotState state;
     while (running) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        raisin_sdk::BatteryEstimate estimate = battery->estimate();
+        if (!estimate.valid) continue;
+        client.getExtendedRobotState(state);
+
+        std::cout << "\r" << std::fixed << std::setprecision(1)
+                  << "SoC: " << estimate.soc * 100.0 << "%"
+                  << " | Voltage: " << state.voltage << "V"
+                  << " | Current: " << estimate.average_current << "A";
+        if (std::isfinite(estimate.remaining_runtime_sec)) {
+            std::cout << " | Runtime: " << estimate.remaining_runtime_sec / 60.0 << "min";
+        }
+        if (estimate.energy_per_metre_wh > 0.0) {
+            std::cout << std::setprecision(2) << " | " << estimate.energy_per_metre_wh << "Wh/m"
+                      << std::setprecision(0) << " (" << estimate.remaining_range_m << "m left)";
+        }
+        std::cout << std::setprecision(1) << " | Temp: " << state.body_temperature << "C          " << std::flush;
     }
 
     std::cout << std::endl << "Shutting down..." << std::endl;
@@ -2,7 +2,8 @@
  * @file example_pointcloud.cpp
  * @brief Subscribe to LiDAR pointcloud via subscribePointCloud()
  *
- * Essential: points[].x, y, z, intensity
+ * Essential: points[].x, y, z
+ * Intensity/ring/time: subscribe with a PointCloudSoA callback instead
  */
 
 #include <iostream>
@@ -0,0 +1,307 @@
+/**
+ * @file battery.hpp
+ * @brief Battery state-of-charge, runtime and energy-per-metre estimation
+ *
+ * BatteryEstimator runs an extended Kalman filter on a one-RC Thevenin
+ * pack model (state of charge, ohmic resistance, polarization voltage) fed
+ * by the robot_state stream: coulomb counting on the measured current
+ * drives the prediction, and the voltage, compared against an
+ * open-circuit-voltage curve minus the ohmic and polarization drops,
+ * corrects it. Under load this stays steady where a linear voltage
+ * interpolation jumps with every current spike. Memory is constant.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+#include "raisin_sdk/robot_state.hpp"
+
+namespace raisin_sdk {
+
+/**
+ * @brief BatteryEstimator settings
+ */
+struct BatteryEstimatorConfig {
+    double capacity_ah = 20.0;              ///< Rated pack capacity; set this for your battery
+    /// Open-circuit voltage at SoC 0, 0.1, ..., 1 as a fraction of [min_voltage, max_voltage]
+    /// (default: typical Li-ion NMC cell, 3.0-4.2 V)
+    std::vector<double> ocv_curve = {0.0, 0.375, 0.458, 0.517, 0.558, 0.600,
+                                     0.650, 0.717, 0.792, 0.875, 1.0};
+    double initial_resistance = 0.05;       ///< Pack ohmic resistance guess (Ohm)
+    double polarization_resistance = 0.03;  ///< RC branch resistance (Ohm); a wrong value biases soc under sustained load
+    double polarization_time_constant = 30.0;  ///< RC branch time constant (s)
+    double voltage_noise = 0.3;             ///< Voltage measurement sigma (V)
+    double current_noise = 1.0;             ///< Current sensor sigma (A), drives SoC process noise
+    double soc_drift = 5e-4;                ///< Extra SoC process noise per sqrt(s) (capacity error, self-discharge)
+    double resistance_drift = 1e-4;         ///< Resistance random walk per sqrt(s) (Ohm)
+    double polarization_drift = 5e-3;       ///< Polarization voltage process noise per sqrt(s) (V)
+    double reserve_soc = 0.1;               ///< Runtime and range are computed down to this SoC
+    double current_time_constant = 60.0;    ///< Smoothing of the current used for runtime (s)
+    double moving_speed = 0.1;              ///< Speed (m/s) above which energy counts as walking energy
+    double energy_window_m = 200.0;         ///< Distance over which energy per metre is averaged
+    double max_dt = 1.0;                    ///< Longer message gaps are not integrated
+};
+
+/**
+ * @brief Output of BatteryEstimator
+ */
+struct BatteryEstimate {
+    bool valid = false;                     ///< False until a sample with a voltage range arrived
+    double soc = 0.0;                       ///< State of charge [0, 1]
+    double soc_stddev = 0.0;                ///< Filter uncertainty of soc
+    double internal_resistance = 0.0;       ///< Estimated ohmic resistance (Ohm)
+    double polarization_voltage = 0.0;      ///< Estimated RC branch drop (V)
+    double open_circuit_voltage = 0.0;      ///< Voltage with ohmic and polarization drops removed (V)
+    double average_current = 0.0;           ///< Smoothed current draw (A)
+    double remaining_ah = 0.0;              ///< Charge left above reserve_soc
+    double remaining_energy_wh = 0.0;       ///< Energy left above reserve_soc
+    double remaining_runtime_sec = std::numeric_limits<double>::infinity();  ///< At average_current
+    double energy_per_metre_wh = 0.0;       ///< Walking energy per metre of odometry (0 until 10 m walked)
+    double idle_power_w = 0.0;              ///< Smoothed power while standing still
+    double remaining_range_m = std::numeric_limits<double>::infinity();      ///< remaining_energy_wh / energy_per_metre_wh
+    double consumed_ah = 0.0;               ///< Coulomb count since reset
+    double distance_m = 0.0;                ///< Odometry distance since reset
+};
+
+/**
+ * @brief Incremental SoC/runtime estimator fed with robot_state messages
+ *
+ * Positive current means discharge. Distance comes from the base position
+ * in the same messages. Thread-safe: update() and estimate() take an
+ * internal mutex.
+ *
+ * @code
+ * raisin_sdk::BatteryEstimatorConfig config;
+ * config.capacity_ah = 28.0;
+ * auto battery = client.enableBatteryEstimator(config);
+ * raisin_sdk::BatteryEstimate e = battery->estimate();
+ * std::cout << e.soc * 100.0 << "%, " << e.remaining_runtime_sec / 60.0 << " min" << std::endl;
+ * @endcode
+ */
+class BatteryEstimator {
+public:
+    explicit BatteryEstimator(const BatteryEstimatorConfig& config = {}) : config_(config) {
+        if (config_.ocv_curve.size() < 2) config_.ocv_curve = BatteryEstimatorConfig().ocv_curve;
+        for (size_t i = 1; i < config_.ocv_curve.size(); ++i) {
+            config_.ocv_curve[i] = std::max(config_.ocv_curve[i], config_.ocv_curve[i - 1] + 1e-6);
+        }
+        config_.capacity_ah = std::max(config_.capacity_ah, 1e-3);
+        config_.voltage_noise = std::max(config_.voltage_noise, 1e-3);
+        reset();
+    }
+
+    const BatteryEstimatorConfig& config() const { return config_; }
+
+    /// Add one robot_state sample (stamp in seconds, increasing)
+    void update(const ExtendedRobotState& state, double stamp = now()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const double voltage = state.voltage;
+        const double current = state.current;
+        if (!std::isfinite(voltage) || !std::isfinite(current)) return;
+        if (state.max_voltage > state.min_voltage) {
+            minVoltage_ = state.min_voltage;
+            spanVoltage_ = state.max_voltage - state.min_voltage;
+        }
+        if (spanVoltage_ <= 0.0) return;   // no voltage range yet: cannot place SoC on the curve
+
+        if (!initialized_) {
+            initialize(voltage, current, stamp, state);
+            return;
+        }
+
+        const double dt = stamp - lastStamp_;
+        lastStamp_ = stamp;
+        if (dt > 0.0 && dt <= config_.max_dt) {
+            predict(current, dt);
+            track(state, voltage, current, dt);
+        }
+        correct(voltage, current);
+    }
+
+    /// Latest estimate (valid == false before the first usable sample)
+    BatteryEstimate estimate() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        BatteryEstimate out;
+        if (!initialized_) return out;
+        out.valid = true;
+        const double soc = x_[0];
+        out.soc = soc;
+        out.soc_stddev = std::sqrt(std::max(p_[0][0], 0.0));
+        out.internal_resistance = x_[1];
+        out.polarization_voltage = x_[2];
+        out.open_circuit_voltage = ocv(soc);
+        out.average_current = averageCurrent_;
+        const double usable = std::max(soc - config_.reserve_soc, 0.0);
+        out.remaining_ah = usable * config_.capacity_ah;
+        // Mean OCV between now and the reserve approximates the voltage the charge is drawn at
+        out.remaining_energy_wh = out.remaining_ah * 0.5 * (ocv(soc) + ocv(std::min(config_.reserve_soc, soc)));
+        if (averageCurrent_ > 1e-3) {
+            out.remaining_runtime_sec = out.remaining_ah * 3600.0 / averageCurrent_;
+        }
+        if (movingDistance_ >= std::min(10.0, config_.energy_window_m)) {
+            out.energy_per_metre_wh = movingEnergy_ / movingDistance_;
+            if (out.energy_per_metre_wh > 0.0) {
+                out.remaining_range_m = out.remaining_energy_wh / out.energy_per_metre_wh;
+            }
+        }
+        out.idle_power_w = idlePower_;
+        out.consumed_ah = consumedAh_;
+        out.distance_m = distance_;
+        return out;
+    }
+
+    /// Forget everything; the next sample re-initializes SoC from voltage
+    void reset() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        initialized_ = false;
+        minVoltage_ = 0.0;
+        spanVoltage_ = 0.0;
+        x_[0] = 0.0;
+        x_[1] = config_.initial_resistance;
+        x_[2] = 0.0;
+        for (auto& row : p_) std::fill(std::begin(row), std::end(row), 0.0);
+        averageCurrent_ = 0.0;
+        idlePower_ = 0.0;
+        movingEnergy_ = 0.0;
+        movingDistance_ = 0.0;
+        consumedAh_ = 0.0;
+        distance_ = 0.0;
+    }
+
+    /// Steady-clock time in seconds, the default update() stamp
+    static double now() {
+        return std::chrono::duration<double>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    /// Open-circuit voltage at soc (piecewise linear curve)
+    double ocv(double soc, double* slope = nullptr) const {
+        const size_t segments = config_.ocv_curve.size() - 1;
+        const double t = std::clamp(soc, 0.0, 1.0) * segments;
+        const size_t i = std::min(static_cast<size_t>(t), segments - 1);
+        const double lo = config_.ocv_curve[i];
+        const double hi = config_.ocv_curve[i + 1];
+        if (slope) *slope = (hi - lo) * segments * spanVoltage_;
+        return minVoltage_ + (lo + (t - i) * (hi - lo)) * spanVoltage_;
+    }
+
+    /// SoC whose open-circuit voltage is v (inverse of ocv())
+    double socAt(double v) const {
+        const double u = (v - minVoltage_) / spanVoltage_;
+        const auto& curve = config_.ocv_curve;
+        if (u <= curve.front()) return 0.0;
+        if (u >= curve.back()) return 1.0;
+        const size_t i = static_cast<size_t>(std::upper_bound(curve.begin(), curve.end(), u) - curve.begin()) - 1;
+        return (i + (u - curve[i]) / (curve[i + 1] - curve[i])) / (curve.size() - 1);
+    }
+
+    void initialize(double voltage, double current, double stamp, const ExtendedRobotState& state) {
+        x_[0] = socAt(voltage + current * x_[1]);
+        x_[2] = 0.0;
+        p_[0][0] = 0.05 * 0.05;
+        p_[1][1] = 0.25 * config_.initial_resistance * config_.initial_resistance;
+        p_[2][2] = std::pow(config_.polarization_resistance * std::abs(current) + 0.1, 2);
+        averageCurrent_ = current;
+        lastStamp_ = stamp;
+        lastX_ = state.x;
+        lastY_ = state.y;
+        initialized_ = true;
+    }
+
+    /// Coulomb counting on soc, first-order relaxation of the polarization voltage
+    void predict(double current, double dt) {
+        const double ampSeconds = config_.capacity_ah * 3600.0;
+        const double decay = std::exp(-dt / std::max(config_.polarization_time_constant, 1e-3));
+        x_[0] = std::clamp(x_[0] - current * dt / ampSeconds, 0.0, 1.0);
+        x_[2] = decay * x_[2] + (1.0 - decay) * config_.polarization_resistance * current;
+        consumedAh_ += current * dt / 3600.0;
+
+        // P = F P F' + Q with F = diag(1, 1, decay)
+        for (int i = 0; i < 3; ++i) {
+            p_[i][2] *= decay;
+            p_[2][i] *= decay;
+        }
+        const double qCurrent = config_.current_noise * dt / ampSeconds;
+        p_[0][0] += qCurrent * qCurrent + config_.soc_drift * config_.soc_drift * dt;
+        p_[1][1] += config_.resistance_drift * config_.resistance_drift * dt;
+        p_[2][2] += config_.polarization_drift * config_.polarization_drift * dt;
+    }
+
+    /// Measurement v = OCV(soc) - I * R0 - V1
+    void correct(double voltage, double current) {
+        double slope = 0.0;
+        const double predicted = ocv(x_[0], &slope) - current * x_[1] - x_[2];
+        const double h[3] = {slope, -current, -1.0};
+        double ph[3];
+        for (int i = 0; i < 3; ++i) {
+            ph[i] = p_[i][0] * h[0] + p_[i][1] * h[1] + p_[i][2] * h[2];
+        }
+        const double s = h[0] * ph[0] + h[1] * ph[1] + h[2] * ph[2] +
+                         config_.voltage_noise * config_.voltage_noise;
+        const double innovation = voltage - predicted;
+        double k[3];
+        for (int i = 0; i < 3; ++i) {
+            k[i] = ph[i] / s;
+            x_[i] += k[i] * innovation;
+        }
+        x_[0] = std::clamp(x_[0], 0.0, 1.0);
+        x_[1] = std::clamp(x_[1], 1e-4, 1.0);
+        // P = P - K (H P), kept symmetric
+        for (int i = 0; i < 3; ++i) {
+            for (int j = i; j < 3; ++j) {
+                p_[i][j] -= k[i] * ph[j];
+                p_[j][i] = p_[i][j];
+            }
+            p_[i][i] = std::max(p_[i][i], 1e-12);
+        }
+    }
+
+    /// Current smoothing, idle power and walking energy per metre
+    void track(const ExtendedRobotState& state, double voltage, double current, double dt) {
+        const double alpha = 1.0 - std::exp(-dt / std::max(config_.current_time_constant, dt));
+        averageCurrent_ += alpha * (current - averageCurrent_);
+
+        const double step = std::hypot(state.x - lastX_, state.y - lastY_);
+        lastX_ = state.x;
+        lastY_ = state.y;
+        const double power = voltage * current;
+        if (step / dt > config_.moving_speed && step < 5.0) {   // larger jumps are relocalization
+            distance_ += step;
+            movingDistance_ += step;
+            movingEnergy_ += power * dt / 3600.0;
+            if (movingDistance_ > config_.energy_window_m) {
+                const double scale = config_.energy_window_m / movingDistance_;
+                movingDistance_ *= scale;
+                movingEnergy_ *= scale;
+            }
+        } else {
+            idlePower_ += alpha * (power - idlePower_);
+        }
+    }
+
+    BatteryEstimatorConfig config_;
+    bool initialized_ = false;
+    double minVoltage_ = 0.0;
+    double spanVoltage_ = 0.0;
+    double x_[3] = {};           ///< soc, ohmic resistance, polarization voltage
+    double p_[3][3] = {};        ///< State covariance
+    double lastStamp_ = 0.0;
+    double lastX_ = 0.0;
+    double lastY_ = 0.0;
+    double averageCurrent_ = 0.0;
+    double idlePower_ = 0.0;
+    double movingEnergy_ = 0.0;  ///< Wh over the last energy_window_m of walking
+    double movingDistance_ = 0.0;
+    double consumedAh_ = 0.0;
+    double distance_ = 0.0;
+    mutable std::mutex mutex_;
+};
+
+}  // namespace raisin_sdk
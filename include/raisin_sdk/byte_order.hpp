@@ -0,0 +1,61 @@
+/**
+ * @file byte_order.hpp
+ * @brief Little-endian load/store for on-disk and on-wire headers
+ *
+ * Record and frame headers are defined as little-endian byte layouts, not
+ * as the in-memory image of a struct. These helpers compile to a plain
+ * memcpy on little-endian hosts and swap bytes elsewhere.
+ */
+
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace raisin_sdk {
+namespace detail {
+
+template <size_t Size> struct UnsignedOfSize;
+template <> struct UnsignedOfSize<1> { using type = uint8_t; };
+template <> struct UnsignedOfSize<2> { using type = uint16_t; };
+template <> struct UnsignedOfSize<4> { using type = uint32_t; };
+template <> struct UnsignedOfSize<8> { using type = uint64_t; };
+
+/// Write an integer or floating-point value as sizeof(T) little-endian bytes
+template <typename T>
+inline void storeLE(uint8_t* out, T value) {
+    static_assert(std::is_arithmetic<T>::value, "storeLE needs an arithmetic type");
+    if constexpr (std::endian::native == std::endian::little) {
+        std::memcpy(out, &value, sizeof(T));
+    } else {
+        using U = typename UnsignedOfSize<sizeof(T)>::type;
+        const U bits = std::bit_cast<U>(value);
+        for (size_t b = 0; b < sizeof(T); ++b) {
+            out[b] = static_cast<uint8_t>(bits >> (8 * b));
+        }
+    }
+}
+
+/// Read sizeof(T) little-endian bytes
+template <typename T>
+inline T loadLE(const uint8_t* in) {
+    static_assert(std::is_arithmetic<T>::value, "loadLE needs an arithmetic type");
+    if constexpr (std::endian::native == std::endian::little) {
+        T value;
+        std::memcpy(&value, in, sizeof(T));
+        return value;
+    } else {
+        using U = typename UnsignedOfSize<sizeof(T)>::type;
+        U bits = 0;
+        for (size_t b = 0; b < sizeof(T); ++b) {
+            bits |= static_cast<U>(static_cast<U>(in[b]) << (8 * b));
+        }
+        return std::bit_cast<T>(bits);
+    }
+}
+
+}  // namespace detail
+}  // namespace raisin_sdk
@@ -0,0 +1,428 @@
+/**
+ * @file cloud_codec.hpp
+ * @brief Quantized, delta-coded and zstd-compressed point cloud frames
+ *
+ * CloudEncoder turns a decoded cloud into a compact, self-contained frame:
+ * positions are quantized to a fixed step (1 mm by default), delta-coded
+ * along scan order, zigzag-mapped and byte-shuffled so zstd sees long runs
+ * of near-zero bytes. CloudFrameDecoder reverses it. Both keep their zstd
+ * context and scratch buffers, so steady-state frames do not allocate.
+ *
+ * This header needs <zstd.h> and libzstd (already linked by the SDK build);
+ * it is not included by raisin_client.hpp.
+ */
+
+#pragma once
+
+#include <zstd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "raisin_sdk/byte_order.hpp"
+#include "raisin_sdk/point_cloud.hpp"
+#include "raisin_sdk/point_cloud_soa.hpp"
+
+namespace raisin_sdk {
+
+/**
+ * @brief Encoder settings
+ */
+struct CloudCodecConfig {
+    float quantum = 0.001f;            ///< Position step in metres (max error is half of this); > 0
+    float intensity_quantum = 0.1f;    ///< Intensity step; > 0 when intensity is kept
+    bool keep_intensity = true;        ///< Encode intensity when the SoA cloud has it
+    bool keep_ring = true;             ///< Encode ring when the SoA cloud has it
+    int compression_level = 3;         ///< zstd level (1 = fastest, 19 = smallest)
+};
+
+namespace detail {
+
+constexpr uint32_t kCloudFrameMagic = 0x31434352;   // "RCC1"
+constexpr uint8_t kCloudFrameVersion = 1;
+constexpr size_t kCloudFrameHeaderSize = 32;
+
+enum CloudFrameFlags : uint8_t {
+    FRAME_INTENSITY = 1 << 0,
+    FRAME_RING = 1 << 1
+};
+
+/**
+ * @brief Fixed little-endian frame header (frame = header + zstd payload)
+ * On the wire it is the kCloudFrameHeaderSize-byte image written by
+ * serialize(), whatever the host byte order.
+ */
+struct CloudFrameHeader {
+    uint32_t magic = kCloudFrameMagic;
+    uint8_t version = kCloudFrameVersion;
+    uint8_t flags = 0;
+    uint16_t reserved = 0;
+    uint32_t count = 0;              ///< Points in the frame
+    float quantum = 0.0f;
+    float intensity_quantum = 0.0f;
+    uint32_t raw_size = 0;           ///< Payload size before zstd
+    uint32_t compressed_size = 0;    ///< Payload size after zstd
+    uint32_t reserved2 = 0;
+
+    /// Write the kCloudFrameHeaderSize-byte little-endian image
+    void serialize(uint8_t* out) const {
+        storeLE(out, magic);
+        storeLE(out + 4, version);
+        storeLE(out + 5, flags);
+        storeLE(out + 6, reserved);
+        storeLE(out + 8, count);
+        storeLE(out + 12, quantum);
+        storeLE(out + 16, intensity_quantum);
+        storeLE(out + 20, raw_size);
+        storeLE(out + 24, compressed_size);
+        storeLE(out + 28, reserved2);
+    }
+
+    /// Read a header written by serialize(); false if the magic does not match
+    bool deserialize(const uint8_t* in) {
+        magic = loadLE<uint32_t>(in);
+        version = loadLE<uint8_t>(in + 4);
+        flags = loadLE<uint8_t>(in + 5);
+        reserved = loadLE<uint16_t>(in + 6);
+        count = loadLE<uint32_t>(in + 8);
+        quantum = loadLE<float>(in + 12);
+        intensity_quantum = loadLE<float>(in + 16);
+        raw_size = loadLE<uint32_t>(in + 20);
+        compressed_size = loadLE<uint32_t>(in + 24);
+        reserved2 = loadLE<uint32_t>(in + 28);
+        return magic == kCloudFrameMagic;
+    }
+};
+
+inline uint32_t zigzag(int32_t v) {
+    return (static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31);
+}
+
+inline int32_t unzigzag(uint32_t v) {
+    return static_cast<int32_t>(v >> 1) ^ -static_cast<int32_t>(v & 1);
+}
+
+inline int32_t quantize(float v, float inverseStep) {
+    const double q = std::nearbyint(static_cast<double>(v) * inverseStep);
+    if (q > 2147483647.0) return 2147483647;
+    if (q < -2147483648.0) return -2147483647 - 1;
+    return static_cast<int32_t>(q);
+}
+
+/// Write the bytes of n Width-byte values as Width planes (byte b of every value together)
+template <size_t Width, typename T>
+inline void shufflePlanes(const T* values, size_t n, uint8_t* out) {
+    static_assert(sizeof(T) == Width, "plane width must match value size");
+    for (size_t i = 0; i < n; ++i) {
+        const T v = values[i];
+        for (size_t b = 0; b < Width; ++b) {
+            out[b * n + i] = static_cast<uint8_t>(v >> (8 * b));
+        }
+    }
+}
+
+template <size_t Width, typename T>
+inline void unshufflePlanes(const uint8_t* in, size_t n, T* values) {
+    static_assert(sizeof(T) == Width, "plane width must match value size");
+    for (size_t i = 0; i < n; ++i) {
+        T v = 0;
+        for (size_t b = 0; b < Width; ++b) {
+            v |= static_cast<T>(static_cast<T>(in[b * n + i]) << (8 * b));
+        }
+        values[i] = v;
+    }
+}
+
+struct ZstdCCtxDeleter {
+    void operator()(ZSTD_CCtx* ctx) const { ZSTD_freeCCtx(ctx); }
+};
+
+struct ZstdDCtxDeleter {
+    void operator()(ZSTD_DCtx* ctx) const { ZSTD_freeDCtx(ctx); }
+};
+
+}  // namespace detail
+
+/**
+ * @brief Encodes clouds into compressed frames
+ *
+ * Non-finite points are skipped. Ring/intensity are only encoded from SoA
+ * clouds; the per-point time channel is not carried.
+ *
+ * @code
+ * raisin_sdk::CloudEncoder encoder;           // keep across frames
+ * std::vector<uint8_t> frame;                 // reused output buffer
+ * if (encoder.encode(points, frame)) send(frame.data(), frame.size());
+ * @endcode
+ */
+class CloudEncoder {
+public:
+    explicit CloudEncoder(const CloudCodecConfig& config = {})
+        : config_(config), ctx_(ZSTD_createCCtx()) {}
+
+    const CloudCodecConfig& config() const { return config_; }
+    void setConfig(const CloudCodecConfig& config) { config_ = config; }
+
+    /// Encode x/y/z; returns false on a non-positive quantum or a zstd error (see lastError())
+    bool encode(const std::vector<Point3D>& points, std::vector<uint8_t>& out) {
+        return encodePoints(points.size(), [&points](size_t i) { return points[i]; },
+                            nullptr, nullptr, out);
+    }
+
+    /// Encode x/y/z plus intensity/ring if present and enabled
+    bool encode(const PointCloudSoA& cloud, std::vector<uint8_t>& out) {
+        const float* intensity = config_.keep_intensity && cloud.has_intensity ? cloud.intensity.data() : nullptr;
+        const uint16_t* ring = config_.keep_ring && cloud.has_ring ? cloud.ring.data() : nullptr;
+        return encodePoints(cloud.size(), [&cloud](size_t i) { return cloud.point(i); },
+                            intensity, ring, out);
+    }
+
+    const std::string& lastError() const { return lastError_; }
+
+private:
+    CloudCodecConfig config_;
+    std::unique_ptr<ZSTD_CCtx, detail::ZstdCCtxDeleter> ctx_;
+    std::vector<uint32_t> deltas_[3];
+    std::vector<uint16_t> deltas16_;
+    std::vector<uint8_t> raw_;
+    std::string lastError_;
+
+    template <typename PointFn>
+    bool encodePoints(size_t n, const PointFn& pointAt, const float* intensity, const uint16_t* ring,
+                      std::vector<uint8_t>& out) {
+        if (!ctx_) {
+            lastError_ = "failed to create zstd context";
+            return false;
+        }
+        // A zero step makes 0 * (1 / step) NaN, which quantize() cannot cast
+        const auto validStep = [](float step) { return step > 0.0f && std::isfinite(step); };
+        if (!validStep(config_.quantum) || (intensity && !validStep(config_.intensity_quantum))) {
+            lastError_ = "quantum must be positive and finite";
+            out.clear();
+            return false;
+        }
+        const float inverse = 1.0f / config_.quantum;
+        const float inverseIntensity = 1.0f / config_.intensity_quantum;
+
+        // Quantize and delta-code finite points along scan order
+        for (auto& d : deltas_) d.resize(n);
+        if (intensity || ring) deltas16_.resize(n * ((intensity ? 1 : 0) + (ring ? 1 : 0)));
+        uint16_t* intensityDeltas = deltas16_.data();
+        uint16_t* ringDeltas = deltas16_.data() + (intensity ? n : 0);
+        int32_t prev[3] = {0, 0, 0};
+        uint16_t prevIntensity = 0;
+        uint16_t prevRing = 0;
+        size_t kept = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const Point3D p = pointAt(i);
+            if (!std::isfinite(p.x) || !std::isfinite(p.y) || !std::isfinite(p.z)) continue;
+            const int32_t q[3] = {detail::quantize(p.x, inverse), detail::quantize(p.y, inverse),
+                                  detail::quantize(p.z, inverse)};
+            for (int a = 0; a < 3; ++a) {
+                deltas_[a][kept] = detail::zigzag(static_cast<int32_t>(
+                    static_cast<uint32_t>(q[a]) - static_cast<uint32_t>(prev[a])));
+                prev[a] = q[a];
+            }
+            if (intensity) {
+                const float scaled = std::nearbyint(std::fmax(0.0f, intensity[i] * inverseIntensity));
+                const uint16_t v = scaled > 65535.0f ? 65535 : static_cast<uint16_t>(scaled);
+                intensityDeltas[kept] = static_cast<uint16_t>(v - prevIntensity);
+                prevIntensity = v;
+            }
+            if (ring) {
+                ringDeltas[kept] = static_cast<uint16_t>(ring[i] - prevRing);
+                prevRing = ring[i];
+            }
+            ++kept;
+        }
+
+        // Byte planes: [x][y][z] (4 planes each), then intensity and ring (2 planes each)
+        const size_t rawSize = kept * (12 + (intensity ? 2 : 0) + (ring ? 2 : 0));
+        raw_.resize(rawSize);
+        uint8_t* dst = raw_.data();
+        for (auto& d : deltas_) {
+            detail::shufflePlanes<4>(d.data(), kept, dst);
+            dst += kept * 4;
+        }
+        if (intensity) {
+            detail::shufflePlanes<2>(intensityDeltas, kept, dst);
+            dst += kept * 2;
+        }
+        if (ring) {
+            detail::shufflePlanes<2>(ringDeltas, kept, dst);
+        }
+
+        detail::CloudFrameHeader header;
+        header.flags = static_cast<uint8_t>((intensity ? detail::FRAME_INTENSITY : 0) |
+                                            (ring ? detail::FRAME_RING : 0));
+        header.count = static_cast<uint32_t>(kept);
+        header.quantum = config_.quantum;
+        header.intensity_quantum = config_.intensity_quantum;
+        header.raw_size = static_cast<uint32_t>(rawSize);
+
+        out.resize(detail::kCloudFrameHeaderSize + ZSTD_compressBound(rawSize));
+        const size_t level = ZSTD_CCtx_setParameter(ctx_.get(), ZSTD_c_compressionLevel,
+                                                    config_.compression_level);
+        if (ZSTD_isError(level)) {
+            lastError_ = ZSTD_getErrorName(level);
+            out.clear();
+            return false;
+        }
+        const size_t compressed = ZSTD_compress2(ctx_.get(), out.data() + detail::kCloudFrameHeaderSize,
+                                                 out.size() - detail::kCloudFrameHeaderSize,
+                                                 raw_.data(), rawSize);
+        if (ZSTD_isError(compressed)) {
+            lastError_ = ZSTD_getErrorName(compressed);
+            out.clear();
+            return false;
+        }
+        header.compressed_size = static_cast<uint32_t>(compressed);
+        header.serialize(out.data());
+        out.resize(detail::kCloudFrameHeaderSize + compressed);
+        return true;
+    }
+};
+
+/**
+ * @brief Decodes frames produced by CloudEncoder
+ *
+ * @code
+ * raisin_sdk::CloudFrameDecoder decoder;
+ * raisin_sdk::PointCloudSoA cloud;
+ * if (!decoder.decode(data, size, cloud)) std::cerr << decoder.lastError() << std::endl;
+ * @endcode
+ */
+class CloudFrameDecoder {
+public:
+    CloudFrameDecoder() : ctx_(ZSTD_createDCtx()) {}
+
+    /// Decode positions only
+    bool decode(const uint8_t* data, size_t size, std::vector<Point3D>& out) {
+        if (!decompress(data, size)) return false;
+        const size_t n = header_.count;
+        out.resize(n);
+        reconstruct(n, [&out](size_t i, float x, float y, float z) { out[i] = {x, y, z}; });
+        return true;
+    }
+
+    /// Decode positions plus any intensity/ring channels in the frame
+    bool decode(const uint8_t* data, size_t size, PointCloudSoA& out) {
+        if (!decompress(data, size)) return false;
+        const size_t n = header_.count;
+        out.has_intensity = (header_.flags & detail::FRAME_INTENSITY) != 0;
+        out.has_ring = (header_.flags & detail::FRAME_RING) != 0;
+        out.has_time = false;
+        out.resize(n);
+        reconstruct(n, [&out](size_t i, float x, float y, float z) {
+            out.x[i] = x;
+            out.y[i] = y;
+            out.z[i] = z;
+        });
+
+        const uint8_t* src = raw_.data() + n * 12;
+        if (out.has_intensity) {
+            deltas16_.resize(n);
+            detail::unshufflePlanes<2>(src, n, deltas16_.data());
+            uint16_t value = 0;
+            for (size_t i = 0; i < n; ++i) {
+                value = static_cast<uint16_t>(value + deltas16_[i]);
+                out.intensity[i] = value * header_.intensity_quantum;
+            }
+            src += n * 2;
+        } else {
+            std::fill(out.intensity.begin(), out.intensity.end(), 0.0f);
+        }
+        if (out.has_ring) {
+            detail::unshufflePlanes<2>(src, n, out.ring.data());
+            uint16_t value = 0;
+            for (size_t i = 0; i < n; ++i) {
+                value = static_cast<uint16_t>(value + out.ring[i]);
+                out.ring[i] = value;
+            }
+        }
+        return true;
+    }
+
+    bool decode(const std::vector<uint8_t>& frame, std::vector<Point3D>& out) {
+        return decode(frame.data(), frame.size(), out);
+    }
+
+    bool decode(const std::vector<uint8_t>& frame, PointCloudSoA& out) {
+        return decode(frame.data(), frame.size(), out);
+    }
+
+    /// Size of the frame starting at data (0 if the header is incomplete or invalid),
+    /// for splitting a byte stream into frames
+    static size_t frameSize(const uint8_t* data, size_t size) {
+        if (size < detail::kCloudFrameHeaderSize) return 0;
+        detail::CloudFrameHeader header;
+        if (!header.deserialize(data)) return 0;
+        return detail::kCloudFrameHeaderSize + header.compressed_size;
+    }
+
+    const std::string& lastError() const { return lastError_; }
+
+private:
+    std::unique_ptr<ZSTD_DCtx, detail::ZstdDCtxDeleter> ctx_;
+    detail::CloudFrameHeader header_;
+    std::vector<uint8_t> raw_;
+    std::vector<uint32_t> deltas_;
+    std::vector<uint16_t> deltas16_;
+    std::string lastError_;
+
+    bool fail(const char* message) {
+        lastError_ = message;
+        return false;
+    }
+
+    bool decompress(const uint8_t* data, size_t size) {
+        if (!ctx_) return fail("failed to create zstd context");
+        if (size < detail::kCloudFrameHeaderSize) return fail("truncated frame header");
+        if (!header_.deserialize(data)) return fail("not a cloud frame");
+        if (header_.version != detail::kCloudFrameVersion) return fail("unsupported frame version");
+        if (size < detail::kCloudFrameHeaderSize + header_.compressed_size) return fail("truncated frame payload");
+
+        const size_t expected = static_cast<size_t>(header_.count) *
+                                (12 + ((header_.flags & detail::FRAME_INTENSITY) ? 2 : 0) +
+                                 ((header_.flags & detail::FRAME_RING) ? 2 : 0));
+        if (expected != header_.raw_size) return fail("inconsistent frame header");
+
+        raw_.resize(header_.raw_size);
+        const size_t got = ZSTD_decompressDCtx(ctx_.get(), raw_.data(), raw_.size(),
+                                               data + detail::kCloudFrameHeaderSize, header_.compressed_size);
+        if (ZSTD_isError(got)) {
+            lastError_ = ZSTD_getErrorName(got);
+            return false;
+        }
+        if (got != header_.raw_size) return fail("frame payload size mismatch");
+        return true;
+    }
+
+    template <typename StoreFn>
+    void reconstruct(size_t n, const StoreFn& store) {
+        deltas_.resize(n * 3);
+        for (size_t a = 0; a < 3; ++a) {
+            detail::unshufflePlanes<4>(raw_.data() + a * n * 4, n, deltas_.data() + a * n);
+        }
+        const uint32_t* dx = deltas_.data();
+        const uint32_t* dy = dx + n;
+        const uint32_t* dz = dy + n;
+        const double step = header_.quantum;
+        uint32_t qx = 0, qy = 0, qz = 0;   // unsigned so wrap-around is defined
+        for (size_t i = 0; i < n; ++i) {
+            qx += static_cast<uint32_t>(detail::unzigzag(dx[i]));
+            qy += static_cast<uint32_t>(detail::unzigzag(dy[i]));
+            qz += static_cast<uint32_t>(detail::unzigzag(dz[i]));
+            store(i, static_cast<float>(static_cast<int32_t>(qx) * step),
+                  static_cast<float>(static_cast<int32_t>(qy) * step),
+                  static_cast<float>(static_cast<int32_t>(qz) * step));
+        }
+    }
+};
+
+}  // namespace raisin_sdk
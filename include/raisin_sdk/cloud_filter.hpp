@@ -0,0 +1,181 @@
+/**
+ * @file cloud_filter.hpp
+ * @brief Composable point filters evaluated while decoding
+ *
+ * CloudFilter combines an axis-aligned crop box, a radial range band, a
+ * z band and a robot-body exclusion box into one predicate. The decode
+ * paths call it per point as they read the message, so rejected points
+ * are never written out.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "raisin_sdk/point_cloud.hpp"
+
+namespace raisin_sdk {
+
+/**
+ * @brief Axis-aligned box
+ */
+struct Box3 {
+    float min_x = 0.0f, min_y = 0.0f, min_z = 0.0f;
+    float max_x = 0.0f, max_y = 0.0f, max_z = 0.0f;
+
+    Box3() = default;
+    Box3(float minX, float minY, float minZ, float maxX, float maxY, float maxZ)
+        : min_x(minX), min_y(minY), min_z(minZ), max_x(maxX), max_y(maxY), max_z(maxZ) {}
+
+    bool contains(float x, float y, float z) const {
+        return x >= min_x && x <= max_x && y >= min_y && y <= max_y && z >= min_z && z <= max_z;
+    }
+
+    bool operator==(const Box3&) const = default;
+};
+
+/**
+ * @brief Fused point filter pipeline
+ *
+ * Stages are enabled by chaining setters; a default-constructed filter is
+ * inactive and decode paths skip it. Once active, non-finite points are
+ * always rejected. Stages are tested in order crop box, z band,
+ * range, body box, and a point must pass all of them.
+ *
+ * By default points are tested in the cloud's own frame. With
+ * robotRelative(), they are first moved into a robot-centred frame
+ * (translation plus yaw) set through setRobotPose(); RaisinClient does
+ * this from the latest odometry.
+ *
+ * @code
+ * raisin_sdk::CloudFilter filter = raisin_sdk::CloudFilter()
+ *     .robotRelative()
+ *     .range(0.3f, 30.0f)
+ *     .zBand(-0.5f, 1.5f)
+ *     .excludeBox({-0.5f, -0.3f, -0.5f, 0.5f, 0.3f, 0.3f});
+ * @endcode
+ */
+class CloudFilter {
+public:
+    /// Keep only points inside box
+    CloudFilter& cropBox(const Box3& box) {
+        cropBox_ = box;
+        useCropBox_ = true;
+        return *this;
+    }
+
+    /// Keep points with minRange <= |p| <= maxRange (metres)
+    CloudFilter& range(float minRange, float maxRange) {
+        minRangeSq_ = minRange > 0.0f ? minRange * minRange : 0.0f;
+        maxRangeSq_ = maxRange * maxRange;
+        useRange_ = true;
+        return *this;
+    }
+
+    /// Keep points with minZ <= z <= maxZ
+    CloudFilter& zBand(float minZ, float maxZ) {
+        minZ_ = minZ;
+        maxZ_ = maxZ;
+        useZBand_ = true;
+        return *this;
+    }
+
+    /// Drop points inside box (e.g. the robot's own body)
+    CloudFilter& excludeBox(const Box3& box) {
+        excludeBox_ = box;
+        useExcludeBox_ = true;
+        return *this;
+    }
+
+    /// Test points in a robot-centred frame (see setRobotPose())
+    CloudFilter& robotRelative(bool enable = true) {
+        robotRelative_ = enable;
+        return *this;
+    }
+
+    /// Robot pose in the cloud's frame, used when robotRelative() is set
+    void setRobotPose(double x, double y, double z, double yaw) {
+        originX_ = static_cast<float>(x);
+        originY_ = static_cast<float>(y);
+        originZ_ = static_cast<float>(z);
+        cosYaw_ = static_cast<float>(std::cos(yaw));
+        sinYaw_ = static_cast<float>(std::sin(yaw));
+    }
+
+    bool isRobotRelative() const { return robotRelative_; }
+
+    /// True if any stage is enabled
+    bool active() const { return useCropBox_ || useRange_ || useZBand_ || useExcludeBox_; }
+
+    /// Whether a point passes every enabled stage
+    bool accept(float x, float y, float z) const {
+        if (!std::isfinite(x) || !std::isfinite(y) || !std::isfinite(z)) return false;
+
+        if (robotRelative_) {
+            const float dx = x - originX_;
+            const float dy = y - originY_;
+            x = cosYaw_ * dx + sinYaw_ * dy;
+            y = -sinYaw_ * dx + cosYaw_ * dy;
+            z = z - originZ_;
+        }
+
+        if (useCropBox_ && !cropBox_.contains(x, y, z)) return false;
+        if (useZBand_ && (z < minZ_ || z > maxZ_)) return false;
+        if (useRange_) {
+            const float rangeSq = x * x + y * y + z * z;
+            if (rangeSq < minRangeSq_ || rangeSq > maxRangeSq_) return false;
+        }
+        if (useExcludeBox_ && excludeBox_.contains(x, y, z)) return false;
+        return true;
+    }
+
+    bool accept(const Point3D& p) const { return accept(p.x, p.y, p.z); }
+
+    /// Same stages, parameters and robot pose, so both filters keep the same points
+    bool operator==(const CloudFilter&) const = default;
+
+    /**
+     * @brief Read points from the message and keep the accepted ones
+     * Single pass over msg->data; out reuses its capacity.
+     */
+    void apply(const PointCloudView& in, std::vector<Point3D>& out) const {
+        if (!active()) {
+            in.copyTo(out);
+            return;
+        }
+        out.clear();
+        if (!in.hasXYZ()) return;
+        out.resize(in.size());
+        size_t kept = 0;
+        for (size_t i = 0; i < in.size(); ++i) {
+            const Point3D p = in.point(i);
+            if (accept(p)) out[kept++] = p;
+        }
+        out.resize(kept);
+    }
+
+private:
+    bool useCropBox_ = false;
+    bool useRange_ = false;
+    bool useZBand_ = false;
+    bool useExcludeBox_ = false;
+    bool robotRelative_ = false;
+
+    Box3 cropBox_;
+    Box3 excludeBox_;
+    float minRangeSq_ = 0.0f;
+    float maxRangeSq_ = std::numeric_limits<float>::infinity();
+    float minZ_ = -std::numeric_limits<float>::infinity();
+    float maxZ_ = std::numeric_limits<float>::infinity();
+
+    float originX_ = 0.0f;
+    float originY_ = 0.0f;
+    float originZ_ = 0.0f;
+    float cosYaw_ = 1.0f;
+    float sinYaw_ = 0.0f;
+};
+
+}  // namespace raisin_sdk
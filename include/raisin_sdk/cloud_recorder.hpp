@@ -0,0 +1,677 @@
+/**
+ * @file cloud_recorder.hpp
+ * @brief Streaming PCD capture of decoded clouds on a background thread
+ *
+ * CloudRecorder copies each cloud into a recycled frame buffer and returns;
+ * a writer thread serializes frames as binary or binary_compressed PCD
+ * (readable by PCL and CloudCompare) straight into a large page-aligned
+ * write buffer, without going through pcl::io. Frames go to one file each
+ * or are appended to a single container file. The odometry pose is stored
+ * in the PCD VIEWPOINT and the capture time in a header comment.
+ */
+
+#pragma once
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "raisin_sdk/byte_order.hpp"
+#include "raisin_sdk/point_cloud.hpp"
+#include "raisin_sdk/point_cloud_soa.hpp"
+#include "raisin_sdk/point_cloud_decoder.hpp"
+
+namespace raisin_sdk {
+
+/**
+ * @brief Output layout of a recording
+ */
+enum class RecordFormat {
+    PCD_BINARY,              ///< One binary PCD file per frame
+    PCD_BINARY_COMPRESSED,   ///< One LZF binary_compressed PCD file per frame
+    CONTAINER                ///< All frames appended to one file (see detail::RecordHeader)
+};
+
+/**
+ * @brief Sensor/robot pose attached to a recorded frame
+ */
+struct CloudPose {
+    double x = 0.0, y = 0.0, z = 0.0;
+    double qw = 1.0, qx = 0.0, qy = 0.0, qz = 0.0;
+
+    /// Planar pose as produced by odometry (RobotState)
+    static CloudPose fromYaw(double x, double y, double z, double yaw) {
+        CloudPose pose;
+        pose.x = x;
+        pose.y = y;
+        pose.z = z;
+        pose.qw = std::cos(yaw * 0.5);
+        pose.qz = std::sin(yaw * 0.5);
+        return pose;
+    }
+};
+
+/**
+ * @brief Recorder settings
+ */
+struct CloudRecorderConfig {
+    std::string path = "clouds";               ///< Output directory, or the container file for CONTAINER
+    std::string prefix = "cloud";              ///< Per-frame file names: <prefix>_000001.pcd
+    RecordFormat format = RecordFormat::PCD_BINARY;
+    bool compress_container = true;            ///< CONTAINER records hold binary_compressed PCDs
+    size_t max_queued_frames = 16;             ///< Frames waiting for the writer; newer ones are dropped
+    size_t write_buffer_bytes = 8u << 20;      ///< Page-aligned write buffer size
+};
+
+/**
+ * @brief Recorder counters
+ */
+struct RecorderStats {
+    uint64_t recorded = 0;   ///< Frames accepted by record()
+    uint64_t written = 0;    ///< Frames fully written
+    uint64_t dropped = 0;    ///< Frames rejected because the writer fell behind
+    uint64_t bytes = 0;      ///< Bytes written to disk
+    bool failed = false;     ///< A write failed; see lastError()
+};
+
+namespace detail {
+
+constexpr uint32_t kRecordMagic = 0x31524352;   // "RCR1"
+constexpr uint8_t kRecordVersion = 1;
+constexpr size_t kRecordHeaderSize = 96;
+
+/**
+ * @brief Fixed little-endian header in front of every CONTAINER record
+ *
+ * On disk the fields follow each other in declaration order with no
+ * padding (see serialize()). The payload is a complete PCD file, so a
+ * frame can be cut out of the container and opened directly.
+ */
+struct RecordHeader {
+    uint32_t magic = kRecordMagic;
+    uint8_t version = kRecordVersion;
+    uint8_t compressed = 0;         ///< Payload uses DATA binary_compressed
+    uint16_t reserved = 0;
+    uint64_t payload_size = 0;      ///< Bytes of PCD following this header
+    uint64_t sequence = 0;
+    uint64_t num_points = 0;
+    double stamp = 0.0;             ///< Wall-clock seconds since epoch
+    double pose[7] = {0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0};   ///< x y z qw qx qy qz
+
+    /// Write the kRecordHeaderSize-byte little-endian image
+    void serialize(uint8_t* out) const {
+        storeLE(out, magic);
+        storeLE(out + 4, version);
+        storeLE(out + 5, compressed);
+        storeLE(out + 6, reserved);
+        storeLE(out + 8, payload_size);
+        storeLE(out + 16, sequence);
+        storeLE(out + 24, num_points);
+        storeLE(out + 32, stamp);
+        for (size_t i = 0; i < 7; ++i) storeLE(out + 40 + 8 * i, pose[i]);
+    }
+
+    /// Read a header written by serialize(); false if the magic does not match
+    bool deserialize(const uint8_t* in) {
+        magic = loadLE<uint32_t>(in);
+        version = loadLE<uint8_t>(in + 4);
+        compressed = loadLE<uint8_t>(in + 5);
+        reserved = loadLE<uint16_t>(in + 6);
+        payload_size = loadLE<uint64_t>(in + 8);
+        sequence = loadLE<uint64_t>(in + 16);
+        num_points = loadLE<uint64_t>(in + 24);
+        stamp = loadLE<double>(in + 32);
+        for (size_t i = 0; i < 7; ++i) pose[i] = loadLE<double>(in + 40 + 8 * i);
+        return magic == kRecordMagic;
+    }
+};
+
+/**
+ * @brief LZF compression (liblzf format, as expected by PCL's binary_compressed)
+ * @return Compressed size, or 0 if the output would not fit in capacity
+ */
+inline size_t lzfCompress(const uint8_t* in, size_t size, uint8_t* out, size_t capacity,
+                          std::vector<uint32_t>& table) {
+    constexpr size_t kHashBits = 14;
+    constexpr size_t kMaxLiteral = 32;
+    constexpr size_t kMaxOffset = 8192;
+    constexpr size_t kMaxMatch = 264;
+    table.assign(size_t(1) << kHashBits, 0);
+
+    uint8_t* op = out;
+    uint8_t* const outEnd = out + capacity;
+    auto emitLiterals = [&](const uint8_t* from, size_t n) {
+        while (n > 0) {
+            const size_t run = std::min(n, kMaxLiteral);
+            if (static_cast<size_t>(outEnd - op) < run + 1) return false;
+            *op++ = static_cast<uint8_t>(run - 1);
+            std::memcpy(op, from, run);
+            op += run;
+            from += run;
+            n -= run;
+        }
+        return true;
+    };
+
+    const uint8_t* ip = in;
+    const uint8_t* const end = in + size;
+    const uint8_t* literal = in;
+    while (end - ip >= 3) {
+        const uint32_t v = uint32_t(ip[0]) << 16 | uint32_t(ip[1]) << 8 | ip[2];
+        const uint32_t hash = (v * 2654435761u) >> (32 - kHashBits);
+        const uint32_t candidate = table[hash];
+        table[hash] = static_cast<uint32_t>(ip - in) + 1;
+
+        const uint8_t* ref = in + candidate - 1;
+        const size_t distance = static_cast<size_t>(ip - ref);
+        if (candidate == 0 || distance > kMaxOffset ||
+            ref[0] != ip[0] || ref[1] != ip[1] || ref[2] != ip[2]) {
+            ++ip;
+            continue;
+        }
+
+        const size_t limit = std::min<size_t>(end - ip, kMaxMatch);
+        size_t length = 3;
+        while (length < limit && ref[length] == ip[length]) ++length;
+
+        if (!emitLiterals(literal, static_cast<size_t>(ip - literal))) return 0;
+        if (outEnd - op < 3) return 0;
+        const size_t code = length - 2;
+        const size_t offset = distance - 1;
+        if (code < 7) {
+            *op++ = static_cast<uint8_t>((code << 5) | (offset >> 8));
+        } else {
+            *op++ = static_cast<uint8_t>((7 << 5) | (offset >> 8));
+            *op++ = static_cast<uint8_t>(code - 7);
+        }
+        *op++ = static_cast<uint8_t>(offset & 0xff);
+        ip += length;
+        literal = ip;
+    }
+    if (!emitLiterals(literal, static_cast<size_t>(end - literal))) return 0;
+    return static_cast<size_t>(op - out);
+}
+
+/**
+ * @brief Append-only file with a large page-aligned buffer
+ *
+ * claim()/commit() let callers serialize directly into the buffer; writes
+ * reach the kernel only when the buffer is full, on flush() or on close().
+ */
+class BufferedFileWriter {
+public:
+    static constexpr size_t kAlignment = 4096;
+
+    ~BufferedFileWriter() { close(); }
+
+    bool open(const std::string& path, size_t bufferBytes) {
+        close();
+        fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd_ < 0) return false;
+        const size_t capacity = std::max(kAlignment, (bufferBytes + kAlignment - 1) / kAlignment * kAlignment);
+        if (capacity != capacity_) {
+            buffer_.reset(static_cast<uint8_t*>(::operator new(capacity, std::align_val_t(kAlignment))));
+            capacity_ = capacity;
+        }
+        used_ = 0;
+        return true;
+    }
+
+    bool isOpen() const { return fd_ >= 0; }
+    size_t capacity() const { return capacity_; }
+
+    /// Space for n bytes (n <= capacity()), flushing first if needed
+    uint8_t* claim(size_t n) {
+        if (used_ + n > capacity_ && !flush()) return nullptr;
+        return buffer_.get() + used_;
+    }
+
+    void commit(size_t n) { used_ += n; }
+
+    bool append(const void* data, size_t n) {
+        const uint8_t* src = static_cast<const uint8_t*>(data);
+        if (n >= capacity_) {
+            return flush() && writeAll(src, n);   // large blocks skip the buffer
+        }
+        uint8_t* dst = claim(n);
+        if (!dst) return false;
+        std::memcpy(dst, src, n);
+        commit(n);
+        return true;
+    }
+
+    bool flush() {
+        if (used_ == 0) return true;
+        const bool ok = writeAll(buffer_.get(), used_);
+        used_ = 0;
+        return ok;
+    }
+
+    bool close() {
+        if (fd_ < 0) return true;
+        const bool ok = flush();
+        ::close(fd_);
+        fd_ = -1;
+        return ok;
+    }
+
+    /// Total over every file opened with this writer
+    uint64_t bytesWritten() const { return bytesWritten_; }
+
+private:
+    struct AlignedDelete {
+        void operator()(uint8_t* p) const { ::operator delete(p, std::align_val_t(kAlignment)); }
+    };
+
+    int fd_ = -1;
+    std::unique_ptr<uint8_t, AlignedDelete> buffer_;
+    size_t capacity_ = 0;
+    size_t used_ = 0;
+    uint64_t bytesWritten_ = 0;
+
+    bool writeAll(const uint8_t* data, size_t n) {
+        while (n > 0) {
+            const ssize_t written = ::write(fd_, data, n);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            data += written;
+            n -= static_cast<size_t>(written);
+            bytesWritten_ += static_cast<uint64_t>(written);
+        }
+        return true;
+    }
+};
+
+}  // namespace detail
+
+/**
+ * @brief Records decoded clouds to PCD files from a background thread
+ *
+ * record() only copies the cloud into a recycled buffer, so it is cheap
+ * enough for the network thread; call it from one thread at a time. When
+ * the writer falls behind by max_queued_frames, new frames are dropped and
+ * counted rather than stalling the caller.
+ *
+ * @code
+ * raisin_sdk::CloudRecorderConfig config;
+ * config.path = "/data/shift_42.rcr";
+ * config.format = raisin_sdk::RecordFormat::CONTAINER;
+ * raisin_sdk::CloudRecorder recorder;
+ * if (recorder.open(config)) {
+ *     recorder.record(view, raisin_sdk::CloudPose::fromYaw(state.x, state.y, state.z, state.yaw));
+ * }
+ * @endcode
+ */
+class CloudRecorder {
+public:
+    CloudRecorder() = default;
+    ~CloudRecorder() { close(); }
+
+    CloudRecorder(const CloudRecorder&) = delete;
+    CloudRecorder& operator=(const CloudRecorder&) = delete;
+
+    /**
+     * @brief Create the output and start the writer thread
+     * @return false if the directory or container file cannot be created
+     */
+    bool open(const CloudRecorderConfig& config) {
+        std::lock_guard<std::mutex> lifecycle(lifecycleMutex_);
+        closeLocked();
+        config_ = config;
+        config_.max_queued_frames = std::max<size_t>(config_.max_queued_frames, 1);
+
+        std::error_code ec;
+        if (config_.format == RecordFormat::CONTAINER) {
+            const std::filesystem::path parent = std::filesystem::path(config_.path).parent_path();
+            if (!parent.empty()) std::filesystem::create_directories(parent, ec);
+            if (!file_.open(config_.path, config_.write_buffer_bytes)) {
+                return fail("Cannot open " + config_.path + ": " + std::strerror(errno));
+            }
+        } else {
+            std::filesystem::create_directories(config_.path, ec);
+            if (ec) return fail("Cannot create " + config_.path + ": " + ec.message());
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stats_ = RecorderStats();
+            lastError_.clear();
+            sequence_ = 0;
+            stopping_ = false;
+            open_ = true;
+        }
+        writer_ = std::thread([this]() { writerLoop(); });
+        return true;
+    }
+
+    bool isOpen() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return open_;
+    }
+
+    /// Wall-clock seconds since epoch (default frame stamp)
+    static double wallTime() {
+        return std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    /// Queue a cloud decoded straight from the message
+    bool record(const PointCloudView& cloud, const CloudPose& pose, double stamp = wallTime()) {
+        Frame* frame = acquire();
+        if (!frame) return false;
+        decoder_.decode(cloud, frame->cloud);
+        return submit(frame, pose, stamp);
+    }
+
+    bool record(const PointCloudSoA& cloud, const CloudPose& pose, double stamp = wallTime()) {
+        Frame* frame = acquire();
+        if (!frame) return false;
+        frame->cloud = cloud;
+        return submit(frame, pose, stamp);
+    }
+
+    /**
+     * @brief Block until every queued frame has been handed to the kernel
+     * Also returns once the writer stopped on an error (the queue is then
+     * counted as dropped) or the recorder was closed.
+     */
+    void flush() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idleCv_.wait(lock, [this]() { return queue_.empty() && !busy_; });
+    }
+
+    /**
+     * @brief Write the remaining frames, then stop the thread and close the output
+     * record() fails from the moment close() starts; frames still queued are
+     * written first, or counted as dropped if the writer already failed.
+     */
+    void close() {
+        std::lock_guard<std::mutex> lifecycle(lifecycleMutex_);
+        closeLocked();
+    }
+
+    RecorderStats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        RecorderStats stats = stats_;
+        stats.bytes = bytes_;
+        return stats;
+    }
+
+    std::string lastError() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return lastError_;
+    }
+
+    const CloudRecorderConfig& config() const { return config_; }
+
+private:
+    struct Frame {
+        PointCloudSoA cloud;
+        CloudPose pose;
+        double stamp = 0.0;
+        uint64_t sequence = 0;
+    };
+
+    CloudRecorderConfig config_;
+    PointCloudDecoder decoder_;    ///< Caller thread only
+
+    std::mutex lifecycleMutex_;    ///< Serializes open() and close()
+    mutable std::mutex mutex_;
+    std::condition_variable readyCv_;
+    std::condition_variable idleCv_;
+    std::deque<std::unique_ptr<Frame>> queue_;
+    std::vector<std::unique_ptr<Frame>> free_;   ///< Written frames kept for their buffers
+    std::unique_ptr<Frame> pending_;             ///< Frame being filled by the caller
+    std::thread writer_;           ///< Started by open(), joined by close() (lifecycleMutex_)
+    bool open_ = false;            ///< Accepting frames; cleared as soon as close() begins
+    bool stopping_ = false;
+    bool busy_ = false;
+    uint64_t sequence_ = 0;
+    RecorderStats stats_;
+    uint64_t bytes_ = 0;
+    std::string lastError_;
+
+    // Writer thread only
+    detail::BufferedFileWriter file_;
+    std::string header_;
+    std::vector<uint8_t> plain_;
+    std::vector<uint8_t> packed_;
+    std::vector<uint32_t> lzfTable_;
+
+    void closeLocked() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!open_) return;
+            open_ = false;
+            stopping_ = true;
+        }
+        readyCv_.notify_all();
+        writer_.join();
+        if (!file_.close()) setError(std::string("Write failed: ") + std::strerror(errno));
+        {
+            // The writer drains the queue unless it stopped on an error, which
+            // already counted the rest; anything left here was never written
+            std::lock_guard<std::mutex> lock(mutex_);
+            stats_.dropped += queue_.size();
+            queue_.clear();
+            busy_ = false;
+        }
+        idleCv_.notify_all();
+    }
+
+    bool fail(const std::string& message) {
+        setError(message);
+        return false;
+    }
+
+    void setError(const std::string& message) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.failed = true;
+        lastError_ = message;
+    }
+
+    Frame* acquire() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!open_ || stats_.failed) return nullptr;
+        if (queue_.size() >= config_.max_queued_frames) {
+            ++stats_.dropped;
+            return nullptr;
+        }
+        if (!free_.empty()) {
+            pending_ = std::move(free_.back());
+            free_.pop_back();
+        } else {
+            pending_ = std::make_unique<Frame>();
+        }
+        return pending_.get();
+    }
+
+    bool submit(Frame* frame, const CloudPose& pose, double stamp) {
+        frame->pose = pose;
+        frame->stamp = stamp;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!open_ || stats_.failed) {
+                // close() began or the writer failed while the frame was filled
+                ++stats_.dropped;
+                free_.push_back(std::move(pending_));
+                return false;
+            }
+            frame->sequence = ++sequence_;
+            ++stats_.recorded;
+            queue_.push_back(std::move(pending_));
+        }
+        readyCv_.notify_one();
+        return true;
+    }
+
+    void writerLoop() {
+        for (;;) {
+            std::unique_ptr<Frame> frame;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                readyCv_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+                if (queue_.empty()) return;   // stopping and drained
+                frame = std::move(queue_.front());
+                queue_.pop_front();
+                busy_ = true;
+            }
+
+            const bool ok = writeFrame(*frame);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (ok) {
+                    ++stats_.written;
+                } else {
+                    stats_.failed = true;
+                    lastError_ = std::string("Write failed: ") + std::strerror(errno);
+                    stats_.dropped += queue_.size();
+                    queue_.clear();
+                }
+                bytes_ = file_.bytesWritten();
+                free_.push_back(std::move(frame));
+                busy_ = false;
+            }
+            idleCv_.notify_all();
+            if (!ok) return;
+        }
+    }
+
+    bool writeFrame(const Frame& frame) {
+        if (config_.format == RecordFormat::CONTAINER) {
+            const bool compressed = config_.compress_container;
+            buildPcd(frame, compressed);
+
+            detail::RecordHeader header;
+            header.compressed = compressed ? 1 : 0;
+            header.payload_size = header_.size() + (compressed ? 8 + packed_.size() : binarySize(frame.cloud));
+            header.sequence = frame.sequence;
+            header.num_points = frame.cloud.size();
+            header.stamp = frame.stamp;
+            const double pose[7] = {frame.pose.x, frame.pose.y, frame.pose.z,
+                                    frame.pose.qw, frame.pose.qx, frame.pose.qy, frame.pose.qz};
+            std::memcpy(header.pose, pose, sizeof(pose));
+            uint8_t record[detail::kRecordHeaderSize];
+            header.serialize(record);
+            return file_.append(record, sizeof(record)) && writePcdBody(frame, compressed) &&
+                   file_.flush();
+        }
+
+        char name[32];
+        std::snprintf(name, sizeof(name), "_%06llu.pcd", static_cast<unsigned long long>(frame.sequence));
+        const std::string path = (std::filesystem::path(config_.path) / (config_.prefix + name)).string();
+        if (!file_.open(path, config_.write_buffer_bytes)) return false;
+
+        const bool compressed = config_.format == RecordFormat::PCD_BINARY_COMPRESSED;
+        buildPcd(frame, compressed);
+        return writePcdBody(frame, compressed) && file_.close();
+    }
+
+    static size_t pointSize(const PointCloudSoA& cloud) {
+        return 12 + (cloud.has_intensity ? 4 : 0) + (cloud.has_ring ? 2 : 0) + (cloud.has_time ? 4 : 0);
+    }
+
+    static size_t binarySize(const PointCloudSoA& cloud) { return pointSize(cloud) * cloud.size(); }
+
+    /// PCD header into header_; for compressed frames also the LZF payload into packed_
+    void buildPcd(const Frame& frame, bool compressed) {
+        const PointCloudSoA& cloud = frame.cloud;
+        std::string fields = "x y z", sizes = "4 4 4", types = "F F F", counts = "1 1 1";
+        auto addField = [&](const char* name, const char* size, const char* type) {
+            fields += std::string(" ") + name;
+            sizes += std::string(" ") + size;
+            types += std::string(" ") + type;
+            counts += " 1";
+        };
+        if (cloud.has_intensity) addField("intensity", "4", "F");
+        if (cloud.has_ring) addField("ring", "2", "U");
+        if (cloud.has_time) addField("time", "4", "F");
+
+        char text[512];
+        std::snprintf(text, sizeof(text),
+                      "# .PCD v0.7 - Point Cloud Data file format\n"
+                      "# stamp %.6f sequence %llu\n"
+                      "VERSION 0.7\nFIELDS %s\nSIZE %s\nTYPE %s\nCOUNT %s\n"
+                      "WIDTH %zu\nHEIGHT 1\nVIEWPOINT %.9g %.9g %.9g %.9g %.9g %.9g %.9g\n"
+                      "POINTS %zu\nDATA %s\n",
+                      frame.stamp, static_cast<unsigned long long>(frame.sequence),
+                      fields.c_str(), sizes.c_str(), types.c_str(), counts.c_str(), cloud.size(),
+                      frame.pose.x, frame.pose.y, frame.pose.z,
+                      frame.pose.qw, frame.pose.qx, frame.pose.qy, frame.pose.qz,
+                      cloud.size(), compressed ? "binary_compressed" : "binary");
+        header_ = text;
+
+        if (!compressed) return;
+
+        // binary_compressed stores each field contiguously, i.e. the SoA channels
+        const size_t n = cloud.size();
+        plain_.resize(binarySize(cloud));
+        uint8_t* dst = plain_.data();
+        auto put = [&dst, n](const void* src, size_t elementSize) {
+            std::memcpy(dst, src, n * elementSize);
+            dst += n * elementSize;
+        };
+        put(cloud.x.data(), 4);
+        put(cloud.y.data(), 4);
+        put(cloud.z.data(), 4);
+        if (cloud.has_intensity) put(cloud.intensity.data(), 4);
+        if (cloud.has_ring) put(cloud.ring.data(), 2);
+        if (cloud.has_time) put(cloud.time.data(), 4);
+
+        packed_.resize(plain_.size() + plain_.size() / 32 + 16);   // LZF worst case
+        packed_.resize(detail::lzfCompress(plain_.data(), plain_.size(), packed_.data(), packed_.size(),
+                                           lzfTable_));
+    }
+
+    bool writePcdBody(const Frame& frame, bool compressed) {
+        if (!file_.append(header_.data(), header_.size())) return false;
+
+        if (compressed) {
+            const uint32_t sizes[2] = {static_cast<uint32_t>(packed_.size()), static_cast<uint32_t>(plain_.size())};
+            return file_.append(sizes, sizeof(sizes)) && file_.append(packed_.data(), packed_.size());
+        }
+
+        // Interleave straight into the write buffer, one buffer-sized batch at a time
+        const PointCloudSoA& cloud = frame.cloud;
+        const size_t step = pointSize(cloud);
+        const size_t batch = std::max<size_t>(1, file_.capacity() / step);
+        for (size_t begin = 0; begin < cloud.size(); begin += batch) {
+            const size_t count = std::min(batch, cloud.size() - begin);
+            uint8_t* dst = file_.claim(count * step);
+            if (!dst) return false;
+            for (size_t i = begin; i < begin + count; ++i) {
+                std::memcpy(dst, &cloud.x[i], 4);
+                std::memcpy(dst + 4, &cloud.y[i], 4);
+                std::memcpy(dst + 8, &cloud.z[i], 4);
+                size_t off = 12;
+                if (cloud.has_intensity) { std::memcpy(dst + off, &cloud.intensity[i], 4); off += 4; }
+                if (cloud.has_ring) { std::memcpy(dst + off, &cloud.ring[i], 2); off += 2; }
+                if (cloud.has_time) { std::memcpy(dst + off, &cloud.time[i], 4); off += 4; }
+                dst += step;
+            }
+            file_.commit(count * step);
+        }
+        return true;
+    }
+};
+
+}  // namespace raisin_sdk
@@ -0,0 +1,304 @@
+/**
+ * @file cloud_stats.hpp
+ * @brief Per-frame point cloud statistics for sensor health monitoring
+ *
+ * CloudStatsCollector accumulates a bounding box, point and NaN counts, a
+ * range histogram, per-sector density and a z histogram (for percentiles)
+ * over points as they are decoded. PointCloudDecoder feeds it from the
+ * blocks it has just written, so the statistics cost no extra pass over
+ * the message.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "raisin_sdk/point_cloud.hpp"
+
+namespace raisin_sdk {
+
+/**
+ * @brief Statistics settings
+ *
+ * Ranges, sectors and heights are relative to the sensor origin given to
+ * CloudStatsCollector::begin() (the odometry pose for /cloud_registered).
+ */
+struct CloudStatsConfig {
+    bool enabled = false;       ///< Compute statistics (used by PointCloudOptions)
+    uint32_t range_bins = 32;   ///< Range histogram bins up to max_range
+    float max_range = 64.0f;    ///< Farther points land in the last bin
+    uint32_t sectors = 36;      ///< Azimuth sectors, counter-clockwise from the sensor heading
+    float z_min = -5.0f;        ///< Lowest z of the percentile histogram (relative to the origin)
+    float z_max = 15.0f;        ///< Highest z; points outside are clamped to the end bins
+    float z_resolution = 0.05f; ///< z histogram bin, i.e. percentile resolution (m)
+};
+
+/**
+ * @brief Statistics of one frame
+ */
+struct CloudStats {
+    size_t count = 0;        ///< Points in the message (before any filter)
+    size_t nan_count = 0;    ///< Points with a non-finite coordinate
+    float min_x = 0.0f, min_y = 0.0f, min_z = 0.0f;   ///< Bounding box of the finite points
+    float max_x = 0.0f, max_y = 0.0f, max_z = 0.0f;   ///< (all zero when there are none)
+    float range_bin_width = 0.0f;
+    std::vector<uint32_t> range_histogram;   ///< Finite points per range bin
+    std::vector<uint32_t> sector_counts;     ///< Finite points per azimuth sector
+    float z_p05 = 0.0f;      ///< 5th percentile of z relative to the origin
+    float z_p50 = 0.0f;      ///< Median z
+    float z_p95 = 0.0f;      ///< 95th percentile z
+
+    size_t finiteCount() const { return count - nan_count; }
+
+    /// Share of the finite points that fell into a sector (1/sectors when uniform)
+    float sectorDensity(size_t sector) const {
+        const size_t finite = finiteCount();
+        return finite ? static_cast<float>(sector_counts[sector]) / finite : 0.0f;
+    }
+};
+
+namespace detail {
+
+/// Branch-free atan2 approximation in [0, 2*pi), max error about 0.01 rad
+inline float fastAzimuth(float y, float x) {
+    constexpr float kPi = 3.14159265358979f;
+    const float ax = std::fabs(x), ay = std::fabs(y);
+    const float mn = std::min(ax, ay);
+    const float a = mn / (ax + ay - mn + 1e-30f);   // min / max
+    const float s = a * a;
+    float r = ((-0.0464964749f * s + 0.15931422f) * s - 0.327622764f) * s * a + a;
+    // Quadrant fix-ups as arithmetic selects: the signs are random, so branches would mispredict
+    const float steep = static_cast<float>(ay > ax);
+    const float left = static_cast<float>(x < 0.0f);
+    const float below = static_cast<float>(y < 0.0f);
+    r += steep * (0.5f * kPi - 2.0f * r);
+    r += left * (kPi - 2.0f * r);
+    r += below * (2.0f * kPi - 2.0f * r);
+    return r;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Accumulates CloudStats over points fed in any order
+ *
+ * Partial collectors (one per decode chunk) start as copies of the
+ * begun collector and are merged back.
+ *
+ * @code
+ * raisin_sdk::CloudStatsCollector collector(config);
+ * collector.begin(state.x, state.y, state.z, state.yaw);
+ * decoder.decode(view, cloud, nullptr, &collector);
+ * raisin_sdk::CloudStats stats;
+ * collector.finish(stats);
+ * @endcode
+ */
+class CloudStatsCollector {
+public:
+    explicit CloudStatsCollector(const CloudStatsConfig& config = {}) { setConfig(config); }
+
+    const CloudStatsConfig& config() const { return config_; }
+
+    void setConfig(const CloudStatsConfig& config) {
+        config_ = config;
+        config_.range_bins = std::max<uint32_t>(config_.range_bins, 1);
+        config_.sectors = std::max<uint32_t>(config_.sectors, 1);
+        config_.max_range = std::max(config_.max_range, 1e-3f);
+        config_.z_resolution = std::max(config_.z_resolution, 1e-3f);
+        config_.z_max = std::max(config_.z_max, config_.z_min + config_.z_resolution);
+        zBins_ = static_cast<uint32_t>(std::ceil((config_.z_max - config_.z_min) / config_.z_resolution));
+        begin(0.0, 0.0, 0.0, 0.0);
+    }
+
+    /// Clear all counts and set the sensor origin for the next frame
+    void begin(double ox, double oy, double oz, double yaw) {
+        ox_ = static_cast<float>(ox);
+        oy_ = static_cast<float>(oy);
+        oz_ = static_cast<float>(oz);
+        cos_ = static_cast<float>(std::cos(yaw));
+        sin_ = static_cast<float>(std::sin(yaw));
+        clear();
+    }
+
+    /// Reset counts, keeping config and origin
+    void clear() {
+        count_ = 0;
+        min_[0] = min_[1] = min_[2] = std::numeric_limits<float>::infinity();
+        max_[0] = max_[1] = max_[2] = -std::numeric_limits<float>::infinity();
+        range_.assign(config_.range_bins + 1, 0);   // + spare slot for non-finite points
+        sector_.assign(config_.sectors + 1, 0);
+        z_.assign(zBins_ + 1, 0);
+    }
+
+    void add(float x, float y, float z) { add(&x, &y, &z, 1); }
+
+    /**
+     * @brief Add n points given as separate channels
+     * Bins are computed for a batch in a branch-free loop the compiler can
+     * vectorize; non-finite points go to a spare slot at the end of each
+     * histogram. Only the histogram increments are scalar.
+     */
+    void add(const float* x, const float* y, const float* z, size_t n) {
+        const float rangeScale = config_.range_bins / config_.max_range;
+        const float sectorScale = config_.sectors / 6.283185307179586f;
+        const float zScale = 1.0f / config_.z_resolution;
+        const float rangeTop = static_cast<float>(config_.range_bins - 1);
+        const float sectorTop = static_cast<float>(config_.sectors - 1);
+        const float zTop = static_cast<float>(zBins_ - 1);
+        const float inf = std::numeric_limits<float>::infinity();
+        const float ox = ox_, oy = oy_, oz = oz_, c = cos_, s = sin_, zMin = config_.z_min;
+        const uint32_t rangeNan = config_.range_bins, sectorNan = config_.sectors, zNan = zBins_;
+        float minX = min_[0], minY = min_[1], minZ = min_[2];
+        float maxX = max_[0], maxY = max_[1], maxZ = max_[2];
+        uint32_t rangeBin[kBatch], sectorBin[kBatch], zBin[kBatch];
+
+        for (size_t begin = 0; begin < n; begin += kBatch) {
+            const size_t count = std::min(kBatch, n - begin);
+            const float* bx = x + begin;
+            const float* by = y + begin;
+            const float* bz = z + begin;
+            for (size_t i = 0; i < count; ++i) {
+                // x - x is 0 for finite values, NaN for NaN/inf
+                const bool finite = (bx[i] - bx[i]) + (by[i] - by[i]) + (bz[i] - bz[i]) == 0.0f;
+                const float px = finite ? bx[i] : 0.0f;
+                const float py = finite ? by[i] : 0.0f;
+                const float pz = finite ? bz[i] : 0.0f;
+                minX = std::min(minX, finite ? px : inf);
+                minY = std::min(minY, finite ? py : inf);
+                minZ = std::min(minZ, finite ? pz : inf);
+                maxX = std::max(maxX, finite ? px : -inf);
+                maxY = std::max(maxY, finite ? py : -inf);
+                maxZ = std::max(maxZ, finite ? pz : -inf);
+
+                const float wx = px - ox, wy = py - oy, dz = pz - oz;
+                const float dx = c * wx + s * wy;    // into the sensor heading
+                const float dy = -s * wx + c * wy;
+                const float rangeSq = dx * dx + dy * dy + dz * dz;
+                const float rb = std::min(std::sqrt(rangeSq) * rangeScale, rangeTop);
+                const float sb = std::min(detail::fastAzimuth(dy, dx) * sectorScale, sectorTop);
+                const float zb = std::min(std::max((dz - zMin) * zScale, 0.0f), zTop);
+                rangeBin[i] = finite ? static_cast<uint32_t>(static_cast<int32_t>(rb)) : rangeNan;
+                sectorBin[i] = finite ? static_cast<uint32_t>(static_cast<int32_t>(sb)) : sectorNan;
+                zBin[i] = finite ? static_cast<uint32_t>(static_cast<int32_t>(zb)) : zNan;
+            }
+            for (size_t i = 0; i < count; ++i) {
+                ++range_[rangeBin[i]];
+                ++sector_[sectorBin[i]];
+                ++z_[zBin[i]];
+            }
+        }
+        min_[0] = minX;
+        min_[1] = minY;
+        min_[2] = minZ;
+        max_[0] = maxX;
+        max_[1] = maxY;
+        max_[2] = maxZ;
+        count_ += n;
+    }
+
+    /// Add n interleaved points, split into channels one batch at a time
+    void add(const Point3D* points, size_t n) {
+        float x[kBatch], y[kBatch], z[kBatch];
+        for (size_t begin = 0; begin < n; begin += kBatch) {
+            const size_t count = std::min(kBatch, n - begin);
+            for (size_t i = 0; i < count; ++i) {
+                x[i] = points[begin + i].x;
+                y[i] = points[begin + i].y;
+                z[i] = points[begin + i].z;
+            }
+            add(x, y, z, count);
+        }
+    }
+
+    /// Add every point of a message (standalone pass)
+    void add(const PointCloudView& view) {
+        if (!view.hasXYZ()) return;
+        float x[kBatch], y[kBatch], z[kBatch];
+        for (size_t begin = 0; begin < view.size(); begin += kBatch) {
+            const size_t count = std::min(kBatch, view.size() - begin);
+            for (size_t i = 0; i < count; ++i) {
+                const Point3D p = view.point(begin + i);
+                x[i] = p.x;
+                y[i] = p.y;
+                z[i] = p.z;
+            }
+            add(x, y, z, count);
+        }
+    }
+
+    /// Fold in a partial collector with the same config
+    void merge(const CloudStatsCollector& other) {
+        count_ += other.count_;
+        for (int k = 0; k < 3; ++k) {
+            min_[k] = std::min(min_[k], other.min_[k]);
+            max_[k] = std::max(max_[k], other.max_[k]);
+        }
+        for (size_t i = 0; i < range_.size(); ++i) range_[i] += other.range_[i];
+        for (size_t i = 0; i < sector_.size(); ++i) sector_[i] += other.sector_[i];
+        for (size_t i = 0; i < z_.size(); ++i) z_[i] += other.z_[i];
+    }
+
+    size_t count() const { return count_; }
+
+    /// Non-finite points so far
+    size_t nanCount() const { return range_.back(); }
+
+    /// Write the frame's statistics (reuses out's vectors)
+    void finish(CloudStats& out) const {
+        const size_t nan = nanCount();
+        out.count = count_;
+        out.nan_count = nan;
+        const bool any = count_ > nan;
+        out.min_x = any ? min_[0] : 0.0f;
+        out.min_y = any ? min_[1] : 0.0f;
+        out.min_z = any ? min_[2] : 0.0f;
+        out.max_x = any ? max_[0] : 0.0f;
+        out.max_y = any ? max_[1] : 0.0f;
+        out.max_z = any ? max_[2] : 0.0f;
+        out.range_bin_width = config_.max_range / config_.range_bins;
+        out.range_histogram.assign(range_.begin(), range_.end() - 1);
+        out.sector_counts.assign(sector_.begin(), sector_.end() - 1);
+        out.z_p05 = zPercentile(0.05);
+        out.z_p50 = zPercentile(0.50);
+        out.z_p95 = zPercentile(0.95);
+    }
+
+    /// z (relative to the origin) below which a fraction q of the finite points lie; 0 if none
+    float zPercentile(double q) const {
+        const size_t finite = count_ - nanCount();
+        if (finite == 0) return 0.0f;
+        const double target = std::clamp(q, 0.0, 1.0) * finite;
+        size_t cumulative = 0;
+        for (uint32_t b = 0; b < zBins_; ++b) {
+            const size_t next = cumulative + z_[b];
+            if (next >= target && z_[b] > 0) {
+                const double within = (target - cumulative) / z_[b];   // interpolate inside the bin
+                return config_.z_min + static_cast<float>((b + within) * config_.z_resolution);
+            }
+            cumulative = next;
+        }
+        return config_.z_max;
+    }
+
+private:
+    static constexpr size_t kBatch = 256;   ///< Points binned per branch-free pass
+
+    CloudStatsConfig config_;
+    uint32_t zBins_ = 1;
+    float ox_ = 0.0f, oy_ = 0.0f, oz_ = 0.0f;
+    float cos_ = 1.0f, sin_ = 0.0f;
+
+    size_t count_ = 0;
+    float min_[3];
+    float max_[3];
+    std::vector<uint32_t> range_;    ///< Last slot counts non-finite points
+    std::vector<uint32_t> sector_;
+    std::vector<uint32_t> z_;
+};
+
+}  // namespace raisin_sdk
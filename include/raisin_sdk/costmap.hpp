@@ -0,0 +1,453 @@
+/**
+ * @file costmap.hpp
+ * @brief Rolling 2D costmap updated incrementally from clouds and odometry
+ *
+ * RollingCostmap keeps a robot-centred occupancy grid in a circular buffer.
+ * Each scan is ray-cast from the robot in parallel: cells a ray passes
+ * through become more likely free, cells where a point inside the obstacle
+ * height band lands become more likely occupied. Only cells touched by
+ * the scan are updated, and inflation is recomputed only around cells
+ * whose occupied/free state flipped. Finished grids are published as
+ * immutable snapshots for dashboards and safety layers on other threads.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "raisin_sdk/parallel.hpp"
+#include "raisin_sdk/point_cloud.hpp"
+#include "raisin_sdk/snapshot.hpp"
+
+namespace raisin_sdk {
+
+/**
+ * @brief Cell cost values (ROS costmap_2d convention)
+ */
+enum CostValue : uint8_t {
+    COST_FREE = 0,          ///< Observed free, no obstacle nearby
+    COST_INSCRIBED = 253,   ///< Within inscribed_radius of an obstacle
+    COST_LETHAL = 254,      ///< Obstacle
+    COST_UNKNOWN = 255      ///< Never observed
+};
+
+/**
+ * @brief Costmap settings
+ */
+struct CostmapConfig {
+    float resolution = 0.05f;         ///< Cell size in metres
+    uint32_t width = 200;             ///< Cells along X (10 m at 5 cm)
+    uint32_t height = 200;            ///< Cells along Y
+    float min_obstacle_height = 0.1f; ///< Obstacle band, relative to robot z
+    float max_obstacle_height = 1.5f; ///< Points above the band are ignored
+    float max_range = 8.0f;           ///< Rays are cut at this range; farther points only clear
+    float inscribed_radius = 0.3f;    ///< Cells this close to an obstacle get COST_INSCRIBED
+    float inflation_radius = 0.6f;    ///< Cost decays to zero at this distance
+    float cost_scaling = 5.0f;        ///< Exponential decay rate beyond inscribed_radius
+    float hit_log_odds = 0.85f;       ///< Added when a point lands in a cell
+    float miss_log_odds = -0.4f;      ///< Added when a ray passes through a cell
+    float occupied_log_odds = 0.6f;   ///< Cells at or above this are obstacles
+    float clamp_log_odds = 3.5f;      ///< Log-odds are clamped to +-this
+    size_t parallel_threshold = 20000;///< Scans smaller than this are ray-cast single-threaded
+};
+
+/**
+ * @brief Immutable costmap snapshot
+ *
+ * Row-major, row 0 at origin_y; cell (ix, iy) covers
+ * [origin_x + ix * resolution, origin_x + (ix + 1) * resolution).
+ */
+struct CostmapGrid {
+    float resolution = 0.05f;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    double origin_x = 0.0;     ///< Map-frame X of the lower-left corner
+    double origin_y = 0.0;     ///< Map-frame Y of the lower-left corner
+    uint64_t sequence = 0;     ///< Incremented on every update
+    std::vector<uint8_t> cost; ///< width * height CostValue-scaled cells
+
+    uint8_t at(uint32_t ix, uint32_t iy) const { return cost[static_cast<size_t>(iy) * width + ix]; }
+
+    /// Cost at a map-frame position (COST_UNKNOWN outside the grid)
+    uint8_t costAt(double x, double y) const {
+        const double fx = std::floor((x - origin_x) / resolution);
+        const double fy = std::floor((y - origin_y) / resolution);
+        if (fx < 0.0 || fy < 0.0 || fx >= width || fy >= height) return COST_UNKNOWN;
+        return at(static_cast<uint32_t>(fx), static_cast<uint32_t>(fy));
+    }
+};
+
+/**
+ * @brief Robot-centred rolling costmap
+ *
+ * update() is meant to be called from one thread (RaisinClient calls it
+ * from the cloud subscription); snapshot() and costAt() may be called from
+ * any thread. The window re-centres on the robot once it has drifted a
+ * quarter of the window from the centre; cells scrolled in are unknown.
+ *
+ * @code
+ * raisin_sdk::RollingCostmap costmap;
+ * costmap.update(cloudView, state.x, state.y, state.z);
+ * auto grid = costmap.snapshot();
+ * if (grid && grid->costAt(x, y) >= raisin_sdk::COST_INSCRIBED) { ... }
+ * @endcode
+ */
+class RollingCostmap {
+public:
+    explicit RollingCostmap(const CostmapConfig& config = {}, std::shared_ptr<WorkerPool> pool = nullptr)
+        : config_(config), pool_(std::move(pool)) {
+        const size_t cells = static_cast<size_t>(config_.width) * config_.height;
+        logOdds_.assign(cells, 0.0f);
+        known_.assign(cells, 0);
+        inflated_.assign(cells, 0);
+        touchStamp_.assign(cells, 0);
+        hitStamp_.assign(cells, 0);
+        buildKernel();
+    }
+
+    const CostmapConfig& config() const { return config_; }
+
+    /// Integrate a scan taken from sensor origin (ox, oy, oz), all in map frame
+    void update(const PointCloudView& cloud, double ox, double oy, double oz) {
+        if (!cloud.hasXYZ()) return;
+        integrate(cloud.size(), [&cloud](size_t i) { return cloud.point(i); }, ox, oy, oz);
+    }
+
+    void update(const std::vector<Point3D>& points, double ox, double oy, double oz) {
+        integrate(points.size(), [&points](size_t i) { return points[i]; }, ox, oy, oz);
+    }
+
+    /// Latest published grid (nullptr before the first update)
+    std::shared_ptr<const CostmapGrid> snapshot() const { return grid_.load(); }
+
+    /// Cost at a map-frame position in the latest grid
+    uint8_t costAt(double x, double y) const {
+        auto grid = snapshot();
+        return grid ? grid->costAt(x, y) : static_cast<uint8_t>(COST_UNKNOWN);
+    }
+
+    /// Cells updated by the last scan
+    size_t lastTouchedCells() const { return lastTouched_; }
+
+private:
+    struct KernelCell {
+        int32_t dx;
+        int32_t dy;
+        uint8_t cost;
+    };
+
+    CostmapConfig config_;
+    std::shared_ptr<WorkerPool> pool_;   ///< WorkerPool::shared() if not given, on first large scan
+
+    // Circular storage; global cell (gx, gy) lives at (gx mod width, gy mod height)
+    std::vector<float> logOdds_;
+    std::vector<uint8_t> known_;
+    std::vector<uint8_t> inflated_;      ///< Inflation cost from nearby obstacles
+    std::vector<uint32_t> touchStamp_;   ///< Scan that last touched the cell (atomic during ray-casting)
+    std::vector<uint32_t> hitStamp_;     ///< Scan that last put an endpoint in the cell
+    std::vector<std::vector<uint32_t>> touched_;   ///< Per-task lists of cells first touched this scan
+    std::vector<KernelCell> kernel_;
+    int64_t originX_ = 0;                ///< Global index of the window's lower-left cell
+    int64_t originY_ = 0;
+    bool initialized_ = false;
+    uint32_t scan_ = 0;
+    size_t lastTouched_ = 0;
+    uint64_t sequence_ = 0;
+
+    std::shared_ptr<SnapshotPool<CostmapGrid>> gridPool_ = SnapshotPool<CostmapGrid>::create(2);
+    AtomicSnapshot<CostmapGrid> grid_;
+
+    int64_t cellOf(double v) const { return static_cast<int64_t>(std::floor(v / config_.resolution)); }
+
+    size_t storageIndex(int64_t gx, int64_t gy) const {
+        const int64_t w = config_.width;
+        const int64_t h = config_.height;
+        const int64_t sx = ((gx % w) + w) % w;
+        const int64_t sy = ((gy % h) + h) % h;
+        return static_cast<size_t>(sy * w + sx);
+    }
+
+    bool inWindow(int64_t gx, int64_t gy) const {
+        return gx >= originX_ && gy >= originY_ &&
+               gx < originX_ + static_cast<int64_t>(config_.width) &&
+               gy < originY_ + static_cast<int64_t>(config_.height);
+    }
+
+    bool lethal(size_t s) const { return known_[s] && logOdds_[s] >= config_.occupied_log_odds; }
+
+    void buildKernel() {
+        kernel_.clear();
+        const int32_t r = static_cast<int32_t>(std::ceil(config_.inflation_radius / config_.resolution));
+        for (int32_t dy = -r; dy <= r; ++dy) {
+            for (int32_t dx = -r; dx <= r; ++dx) {
+                const float d = std::sqrt(static_cast<float>(dx * dx + dy * dy)) * config_.resolution;
+                if (d > config_.inflation_radius) continue;
+                uint8_t cost;
+                if (d <= config_.inscribed_radius) {
+                    cost = COST_INSCRIBED;
+                } else {
+                    const float c = (COST_INSCRIBED - 1) *
+                                    std::exp(-config_.cost_scaling * (d - config_.inscribed_radius));
+                    cost = static_cast<uint8_t>(std::max(1.0f, c));
+                }
+                kernel_.push_back({dx, dy, cost});
+            }
+        }
+    }
+
+    /// Forget everything observed in a storage cell
+    void clearCell(size_t s) {
+        logOdds_[s] = 0.0f;
+        known_[s] = 0;
+        inflated_[s] = 0;
+    }
+
+    /// Re-centre the window on the robot; returns true if it moved
+    bool recentre(int64_t robotX, int64_t robotY) {
+        const int64_t w = config_.width;
+        const int64_t h = config_.height;
+        const int64_t wantX = robotX - w / 2;
+        const int64_t wantY = robotY - h / 2;
+        if (initialized_ && std::llabs(wantX - originX_) <= w / 4 && std::llabs(wantY - originY_) <= h / 4) {
+            return false;
+        }
+        if (!initialized_ || std::llabs(wantX - originX_) >= w || std::llabs(wantY - originY_) >= h) {
+            std::fill(logOdds_.begin(), logOdds_.end(), 0.0f);
+            std::fill(known_.begin(), known_.end(), 0);
+            std::fill(inflated_.begin(), inflated_.end(), 0);
+        } else {
+            // Storage of columns/rows leaving the window is reused for the ones
+            // entering it (same index modulo the window size)
+            for (int64_t gx = std::min(originX_, wantX); gx < std::max(originX_, wantX); ++gx) {
+                for (int64_t gy = 0; gy < h; ++gy) clearCell(storageIndex(gx, gy));
+            }
+            for (int64_t gy = std::min(originY_, wantY); gy < std::max(originY_, wantY); ++gy) {
+                for (int64_t gx = 0; gx < w; ++gx) clearCell(storageIndex(gx, gy));
+            }
+        }
+        originX_ = wantX;
+        originY_ = wantY;
+        initialized_ = true;
+        return true;
+    }
+
+    template <typename PointFn>
+    void integrate(size_t n, const PointFn& pointAt, double ox, double oy, double oz) {
+        const int64_t robotX = cellOf(ox);
+        const int64_t robotY = cellOf(oy);
+        const bool moved = recentre(robotX, robotY);
+
+        if (++scan_ == 0) {   // stamp wrap-around: forget old stamps
+            std::fill(touchStamp_.begin(), touchStamp_.end(), 0);
+            std::fill(hitStamp_.begin(), hitStamp_.end(), 0);
+            scan_ = 1;
+        }
+
+        // Phase 1: ray-cast every point, recording each touched cell once
+        if (n >= config_.parallel_threshold && !pool_) pool_ = WorkerPool::shared();
+        const size_t numTasks = n >= config_.parallel_threshold
+            ? std::max<size_t>(1, std::min(pool_->concurrency() * 4, n / 4096)) : 1;
+        if (touched_.size() < numTasks) touched_.resize(numTasks);
+        const size_t chunk = (n + numTasks - 1) / numTasks;
+        auto castRange = [&](size_t task) {
+            std::vector<uint32_t>& touched = touched_[task];
+            touched.clear();
+            const size_t end = std::min(n, (task + 1) * chunk);
+            for (size_t i = task * chunk; i < end; ++i) {
+                castRay(pointAt(i), ox, oy, oz, robotX, robotY, touched);
+            }
+        };
+        if (numTasks > 1) {
+            pool_->parallelFor(numTasks, castRange);
+        } else {
+            castRange(0);
+        }
+
+        // Phase 2: update log-odds of touched cells, collecting obstacle flips
+        int64_t dirtyMinX = std::numeric_limits<int64_t>::max();
+        int64_t dirtyMinY = std::numeric_limits<int64_t>::max();
+        int64_t dirtyMaxX = std::numeric_limits<int64_t>::min();
+        int64_t dirtyMaxY = std::numeric_limits<int64_t>::min();
+        size_t touchedCount = 0;
+        for (size_t t = 0; t < numTasks; ++t) {
+            touchedCount += touched_[t].size();
+            for (uint32_t s : touched_[t]) {
+                const bool wasLethal = lethal(s);
+                const float delta = hitStamp_[s] == scan_ ? config_.hit_log_odds : config_.miss_log_odds;
+                logOdds_[s] = std::clamp(logOdds_[s] + delta, -config_.clamp_log_odds, config_.clamp_log_odds);
+                known_[s] = 1;
+                if (lethal(s) != wasLethal) {
+                    const int64_t gx = globalX(s % config_.width);
+                    const int64_t gy = globalY(s / config_.width);
+                    dirtyMinX = std::min(dirtyMinX, gx);
+                    dirtyMaxX = std::max(dirtyMaxX, gx);
+                    dirtyMinY = std::min(dirtyMinY, gy);
+                    dirtyMaxY = std::max(dirtyMaxY, gy);
+                }
+            }
+        }
+        lastTouched_ = touchedCount;
+
+        // Phase 3: re-inflate only around flipped cells (everything after a shift)
+        if (moved) {
+            reinflate(originX_, originY_, originX_ + config_.width - 1, originY_ + config_.height - 1);
+        } else if (dirtyMinX <= dirtyMaxX) {
+            const int64_t r = static_cast<int64_t>(std::ceil(config_.inflation_radius / config_.resolution));
+            reinflate(dirtyMinX - r, dirtyMinY - r, dirtyMaxX + r, dirtyMaxY + r);
+        }
+
+        publish();
+    }
+
+    /// Global X of storage column sx within the current window
+    int64_t globalX(size_t sx) const {
+        const int64_t w = config_.width;
+        const int64_t base = ((originX_ % w) + w) % w;
+        return originX_ + ((static_cast<int64_t>(sx) - base + w) % w);
+    }
+
+    int64_t globalY(size_t sy) const {
+        const int64_t h = config_.height;
+        const int64_t base = ((originY_ % h) + h) % h;
+        return originY_ + ((static_cast<int64_t>(sy) - base + h) % h);
+    }
+
+    /// Claim a cell for this scan; the first claimant records it as touched
+    void touch(size_t s, std::vector<uint32_t>& touched) {
+        std::atomic_ref<uint32_t> stamp(touchStamp_[s]);
+        // Plain load first: most cells near the robot are crossed by many rays
+        if (stamp.load(std::memory_order_relaxed) != scan_ &&
+            stamp.exchange(scan_, std::memory_order_relaxed) != scan_) {
+            touched.push_back(static_cast<uint32_t>(s));
+        }
+    }
+
+    void castRay(const Point3D& p, double ox, double oy, double oz, int64_t x0, int64_t y0,
+                 std::vector<uint32_t>& touched) {
+        if (!std::isfinite(p.x) || !std::isfinite(p.y) || !std::isfinite(p.z)) return;
+        const double relZ = p.z - oz;
+        if (relZ > config_.max_obstacle_height) return;
+
+        double ex = p.x;
+        double ey = p.y;
+        const double dx = ex - ox;
+        const double dy = ey - oy;
+        const double range = std::sqrt(dx * dx + dy * dy);
+        bool mark = relZ >= config_.min_obstacle_height;
+        if (range > config_.max_range) {
+            // Clear up to max_range only
+            const double scale = config_.max_range / range;
+            ex = ox + dx * scale;
+            ey = oy + dy * scale;
+            mark = false;
+        }
+
+        // Bresenham from the robot cell to the end cell, stepping the storage
+        // column/row along with the global cell to avoid a modulo per cell
+        const int64_t x1 = cellOf(ex);
+        const int64_t y1 = cellOf(ey);
+        const int64_t w = config_.width;
+        const int64_t h = config_.height;
+        const int64_t sx = x1 > x0 ? 1 : -1;
+        const int64_t sy = y1 > y0 ? 1 : -1;
+        const int64_t adx = std::llabs(x1 - x0);
+        const int64_t ady = -std::llabs(y1 - y0);
+        int64_t err = adx + ady;
+        int64_t x = x0;
+        int64_t y = y0;
+        int64_t col = ((x0 % w) + w) % w;
+        int64_t row = ((y0 % h) + h) % h;
+        for (;;) {
+            if (!inWindow(x, y)) return;   // the robot is inside, so the rest is outside too
+            const size_t cell = static_cast<size_t>(row * w + col);
+            touch(cell, touched);
+            if (x == x1 && y == y1) {
+                if (mark) std::atomic_ref<uint32_t>(hitStamp_[cell]).store(scan_, std::memory_order_relaxed);
+                return;
+            }
+            const int64_t e2 = 2 * err;
+            if (e2 >= ady) {
+                err += ady;
+                x += sx;
+                col += sx;
+                if (col == w) col = 0; else if (col < 0) col = w - 1;
+            }
+            if (e2 <= adx) {
+                err += adx;
+                y += sy;
+                row += sy;
+                if (row == h) row = 0; else if (row < 0) row = h - 1;
+            }
+        }
+    }
+
+    /// Recompute inflation inside the global cell box (clipped to the window)
+    void reinflate(int64_t minX, int64_t minY, int64_t maxX, int64_t maxY) {
+        minX = std::max(minX, originX_);
+        minY = std::max(minY, originY_);
+        maxX = std::min(maxX, originX_ + static_cast<int64_t>(config_.width) - 1);
+        maxY = std::min(maxY, originY_ + static_cast<int64_t>(config_.height) - 1);
+        if (minX > maxX || minY > maxY) return;
+
+        for (int64_t gy = minY; gy <= maxY; ++gy) {
+            for (int64_t gx = minX; gx <= maxX; ++gx) inflated_[storageIndex(gx, gy)] = 0;
+        }
+
+        // Obstacles up to one radius outside the box still inflate into it
+        const int64_t r = static_cast<int64_t>(std::ceil(config_.inflation_radius / config_.resolution));
+        const int64_t srcMinX = std::max(minX - r, originX_);
+        const int64_t srcMinY = std::max(minY - r, originY_);
+        const int64_t srcMaxX = std::min(maxX + r, originX_ + static_cast<int64_t>(config_.width) - 1);
+        const int64_t srcMaxY = std::min(maxY + r, originY_ + static_cast<int64_t>(config_.height) - 1);
+        for (int64_t gy = srcMinY; gy <= srcMaxY; ++gy) {
+            for (int64_t gx = srcMinX; gx <= srcMaxX; ++gx) {
+                if (!lethal(storageIndex(gx, gy))) continue;
+                for (const KernelCell& k : kernel_) {
+                    const int64_t cx = gx + k.dx;
+                    const int64_t cy = gy + k.dy;
+                    if (cx < minX || cx > maxX || cy < minY || cy > maxY) continue;
+                    uint8_t& cell = inflated_[storageIndex(cx, cy)];
+                    cell = std::max(cell, k.cost);
+                }
+            }
+        }
+    }
+
+    void publish() {
+        std::unique_ptr<CostmapGrid> grid = gridPool_->acquire();
+        grid->resolution = config_.resolution;
+        grid->width = config_.width;
+        grid->height = config_.height;
+        grid->origin_x = static_cast<double>(originX_) * config_.resolution;
+        grid->origin_y = static_cast<double>(originY_) * config_.resolution;
+        grid->sequence = ++sequence_;
+        grid->cost.resize(static_cast<size_t>(config_.width) * config_.height);
+
+        size_t out = 0;
+        for (uint32_t iy = 0; iy < config_.height; ++iy) {
+            for (uint32_t ix = 0; ix < config_.width; ++ix) {
+                const size_t s = storageIndex(originX_ + ix, originY_ + iy);
+                uint8_t cost;
+                if (lethal(s)) {
+                    cost = COST_LETHAL;
+                } else if (inflated_[s] > 0) {
+                    cost = inflated_[s];
+                } else {
+                    cost = known_[s] ? COST_FREE : COST_UNKNOWN;
+                }
+                grid->cost[out++] = cost;
+            }
+        }
+        grid_.store(gridPool_->publish(std::move(grid)));
+    }
+};
+
+}  // namespace raisin_sdk
@@ -0,0 +1,235 @@
+/**
+ * @file executor.hpp
+ * @brief Per-topic executors that decouple decode and callbacks from reception
+ *
+ * By default a topic's handler runs inline on the network thread, so a slow
+ * consumer delays reception for everything. A TopicExecutor can instead
+ * hand messages to its own thread through a bounded mailbox; the mailbox
+ * policy decides what happens when the consumer falls behind. Every
+ * executor keeps received/decoded/delivered/dropped counters.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace raisin_sdk {
+
+/**
+ * @brief What a full mailbox does with a new message
+ */
+enum class MailboxPolicy {
+    INLINE,        ///< No executor: handle on the network thread (default)
+    KEEP_LATEST,   ///< Drop the oldest queued message to make room
+    FIFO,          ///< Drop the new message, keep the queued ones in order
+    BLOCK          ///< Wait on the network thread until there is room (never drops)
+};
+
+/**
+ * @brief Executor settings for one subscription
+ */
+struct ExecutorOptions {
+    MailboxPolicy policy = MailboxPolicy::INLINE;
+    size_t capacity = 1;   ///< Mailbox size (1 with KEEP_LATEST = latest-only)
+};
+
+/**
+ * @brief Plain copy of a topic's counters
+ */
+struct TopicCounters {
+    uint64_t received = 0;    ///< Messages that arrived from the network
+    uint64_t decoded = 0;     ///< Messages the SDK finished decoding
+    uint64_t delivered = 0;   ///< Messages handed to at least one user callback
+    uint64_t dropped = 0;     ///< Messages discarded by the mailbox policy
+    size_t queued = 0;        ///< Messages waiting in the mailbox right now
+};
+
+/**
+ * @brief Runs a handler per message, inline or on a dedicated thread
+ *
+ * configure() may be called at any time except from the handler on the
+ * worker thread (it would have to join itself, so it is rejected); queued
+ * messages are discarded (counted as dropped) and the thread is restarted
+ * if needed. The handler runs on one thread at a time, including across
+ * reconfiguration, so it may keep single-threaded scratch state.
+ *
+ * @code
+ * raisin_sdk::TopicExecutor<MsgPtr> executor([](const MsgPtr& msg) { ... });
+ * executor.configure({raisin_sdk::MailboxPolicy::KEEP_LATEST, 1});
+ * executor.post(msg);    // from the network callback
+ * @endcode
+ */
+template <typename Msg>
+class TopicExecutor {
+public:
+    using Handler = std::function<void(const Msg&)>;
+
+    explicit TopicExecutor(Handler handler) : handler_(std::move(handler)) {}
+
+    ~TopicExecutor() { stop(); }
+
+    TopicExecutor(const TopicExecutor&) = delete;
+    TopicExecutor& operator=(const TopicExecutor&) = delete;
+
+    /**
+     * @brief Switch policy/capacity; starts or stops the worker thread as needed
+     * @return false (nothing changed) when called from the worker thread
+     */
+    bool configure(const ExecutorOptions& options) {
+        if (onWorker()) return false;
+        std::lock_guard<std::mutex> lifecycle(lifecycleMutex_);
+        stopLocked();
+        std::lock_guard<std::mutex> lock(mutex_);
+        options_ = options;
+        options_.capacity = std::max<size_t>(options_.capacity, 1);
+        stopping_ = false;
+        if (options_.policy != MailboxPolicy::INLINE) {
+            worker_ = std::thread([this]() { workerLoop(); });
+            workerId_ = worker_.get_id();
+        }
+        return true;
+    }
+
+    /**
+     * @brief Stop the worker thread, dropping whatever is still queued
+     * Messages keep being queued (or dropped) until the worker has exited;
+     * only then does the executor fall back to INLINE.
+     * @return false (nothing changed) when called from the worker thread
+     */
+    bool stop() {
+        if (onWorker()) return false;
+        std::lock_guard<std::mutex> lifecycle(lifecycleMutex_);
+        stopLocked();
+        return true;
+    }
+
+    /// Hand a message over (called from the network thread)
+    void post(Msg msg) {
+        received_.fetch_add(1, std::memory_order_relaxed);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (options_.policy == MailboxPolicy::INLINE) {
+            lock.unlock();
+            handler_(msg);
+            return;
+        }
+        if (stopping_) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        if (queue_.size() >= options_.capacity) {
+            switch (options_.policy) {
+                case MailboxPolicy::KEEP_LATEST:
+                    queue_.pop_front();
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    break;
+                case MailboxPolicy::FIFO:
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                default:
+                    spaceCv_.wait(lock, [this]() {
+                        return stopping_ || queue_.size() < options_.capacity;
+                    });
+                    if (stopping_) {
+                        dropped_.fetch_add(1, std::memory_order_relaxed);
+                        return;
+                    }
+                    break;
+            }
+        }
+        queue_.push_back(std::move(msg));
+        lock.unlock();
+        readyCv_.notify_one();
+    }
+
+    /// Called by the handler once the message is decoded
+    void markDecoded() { decoded_.fetch_add(1, std::memory_order_relaxed); }
+
+    /// Called by the handler once a user callback received the message
+    void markDelivered() { delivered_.fetch_add(1, std::memory_order_relaxed); }
+
+    TopicCounters counters() const {
+        TopicCounters c;
+        c.received = received_.load(std::memory_order_relaxed);
+        c.decoded = decoded_.load(std::memory_order_relaxed);
+        c.delivered = delivered_.load(std::memory_order_relaxed);
+        c.dropped = dropped_.load(std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(mutex_);
+        c.queued = queue_.size();
+        return c;
+    }
+
+    ExecutorOptions options() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return options_;
+    }
+
+private:
+    Handler handler_;
+    ExecutorOptions options_;
+
+    std::mutex lifecycleMutex_;         ///< Serializes configure() and stop()
+    mutable std::mutex mutex_;
+    std::condition_variable readyCv_;   ///< Signals the worker that a message is queued
+    std::condition_variable spaceCv_;   ///< Signals BLOCK posters that room was made
+    std::deque<Msg> queue_;
+    std::thread worker_;
+    std::thread::id workerId_;          ///< Kept until the worker is joined, for onWorker()
+    bool stopping_ = false;
+
+    std::atomic<uint64_t> received_{0};
+    std::atomic<uint64_t> decoded_{0};
+    std::atomic<uint64_t> delivered_{0};
+    std::atomic<uint64_t> dropped_{0};
+
+    bool onWorker() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return workerId_ == std::this_thread::get_id();
+    }
+
+    /// Join the worker first, so an inline post() never overlaps its last handler call
+    void stopLocked() {
+        std::thread worker;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+            worker = std::move(worker_);
+        }
+        readyCv_.notify_all();
+        spaceCv_.notify_all();
+        if (worker.joinable()) worker.join();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        dropped_.fetch_add(queue_.size(), std::memory_order_relaxed);
+        queue_.clear();
+        options_.policy = MailboxPolicy::INLINE;
+        workerId_ = std::thread::id();
+    }
+
+    void workerLoop() {
+        for (;;) {
+            Msg msg;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                readyCv_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+                if (stopping_) return;
+                msg = std::move(queue_.front());
+                queue_.pop_front();
+            }
+            spaceCv_.notify_one();
+            handler_(msg);
+        }
+    }
+};
+
+}  // namespace raisin_sdk
@@ -0,0 +1,221 @@
+/**
+ * @file ground_segmentation.hpp
+ * @brief Single-pass polar-grid ground/obstacle classifier
+ *
+ * GroundSegmenter bins points into a polar grid around the robot, takes
+ * the lowest point of every cell as a ground candidate, and walks each
+ * sector outward accepting candidates that respect a maximum slope. Points
+ * close enough above their cell's ground estimate are labelled ground.
+ * Cost is O(points + cells); the per-point passes are branch-free loops
+ * over the SoA channels that the compiler can vectorize.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "raisin_sdk/point_cloud.hpp"
+#include "raisin_sdk/point_cloud_soa.hpp"
+
+namespace raisin_sdk {
+
+/**
+ * @brief Per-point classification
+ */
+enum PointLabel : uint8_t {
+    LABEL_UNKNOWN = 0,    ///< Non-finite or beyond max_range
+    LABEL_GROUND = 1,     ///< Traversable ground
+    LABEL_OBSTACLE = 2    ///< Everything else
+};
+
+/**
+ * @brief Ground segmentation settings
+ */
+struct GroundSegmentationConfig {
+    uint32_t num_sectors = 128;       ///< Angular divisions around the robot
+    uint32_t num_bins = 64;           ///< Radial divisions up to max_range
+    float max_range = 32.0f;          ///< Points farther than this (xy) are LABEL_UNKNOWN
+    float ground_z_offset = -0.5f;    ///< Expected ground height relative to the odometry z
+    float max_slope = 0.3f;           ///< Largest ground rise per metre between neighbouring bins
+    float slope_tolerance = 0.1f;     ///< Absolute height slack added to the slope test (m)
+    float ground_threshold = 0.15f;   ///< Points up to this far above the ground estimate are ground
+};
+
+/**
+ * @brief Polar-grid ground segmenter (reuses its buffers across frames)
+ *
+ * Positions are in the cloud's frame; (ox, oy, oz) is the robot origin in
+ * the same frame, e.g. the latest odometry for /cloud_registered.
+ *
+ * @code
+ * raisin_sdk::GroundSegmenter segmenter;
+ * raisin_sdk::PointCloudSoA ground, obstacles;
+ * segmenter.segment(cloud, state.x, state.y, state.z, ground, obstacles);
+ * @endcode
+ */
+class GroundSegmenter {
+public:
+    explicit GroundSegmenter(const GroundSegmentationConfig& config = {}) { setConfig(config); }
+
+    const GroundSegmentationConfig& config() const { return config_; }
+
+    void setConfig(const GroundSegmentationConfig& config) {
+        config_ = config;
+        config_.num_sectors = std::max<uint32_t>(config_.num_sectors, 4);
+        config_.num_bins = std::max<uint32_t>(config_.num_bins, 1);
+        const size_t cells = static_cast<size_t>(config_.num_sectors) * config_.num_bins;
+        minZ_.assign(cells, 0.0f);
+        groundZ_.assign(cells, 0.0f);
+    }
+
+    /// Label every point of cloud
+    void segment(const PointCloudSoA& cloud, double ox, double oy, double oz, std::vector<uint8_t>& labels) {
+        const size_t n = cloud.size();
+        computeCells(cloud.x.data(), cloud.y.data(), cloud.z.data(), n, ox, oy);
+        estimateGround(cloud.z.data(), n, oz);
+
+        labels.resize(n);
+        const uint32_t invalid = invalidCell();
+        const float threshold = config_.ground_threshold;
+        const float* z = cloud.z.data();
+        for (size_t i = 0; i < n; ++i) {
+            const uint32_t cell = cells_[i];
+            const float ground = groundZ_[cell == invalid ? 0 : cell];
+            labels[i] = cell == invalid ? LABEL_UNKNOWN
+                                        : (z[i] - ground <= threshold ? LABEL_GROUND : LABEL_OBSTACLE);
+        }
+    }
+
+    /// Label and split into ground and obstacle clouds (LABEL_UNKNOWN points go to neither)
+    void segment(const PointCloudSoA& cloud, double ox, double oy, double oz,
+                 PointCloudSoA& ground, PointCloudSoA& obstacles) {
+        segment(cloud, ox, oy, oz, labels_);
+        split(cloud, labels_, ground, obstacles);
+    }
+
+    /// Labels from the last split segment() call
+    const std::vector<uint8_t>& labels() const { return labels_; }
+
+    /// Ground height estimate at a polar cell from the last segment() call
+    float groundHeight(uint32_t sector, uint32_t bin) const {
+        return groundZ_[static_cast<size_t>(sector) * config_.num_bins + bin];
+    }
+
+    /// Copy points of cloud into ground/obstacles by label, keeping all channels
+    static void split(const PointCloudSoA& cloud, const std::vector<uint8_t>& labels,
+                      PointCloudSoA& ground, PointCloudSoA& obstacles) {
+        size_t numGround = 0;
+        size_t numObstacle = 0;
+        for (uint8_t label : labels) {
+            numGround += label == LABEL_GROUND;
+            numObstacle += label == LABEL_OBSTACLE;
+        }
+        prepareOutput(cloud, ground, numGround);
+        prepareOutput(cloud, obstacles, numObstacle);
+
+        size_t g = 0;
+        size_t o = 0;
+        for (size_t i = 0; i < labels.size(); ++i) {
+            if (labels[i] == LABEL_GROUND) {
+                copyPoint(cloud, i, ground, g++);
+            } else if (labels[i] == LABEL_OBSTACLE) {
+                copyPoint(cloud, i, obstacles, o++);
+            }
+        }
+    }
+
+private:
+    GroundSegmentationConfig config_;
+    std::vector<uint32_t> cells_;    ///< Polar cell per point (invalidCell() if unusable)
+    std::vector<float> minZ_;        ///< Lowest z per cell (+inf when empty)
+    std::vector<float> groundZ_;     ///< Ground estimate per cell
+    std::vector<uint8_t> labels_;
+
+    uint32_t invalidCell() const { return config_.num_sectors * config_.num_bins; }
+
+    /// Polar cell of every point; the angle uses a monotonic pseudo-angle instead of atan2
+    void computeCells(const float* x, const float* y, const float* z, size_t n, double ox, double oy) {
+        cells_.resize(n);
+        const float fx = static_cast<float>(ox);
+        const float fy = static_cast<float>(oy);
+        const float binScale = config_.num_bins / config_.max_range;
+        const float sectorScale = config_.num_sectors * 0.25f;
+        const uint32_t bins = config_.num_bins;
+        const uint32_t sectors = config_.num_sectors;
+        const uint32_t invalid = invalidCell();
+        const float maxRangeSq = config_.max_range * config_.max_range;
+
+        for (size_t i = 0; i < n; ++i) {
+            const float dx = x[i] - fx;
+            const float dy = y[i] - fy;
+            const float rangeSq = dx * dx + dy * dy;
+            const float r = std::sqrt(rangeSq);
+
+            // Diamond angle in [0, 4): same ordering as atan2, no transcendental
+            const float ax = std::fabs(dx);
+            const float ay = std::fabs(dy);
+            const float t = ay / (ax + ay + 1e-12f);
+            const float quadrant = dy >= 0.0f ? (dx >= 0.0f ? t : 2.0f - t)
+                                              : (dx < 0.0f ? 2.0f + t : 4.0f - t);
+
+            // NaN fails the range test, so the casts below only see finite values
+            const bool usable = rangeSq <= maxRangeSq && std::isfinite(z[i]);
+            const uint32_t bin = std::min(static_cast<uint32_t>(usable ? r * binScale : 0.0f), bins - 1);
+            const uint32_t sector = std::min(static_cast<uint32_t>(usable ? quadrant * sectorScale : 0.0f),
+                                             sectors - 1);
+            cells_[i] = usable ? sector * bins + bin : invalid;
+        }
+    }
+
+    void estimateGround(const float* z, size_t n, double oz) {
+        std::fill(minZ_.begin(), minZ_.end(), std::numeric_limits<float>::infinity());
+        const uint32_t invalid = invalidCell();
+        for (size_t i = 0; i < n; ++i) {
+            const uint32_t cell = cells_[i];
+            if (cell != invalid) minZ_[cell] = std::min(minZ_[cell], z[i]);
+        }
+
+        // Walk each sector outward, accepting the lowest point only if the
+        // slope from the last accepted ground bin is plausible
+        const float binSize = config_.max_range / config_.num_bins;
+        const float origin = static_cast<float>(oz) + config_.ground_z_offset;
+        for (uint32_t s = 0; s < config_.num_sectors; ++s) {
+            float lastZ = origin;
+            float lastR = 0.0f;
+            const size_t base = static_cast<size_t>(s) * config_.num_bins;
+            for (uint32_t b = 0; b < config_.num_bins; ++b) {
+                const float r = (b + 0.5f) * binSize;
+                const float candidate = minZ_[base + b];
+                const float allowed = config_.max_slope * (r - lastR) + config_.slope_tolerance;
+                if (std::isfinite(candidate) && std::fabs(candidate - lastZ) <= allowed) {
+                    lastZ = candidate;
+                    lastR = r;
+                }
+                groundZ_[base + b] = lastZ;
+            }
+        }
+    }
+
+    static void prepareOutput(const PointCloudSoA& in, PointCloudSoA& out, size_t n) {
+        out.has_intensity = in.has_intensity;
+        out.has_ring = in.has_ring;
+        out.has_time = in.has_time;
+        out.resize(n);
+    }
+
+    static void copyPoint(const PointCloudSoA& in, size_t i, PointCloudSoA& out, size_t j) {
+        out.x[j] = in.x[i];
+        out.y[j] = in.y[i];
+        out.z[j] = in.z[i];
+        out.intensity[j] = in.intensity[i];
+        if (in.has_ring) out.ring[j] = in.ring[i];
+        if (in.has_time) out.time[j] = in.time[i];
+    }
+};
+
+}  // namespace raisin_sdk
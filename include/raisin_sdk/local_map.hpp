@@ -0,0 +1,341 @@
+/**
+ * @file local_map.hpp
+ * @brief Sliding-window, robot-centred voxel map built from live clouds
+ *
+ * LocalMapAccumulator fuses successive /cloud_registered frames into one
+ * voxel map. Each frame is first reduced to one centroid per voxel, then
+ * fused: every voxel keeps a running centroid and the time it was last
+ * observed. Voxels are queued in the order they were last seen, so age
+ * eviction only touches expired voxels; distance eviction sweeps the map
+ * only after the robot moved a set distance. Memory and per-insert cost
+ * stay bounded no matter how long the history is.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include "raisin_sdk/cloud_filter.hpp"
+#include "raisin_sdk/point_cloud.hpp"
+#include "raisin_sdk/point_cloud_soa.hpp"
+#include "raisin_sdk/voxel_grid.hpp"
+
+namespace raisin_sdk {
+
+/**
+ * @brief Local map settings
+ */
+struct LocalMapConfig {
+    float voxel_size = 0.1f;        ///< Voxel edge length in metres
+    double max_age_sec = 5.0;       ///< Evict voxels not observed for this long (<= 0 disables)
+    float max_distance = 20.0f;     ///< Evict voxels farther than this (xy) from the robot (<= 0 disables)
+    size_t max_voxels = 1000000;    ///< Hard cap; oldest voxels go first when exceeded
+    float distance_sweep_step = 1.0f;   ///< Robot travel (xy) between distance sweeps; voxels may outlive max_distance by this much
+};
+
+/**
+ * @brief One occupied voxel of the local map
+ */
+struct MapVoxel {
+    float x = 0.0f;           ///< Centroid X
+    float y = 0.0f;           ///< Centroid Y
+    float z = 0.0f;           ///< Centroid Z
+    uint32_t hits = 0;        ///< Frames that hit this voxel (saturates)
+    double last_seen = 0.0;   ///< Stamp of the last frame that hit this voxel
+    uint64_t key = 0;         ///< Packed voxel index
+};
+
+/**
+ * @brief Bounded voxel map fused from successive point cloud frames
+ *
+ * Thread-safe: insert() and the queries take an internal mutex, so the
+ * network thread can feed the map while another thread queries it. Frames
+ * are downsampled before that mutex is taken, so queries only wait for the
+ * fusion itself. Stamps are expected not to go backwards.
+ *
+ * @code
+ * raisin_sdk::LocalMapAccumulator map({0.1f, 5.0, 15.0f});
+ * map.updateRobotPose(state.x, state.y);
+ * map.insert(points);
+ * std::vector<raisin_sdk::Point3D> nearby;
+ * map.queryRadius({0.0f, 0.0f, 0.5f}, 1.0f, nearby);
+ * @endcode
+ */
+class LocalMapAccumulator {
+public:
+    explicit LocalMapAccumulator(const LocalMapConfig& config = {})
+        : config_(config), inverseSize_(1.0f / config.voxel_size) {
+        VoxelGridConfig grid;
+        grid.voxel_size = config.voxel_size;
+        downsampler_.setConfig(grid);
+        table_.prepare(1024);
+    }
+
+    const LocalMapConfig& config() const { return config_; }
+
+    /// Robot position (map frame) used for distance eviction
+    void updateRobotPose(double x, double y) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        robotX_ = x;
+        robotY_ = y;
+    }
+
+    /// Fuse a frame; stamp in seconds (defaults to steady-clock now)
+    void insert(const std::vector<Point3D>& points, double stamp = now()) {
+        std::lock_guard<std::mutex> insertLock(insertMutex_);
+        downsampler_.apply(points, frame_);
+        fuseFrame(stamp);
+    }
+
+    void insert(const PointCloudView& cloud, double stamp = now()) {
+        if (!cloud.hasXYZ()) return;
+        std::lock_guard<std::mutex> insertLock(insertMutex_);
+        downsampler_.apply(cloud, frame_);
+        fuseFrame(stamp);
+    }
+
+    void insert(const PointCloudSoA& cloud, double stamp = now()) {
+        std::lock_guard<std::mutex> insertLock(insertMutex_);
+        downsampler_.apply(cloud.size(),
+                           [&cloud](size_t i) { return Point3D{cloud.x[i], cloud.y[i], cloud.z[i]}; },
+                           [this](size_t count) {
+                               frame_.resize(count);
+                               return frame_.data();
+                           });
+        fuseFrame(stamp);
+    }
+
+    /// Voxel centroids within radius of center
+    void queryRadius(const Point3D& center, float radius, std::vector<Point3D>& out) const {
+        out.clear();
+        const float r2 = radius * radius;
+        const Box3 box(center.x - radius, center.y - radius, center.z - radius,
+                       center.x + radius, center.y + radius, center.z + radius);
+        std::lock_guard<std::mutex> lock(mutex_);
+        forEachInBox(box, [&](const MapVoxel& v) {
+            const float dx = v.x - center.x;
+            const float dy = v.y - center.y;
+            const float dz = v.z - center.z;
+            if (dx * dx + dy * dy + dz * dz <= r2) out.push_back({v.x, v.y, v.z});
+        });
+    }
+
+    /// Voxel centroids inside an axis-aligned box
+    void queryBox(const Box3& box, std::vector<Point3D>& out) const {
+        out.clear();
+        std::lock_guard<std::mutex> lock(mutex_);
+        forEachInBox(box, [&](const MapVoxel& v) {
+            if (box.contains(v.x, v.y, v.z)) out.push_back({v.x, v.y, v.z});
+        });
+    }
+
+    /// Copy of all voxel centroids
+    std::vector<Point3D> points() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<Point3D> out;
+        out.reserve(voxels_.size());
+        for (const auto& v : voxels_) out.push_back({v.x, v.y, v.z});
+        return out;
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return voxels_.size();
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        voxels_.clear();
+        seenOrder_.clear();
+        table_.prepare(1024);
+    }
+
+    /// Steady-clock time in seconds, the default insert() stamp
+    static double now() {
+        return std::chrono::duration<double>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    static constexpr uint32_t kMaxHits = 1000;   ///< Centroid keeps adapting after this many hits
+
+    /// A voxel as of the frame that last saw it; stale once the voxel is seen again or removed
+    struct SeenEntry {
+        double stamp;
+        uint64_t key;
+        uint32_t index;   ///< Position in voxels_ when queued; checked before falling back to the hash
+    };
+
+    LocalMapConfig config_;
+    float inverseSize_;
+    double robotX_ = 0.0;
+    double robotY_ = 0.0;
+    double sweepX_ = 0.0;                 ///< Robot position at the last distance sweep
+    double sweepY_ = 0.0;
+
+    std::mutex insertMutex_;              ///< Serializes inserts; guards the two members below
+    VoxelGridFilter downsampler_;         ///< Same grid as the map: one centroid per voxel and frame
+    std::vector<Point3D> frame_;
+
+    mutable std::mutex mutex_;
+    std::vector<MapVoxel> voxels_;        ///< Dense storage; table_ maps key -> index
+    detail::VoxelHashTable table_;
+    std::deque<SeenEntry> seenOrder_;     ///< One live entry per voxel, oldest first
+
+    void fuseFrame(double stamp) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const bool byDistance = config_.max_distance > 0.0f;
+        const double maxDistSq = static_cast<double>(config_.max_distance) * config_.max_distance;
+        for (const Point3D& p : frame_) {
+            // Would be evicted right away
+            const double dx = p.x - robotX_;
+            const double dy = p.y - robotY_;
+            if (byDistance && dx * dx + dy * dy > maxDistSq) continue;
+            fusePoint(p.x, p.y, p.z, stamp);
+        }
+        evict(stamp);
+    }
+
+    void fusePoint(float x, float y, float z, double stamp) {
+        const uint64_t key = detail::packVoxelKey(x, y, z, inverseSize_);
+        if (key == detail::kInvalidVoxelKey) return;
+
+        bool inserted;
+        const uint32_t index = table_.findOrInsert(key, detail::hashVoxelKey(key),
+                                                   static_cast<uint32_t>(voxels_.size()), inserted);
+        if (inserted) {
+            MapVoxel voxel;
+            voxel.x = x;
+            voxel.y = y;
+            voxel.z = z;
+            voxel.hits = 1;
+            voxel.last_seen = stamp;
+            voxel.key = key;
+            voxels_.push_back(voxel);
+            seenOrder_.push_back({stamp, key, index});
+            return;
+        }
+
+        MapVoxel& voxel = voxels_[index];
+        if (voxel.last_seen != stamp) seenOrder_.push_back({stamp, key, index});
+        if (voxel.hits < kMaxHits) ++voxel.hits;
+        const float w = 1.0f / static_cast<float>(voxel.hits);
+        voxel.x += (x - voxel.x) * w;
+        voxel.y += (y - voxel.y) * w;
+        voxel.z += (z - voxel.z) * w;
+        voxel.last_seen = stamp;
+    }
+
+    /// Swap-remove voxel i, keeping the table's indices in sync
+    void removeAt(size_t i) {
+        table_.erase(voxels_[i].key, detail::hashVoxelKey(voxels_[i].key));
+        const size_t last = voxels_.size() - 1;
+        if (i != last) {
+            voxels_[i] = voxels_[last];
+            *table_.find(voxels_[i].key, detail::hashVoxelKey(voxels_[i].key)) = static_cast<uint32_t>(i);
+        }
+        voxels_.pop_back();
+    }
+
+    /// Whether e still stands for its voxel, and where that voxel is now
+    bool isLive(const SeenEntry& e, uint32_t& index) const {
+        index = e.index;
+        if (index >= voxels_.size() || voxels_[index].key != e.key) {
+            const uint32_t* found = table_.find(e.key, detail::hashVoxelKey(e.key));
+            if (!found) return false;
+            index = *found;
+        }
+        return voxels_[index].last_seen == e.stamp;
+    }
+
+    void evict(double stamp) {
+        const bool byAge = config_.max_age_sec > 0.0;
+        const double oldest = stamp - config_.max_age_sec;
+
+        // Distance: full sweep, but only once per distance_sweep_step of travel
+        const double movedX = robotX_ - sweepX_;
+        const double movedY = robotY_ - sweepY_;
+        const double step = std::max(config_.distance_sweep_step, 0.0f);
+        if (config_.max_distance > 0.0f && movedX * movedX + movedY * movedY >= step * step) {
+            sweepX_ = robotX_;
+            sweepY_ = robotY_;
+            const double maxDistSq = static_cast<double>(config_.max_distance) * config_.max_distance;
+            for (size_t i = 0; i < voxels_.size();) {
+                const double dx = voxels_[i].x - robotX_;
+                const double dy = voxels_[i].y - robotY_;
+                if (dx * dx + dy * dy > maxDistSq) {
+                    removeAt(i);   // re-check i: it now holds the former last voxel
+                } else {
+                    ++i;
+                }
+            }
+        }
+
+        // Age and cap: least recently seen voxels sit at the front
+        while (!seenOrder_.empty()) {
+            const SeenEntry& e = seenOrder_.front();
+            uint32_t index;
+            if (isLive(e, index)) {
+                const bool expired = byAge && e.stamp < oldest;
+                if (!expired && voxels_.size() <= config_.max_voxels) break;
+                removeAt(index);
+            }
+            seenOrder_.pop_front();
+        }
+
+        // Stale entries behind a live one pile up while voxels keep being re-seen
+        if (seenOrder_.size() > 2 * voxels_.size() + 1024) {
+            seenOrder_.erase(std::remove_if(seenOrder_.begin(), seenOrder_.end(),
+                                            [this](const SeenEntry& e) {
+                                                uint32_t index;
+                                                return !isLive(e, index);
+                                            }),
+                             seenOrder_.end());
+        }
+    }
+
+    /**
+     * @brief Visit voxels that may lie in box
+     * Probes the hash per cell when the box covers fewer cells than there
+     * are voxels, otherwise scans the dense voxel array. The box is clipped
+     * to the voxel key range.
+     */
+    template <typename Fn>
+    void forEachInBox(const Box3& box, const Fn& fn) const {
+        constexpr int64_t kLow = -detail::kVoxelIndexRange;
+        constexpr int64_t kHigh = detail::kVoxelIndexRange - 1;
+        const int64_t x0 = std::max(kLow, detail::voxelIndex(box.min_x * inverseSize_));
+        const int64_t y0 = std::max(kLow, detail::voxelIndex(box.min_y * inverseSize_));
+        const int64_t z0 = std::max(kLow, detail::voxelIndex(box.min_z * inverseSize_));
+        const int64_t x1 = std::min(kHigh, detail::voxelIndex(box.max_x * inverseSize_));
+        const int64_t y1 = std::min(kHigh, detail::voxelIndex(box.max_y * inverseSize_));
+        const int64_t z1 = std::min(kHigh, detail::voxelIndex(box.max_z * inverseSize_));
+        if (x1 < x0 || y1 < y0 || z1 < z0) return;
+
+        const double cells = static_cast<double>(x1 - x0 + 1) * (y1 - y0 + 1) * (z1 - z0 + 1);
+        if (cells >= static_cast<double>(voxels_.size())) {
+            for (const auto& v : voxels_) fn(v);
+            return;
+        }
+
+        for (int64_t ix = x0; ix <= x1; ++ix) {
+            for (int64_t iy = y0; iy <= y1; ++iy) {
+                for (int64_t iz = z0; iz <= z1; ++iz) {
+                    const uint64_t key = detail::packVoxelIndex(ix, iy, iz);
+                    if (key == detail::kInvalidVoxelKey) continue;
+                    const uint32_t* index = table_.find(key, detail::hashVoxelKey(key));
+                    if (index) fn(voxels_[*index]);
+                }
+            }
+        }
+    }
+};
+
+}  // namespace raisin_sdk
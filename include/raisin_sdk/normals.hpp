@@ -0,0 +1,492 @@
+/**
+ * @file normals.hpp
+ * @brief Surface normal estimation and dominant plane extraction
+ *
+ * NormalEstimator fits a plane to each point's neighbourhood, taken either
+ * from adjacent range-image pixels (O(1) per point, no copy of the cloud)
+ * or from a fixed radius via a KD-tree. PlaneExtractor then pulls the
+ * dominant planes (floor, stair treads, ramps, walls) out of the points
+ * with normal-guided RANSAC and a least-squares refit. Both run on the
+ * shared WorkerPool and reuse their buffers across frames.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "raisin_sdk/parallel.hpp"
+#include "raisin_sdk/point_cloud.hpp"
+#include "raisin_sdk/point_cloud_soa.hpp"
+#include "raisin_sdk/range_image.hpp"
+#include "raisin_sdk/spatial_index.hpp"
+
+namespace raisin_sdk {
+
+namespace detail {
+
+/**
+ * @brief Eigen-decomposition of a symmetric 3x3 matrix (cyclic Jacobi)
+ * @param a       Matrix, destroyed
+ * @param values  Eigenvalues, ascending
+ * @param vectors Column i is the unit eigenvector of values[i]
+ */
+inline void symmetricEigen3(double a[3][3], double values[3], double vectors[3][3]) {
+    double v[3][3] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+    for (int sweep = 0; sweep < 16; ++sweep) {
+        const double off = a[0][1] * a[0][1] + a[0][2] * a[0][2] + a[1][2] * a[1][2];
+        if (off < 1e-24) break;
+        for (int p = 0; p < 2; ++p) {
+            for (int q = p + 1; q < 3; ++q) {
+                if (std::fabs(a[p][q]) < 1e-30) continue;
+                const double theta = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+                const double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+                const double c = 1.0 / std::sqrt(t * t + 1.0);
+                const double s = t * c;
+                for (int k = 0; k < 3; ++k) {
+                    const double akp = a[k][p], akq = a[k][q];
+                    a[k][p] = c * akp - s * akq;
+                    a[k][q] = s * akp + c * akq;
+                }
+                for (int k = 0; k < 3; ++k) {
+                    const double apk = a[p][k], aqk = a[q][k];
+                    a[p][k] = c * apk - s * aqk;
+                    a[q][k] = s * apk + c * aqk;
+                }
+                for (int k = 0; k < 3; ++k) {
+                    const double vkp = v[k][p], vkq = v[k][q];
+                    v[k][p] = c * vkp - s * vkq;
+                    v[k][q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+
+    int order[3] = {0, 1, 2};
+    std::sort(order, order + 3, [&a](int i, int j) { return a[i][i] < a[j][j]; });
+    for (int i = 0; i < 3; ++i) {
+        values[i] = a[order[i]][order[i]];
+        for (int k = 0; k < 3; ++k) vectors[k][i] = v[k][order[i]];
+    }
+}
+
+/**
+ * @brief Running mean/covariance of a point set
+ * Coordinates are taken relative to the first point so large map
+ * coordinates do not cost precision.
+ */
+struct CovarianceAccumulator {
+    double origin[3] = {0.0, 0.0, 0.0};
+    double sum[3] = {0.0, 0.0, 0.0};
+    double sumSq[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};   ///< xx, xy, xz, yy, yz, zz
+    size_t count = 0;
+
+    void add(double x, double y, double z) {
+        if (count == 0) {
+            origin[0] = x;
+            origin[1] = y;
+            origin[2] = z;
+        }
+        const double dx = x - origin[0], dy = y - origin[1], dz = z - origin[2];
+        sum[0] += dx;
+        sum[1] += dy;
+        sum[2] += dz;
+        sumSq[0] += dx * dx;
+        sumSq[1] += dx * dy;
+        sumSq[2] += dx * dz;
+        sumSq[3] += dy * dy;
+        sumSq[4] += dy * dz;
+        sumSq[5] += dz * dz;
+        ++count;
+    }
+
+    void mean(double out[3]) const {
+        for (int k = 0; k < 3; ++k) out[k] = origin[k] + (count ? sum[k] / count : 0.0);
+    }
+
+    /// Eigenvalues (ascending) and eigenvectors (columns) of the covariance; false below 3 points
+    bool solve(double values[3], double vectors[3][3]) const {
+        if (count < 3) return false;
+        const double n = static_cast<double>(count);
+        const double m[3] = {sum[0] / n, sum[1] / n, sum[2] / n};
+        double cov[3][3];
+        cov[0][0] = sumSq[0] / n - m[0] * m[0];
+        cov[0][1] = cov[1][0] = sumSq[1] / n - m[0] * m[1];
+        cov[0][2] = cov[2][0] = sumSq[2] / n - m[0] * m[2];
+        cov[1][1] = sumSq[3] / n - m[1] * m[1];
+        cov[1][2] = cov[2][1] = sumSq[4] / n - m[1] * m[2];
+        cov[2][2] = sumSq[5] / n - m[2] * m[2];
+        symmetricEigen3(cov, values, vectors);
+        return true;
+    }
+};
+
+}  // namespace detail
+
+/**
+ * @brief Normal estimation settings
+ */
+struct NormalEstimationConfig {
+    uint32_t window_cols = 2;            ///< Range image: columns on each side of the pixel
+    uint32_t window_rows = 1;            ///< Range image: rows on each side of the pixel
+    float max_neighbor_distance = 0.5f;  ///< Range image: farther pixels are across an edge and ignored
+    float radius = 0.3f;                 ///< Point cloud: neighbourhood radius (m)
+    size_t max_neighbors = 16;           ///< Point cloud: closest neighbours used
+    size_t min_neighbors = 4;            ///< Fewer neighbours (centre included) leave the normal invalid
+};
+
+/**
+ * @brief Per-element normals, in the cloud's frame
+ *
+ * One entry per range-image pixel or per cloud point, depending on which
+ * NormalEstimator::compute() filled it. Normals point towards the sensor;
+ * invalid entries have NaN components.
+ */
+struct SurfaceNormals {
+    std::vector<float> nx;
+    std::vector<float> ny;
+    std::vector<float> nz;
+    std::vector<float> curvature;   ///< Smallest eigenvalue / eigenvalue sum: 0 flat, 1/3 isotropic
+
+    size_t size() const { return nx.size(); }
+    bool valid(size_t i) const { return nx[i] == nx[i]; }
+
+    void reset(size_t n) {
+        const float nan = std::numeric_limits<float>::quiet_NaN();
+        nx.assign(n, nan);
+        ny.assign(n, nan);
+        nz.assign(n, nan);
+        curvature.assign(n, nan);
+    }
+};
+
+/**
+ * @brief Multithreaded normal estimation (reuses its buffers across frames)
+ *
+ * (ox, oy, oz) is the sensor origin in the cloud's frame, e.g. the latest
+ * odometry pose for /cloud_registered; normals are flipped to face it.
+ *
+ * @code
+ * raisin_sdk::NormalEstimator estimator;
+ * raisin_sdk::SurfaceNormals normals;
+ * estimator.compute(image, state.x, state.y, state.z, normals);   // per pixel
+ * @endcode
+ */
+class NormalEstimator {
+public:
+    explicit NormalEstimator(const NormalEstimationConfig& config = {}, std::shared_ptr<WorkerPool> pool = nullptr)
+        : config_(config), pool_(pool ? std::move(pool) : WorkerPool::shared()) {}
+
+    const NormalEstimationConfig& config() const { return config_; }
+    void setConfig(const NormalEstimationConfig& config) { config_ = config; }
+
+    /// One normal per pixel from the adjacent pixels
+    void compute(const RangeImage& image, double ox, double oy, double oz, SurfaceNormals& out) const {
+        out.reset(image.range.size());
+        const float maxDistSq = config_.max_neighbor_distance * config_.max_neighbor_distance;
+        const Point3D origin{static_cast<float>(ox), static_cast<float>(oy), static_cast<float>(oz)};
+        pool_->parallelForRange(image.height, 4, [&](size_t rowBegin, size_t rowEnd) {
+            for (uint32_t row = static_cast<uint32_t>(rowBegin); row < rowEnd; ++row) {
+                for (uint32_t col = 0; col < image.width; ++col) {
+                    const size_t p = image.pixelIndex(col, row);
+                    if (image.index[p] < 0) continue;
+                    const float cx = image.x[p], cy = image.y[p], cz = image.z[p];
+                    detail::CovarianceAccumulator acc;
+                    image.forEachNeighbor(col, row, config_.window_cols, config_.window_rows, [&](size_t q) {
+                        const float dx = image.x[q] - cx, dy = image.y[q] - cy, dz = image.z[q] - cz;
+                        if (dx * dx + dy * dy + dz * dz <= maxDistSq) acc.add(image.x[q], image.y[q], image.z[q]);
+                    });
+                    store(acc, {cx, cy, cz}, origin, p, out);
+                }
+            }
+        });
+    }
+
+    /// One normal per point from its radius neighbourhood (KD-tree built per call)
+    void compute(const PointCloudSoA& cloud, double ox, double oy, double oz, SurfaceNormals& out) {
+        points_.resize(cloud.size());
+        for (size_t i = 0; i < cloud.size(); ++i) points_[i] = cloud.point(i);
+        computeRadius(ox, oy, oz, out);
+    }
+
+    void compute(const std::vector<Point3D>& cloud, double ox, double oy, double oz, SurfaceNormals& out) {
+        points_ = cloud;
+        computeRadius(ox, oy, oz, out);
+    }
+
+private:
+    NormalEstimationConfig config_;
+    std::shared_ptr<WorkerPool> pool_;
+    std::vector<Point3D> points_;
+    KdTree tree_;
+
+    void computeRadius(double ox, double oy, double oz, SurfaceNormals& out) {
+        out.reset(points_.size());
+        tree_.build(points_);
+        const Point3D origin{static_cast<float>(ox), static_cast<float>(oy), static_cast<float>(oz)};
+        pool_->parallelForRange(points_.size(), 1024, [&](size_t begin, size_t end) {
+            std::vector<Neighbor> neighbors;
+            for (size_t i = begin; i < end; ++i) {
+                const Point3D& p = points_[i];
+                if (!(std::isfinite(p.x) && std::isfinite(p.y) && std::isfinite(p.z))) continue;
+                tree_.nearest(p, std::max<size_t>(config_.max_neighbors, 1), neighbors, config_.radius);
+                detail::CovarianceAccumulator acc;
+                for (const auto& n : neighbors) acc.add(n.point.x, n.point.y, n.point.z);
+                store(acc, p, origin, i, out);
+            }
+        });
+    }
+
+    void store(const detail::CovarianceAccumulator& acc, const Point3D& p, const Point3D& origin, size_t i,
+               SurfaceNormals& out) const {
+        double values[3], vectors[3][3];
+        if (acc.count < std::max<size_t>(config_.min_neighbors, 3) || !acc.solve(values, vectors)) return;
+        const double total = values[0] + values[1] + values[2];
+        if (!(total > 0.0)) return;
+
+        float n[3] = {static_cast<float>(vectors[0][0]), static_cast<float>(vectors[1][0]),
+                      static_cast<float>(vectors[2][0])};
+        const float facing = n[0] * (origin.x - p.x) + n[1] * (origin.y - p.y) + n[2] * (origin.z - p.z);
+        if (facing < 0.0f) {
+            n[0] = -n[0];
+            n[1] = -n[1];
+            n[2] = -n[2];
+        }
+        out.nx[i] = n[0];
+        out.ny[i] = n[1];
+        out.nz[i] = n[2];
+        out.curvature[i] = static_cast<float>(std::max(values[0], 0.0) / total);
+    }
+};
+
+/**
+ * @brief Orientation class of an extracted plane
+ */
+enum class PlaneType {
+    FLOOR,   ///< Near-horizontal: floor, stair tread, platform
+    RAMP,    ///< Walkable incline
+    WALL,    ///< Near-vertical
+    OTHER    ///< Too steep to walk, too flat to be a wall
+};
+
+/**
+ * @brief A plane n . p + d = 0 with n pointing towards the sensor
+ */
+struct Plane {
+    float nx = 0.0f, ny = 0.0f, nz = 1.0f;
+    float d = 0.0f;
+    float cx = 0.0f, cy = 0.0f, cz = 0.0f;   ///< Inlier centroid
+    float tilt = 0.0f;                       ///< Angle from horizontal (rad)
+    float rmse = 0.0f;                       ///< RMS inlier distance to the plane (m)
+    size_t inliers = 0;
+    PlaneType type = PlaneType::OTHER;
+
+    float distance(float x, float y, float z) const { return nx * x + ny * y + nz * z + d; }
+};
+
+/**
+ * @brief Plane extraction settings
+ */
+struct PlaneExtractionConfig {
+    size_t max_planes = 6;
+    size_t min_inliers = 200;           ///< Smaller planes end the extraction
+    float distance_threshold = 0.05f;   ///< Inlier distance to the plane (m)
+    float angle_threshold = 0.26f;      ///< Inlier normal deviation (rad, about 15 degrees)
+    float max_curvature = 0.05f;        ///< Points curvier than this do not seed or fit planes
+    int iterations = 64;                ///< RANSAC hypotheses per plane
+    size_t sample_points = 4096;        ///< Hypotheses are scored on this many evenly spaced points
+    float floor_max_tilt = 0.17f;       ///< FLOOR up to this tilt (rad, about 10 degrees)
+    float ramp_max_tilt = 0.61f;        ///< RAMP up to this tilt (rad, about 35 degrees)
+    float wall_min_tilt = 1.22f;        ///< WALL from this tilt (rad, about 70 degrees)
+};
+
+/**
+ * @brief Normal-guided RANSAC plane extraction
+ *
+ * Each hypothesis is a point plus its own normal, so one sample is enough
+ * and only the scoring costs anything; hypotheses are scored in parallel
+ * on a subsample, and the winner is refit by least squares on all its
+ * inliers. labels() gives each element's plane index (-1 for none).
+ *
+ * @code
+ * raisin_sdk::PlaneExtractor extractor;
+ * std::vector<raisin_sdk::Plane> planes;
+ * extractor.extract(image, normals, state.x, state.y, state.z, planes);
+ * for (const auto& plane : planes) {
+ *     if (plane.type == raisin_sdk::PlaneType::RAMP) { ... }
+ * }
+ * @endcode
+ */
+class PlaneExtractor {
+public:
+    explicit PlaneExtractor(const PlaneExtractionConfig& config = {}, std::shared_ptr<WorkerPool> pool = nullptr)
+        : config_(config), pool_(pool ? std::move(pool) : WorkerPool::shared()) {}
+
+    const PlaneExtractionConfig& config() const { return config_; }
+    void setConfig(const PlaneExtractionConfig& config) { config_ = config; }
+
+    /// Planes of a range image with per-pixel normals
+    void extract(const RangeImage& image, const SurfaceNormals& normals, double ox, double oy, double oz,
+                 std::vector<Plane>& planes) {
+        run(image.x.data(), image.y.data(), image.z.data(), image.range.size(), normals, ox, oy, oz, planes);
+    }
+
+    /// Planes of a cloud with per-point normals
+    void extract(const PointCloudSoA& cloud, const SurfaceNormals& normals, double ox, double oy, double oz,
+                 std::vector<Plane>& planes) {
+        run(cloud.x.data(), cloud.y.data(), cloud.z.data(), cloud.size(), normals, ox, oy, oz, planes);
+    }
+
+    /// Plane index per element from the last extract() (-1: no plane)
+    const std::vector<int8_t>& labels() const { return labels_; }
+
+private:
+    struct Hypothesis {
+        size_t seed = 0;
+        size_t score = 0;
+    };
+
+    PlaneExtractionConfig config_;
+    std::shared_ptr<WorkerPool> pool_;
+    std::vector<int8_t> labels_;
+    std::vector<uint32_t> candidates_;   ///< Flat, unassigned elements
+    std::vector<uint32_t> sample_;
+
+    void run(const float* x, const float* y, const float* z, size_t n, const SurfaceNormals& normals,
+             double ox, double oy, double oz, std::vector<Plane>& planes) {
+        planes.clear();
+        labels_.assign(n, -1);
+        if (normals.size() != n) return;
+
+        candidates_.clear();
+        for (size_t i = 0; i < n; ++i) {
+            if (normals.valid(i) && normals.curvature[i] <= config_.max_curvature) {
+                candidates_.push_back(static_cast<uint32_t>(i));
+            }
+        }
+
+        const float cosAngle = std::cos(config_.angle_threshold);
+        const float threshold = config_.distance_threshold;
+        const size_t maxPlanes = std::min<size_t>(config_.max_planes, 127);
+        uint64_t rng = 0x9e3779b97f4a7c15ULL;
+
+        while (planes.size() < maxPlanes && candidates_.size() >= std::max<size_t>(config_.min_inliers, 3)) {
+            // Evenly spaced scoring subsample of the remaining candidates
+            const size_t sampleSize = std::min(candidates_.size(), std::max<size_t>(config_.sample_points, 1));
+            sample_.resize(sampleSize);
+            for (size_t k = 0; k < sampleSize; ++k) sample_[k] = candidates_[k * candidates_.size() / sampleSize];
+
+            const size_t numHypotheses = static_cast<size_t>(std::max(config_.iterations, 1));
+            std::vector<Hypothesis> hypotheses(numHypotheses);
+            for (auto& h : hypotheses) {
+                rng ^= rng << 13;
+                rng ^= rng >> 7;
+                rng ^= rng << 17;
+                h.seed = sample_[rng % sampleSize];
+            }
+            pool_->parallelFor(numHypotheses, [&](size_t t) {
+                const size_t s = hypotheses[t].seed;
+                const float nx = normals.nx[s], ny = normals.ny[s], nz = normals.nz[s];
+                const float d = -(nx * x[s] + ny * y[s] + nz * z[s]);
+                size_t score = 0;
+                for (uint32_t i : sample_) {
+                    const float dist = nx * x[i] + ny * y[i] + nz * z[i] + d;
+                    const float align = nx * normals.nx[i] + ny * normals.ny[i] + nz * normals.nz[i];
+                    score += (std::fabs(dist) <= threshold && std::fabs(align) >= cosAngle) ? 1 : 0;
+                }
+                hypotheses[t].score = score;
+            });
+            const Hypothesis best = *std::max_element(hypotheses.begin(), hypotheses.end(),
+                [](const Hypothesis& a, const Hypothesis& b) { return a.score < b.score; });
+            if (best.score * candidates_.size() < config_.min_inliers * sampleSize) break;
+
+            // Least-squares refit on the seed plane's inliers, then final inlier pass
+            Plane plane;
+            plane.nx = normals.nx[best.seed];
+            plane.ny = normals.ny[best.seed];
+            plane.nz = normals.nz[best.seed];
+            plane.d = -(plane.nx * x[best.seed] + plane.ny * y[best.seed] + plane.nz * z[best.seed]);
+            for (int pass = 0; pass < 2; ++pass) {
+                detail::CovarianceAccumulator acc;
+                for (uint32_t i : candidates_) {
+                    if (isInlier(plane, i, x, y, z, normals, threshold, cosAngle)) acc.add(x[i], y[i], z[i]);
+                }
+                double values[3], vectors[3][3], mean[3];
+                if (!acc.solve(values, vectors)) break;
+                acc.mean(mean);
+                setPlane(plane, vectors, mean, ox, oy, oz);
+            }
+
+            const int8_t label = static_cast<int8_t>(planes.size());
+            double sumSq = 0.0;
+            size_t kept = 0;
+            for (uint32_t i : candidates_) {
+                if (isInlier(plane, i, x, y, z, normals, threshold, cosAngle)) {
+                    const float dist = plane.distance(x[i], y[i], z[i]);
+                    sumSq += static_cast<double>(dist) * dist;
+                    labels_[i] = label;
+                } else {
+                    candidates_[kept++] = i;
+                }
+            }
+            plane.inliers = candidates_.size() - kept;
+            candidates_.resize(kept);
+            if (plane.inliers < config_.min_inliers) {
+                for (size_t i = 0; i < n; ++i) {
+                    if (labels_[i] == label) {
+                        labels_[i] = -1;
+                        candidates_.push_back(static_cast<uint32_t>(i));
+                    }
+                }
+                break;
+            }
+            plane.rmse = static_cast<float>(std::sqrt(sumSq / plane.inliers));
+            classify(plane);
+            planes.push_back(plane);
+        }
+    }
+
+    static bool isInlier(const Plane& plane, uint32_t i, const float* x, const float* y, const float* z,
+                         const SurfaceNormals& normals, float threshold, float cosAngle) {
+        const float align = plane.nx * normals.nx[i] + plane.ny * normals.ny[i] + plane.nz * normals.nz[i];
+        return std::fabs(plane.distance(x[i], y[i], z[i])) <= threshold && std::fabs(align) >= cosAngle;
+    }
+
+    /// Plane through mean with the smallest-eigenvalue normal, oriented towards (ox, oy, oz)
+    static void setPlane(Plane& plane, const double vectors[3][3], const double mean[3],
+                         double ox, double oy, double oz) {
+        double n[3] = {vectors[0][0], vectors[1][0], vectors[2][0]};
+        double d = -(n[0] * mean[0] + n[1] * mean[1] + n[2] * mean[2]);
+        if (n[0] * ox + n[1] * oy + n[2] * oz + d < 0.0) {
+            for (double& v : n) v = -v;
+            d = -d;
+        }
+        plane.nx = static_cast<float>(n[0]);
+        plane.ny = static_cast<float>(n[1]);
+        plane.nz = static_cast<float>(n[2]);
+        plane.d = static_cast<float>(d);
+        plane.cx = static_cast<float>(mean[0]);
+        plane.cy = static_cast<float>(mean[1]);
+        plane.cz = static_cast<float>(mean[2]);
+    }
+
+    void classify(Plane& plane) const {
+        plane.tilt = std::acos(std::min(1.0f, std::fabs(plane.nz)));
+        if (plane.tilt <= config_.floor_max_tilt) {
+            plane.type = PlaneType::FLOOR;
+        } else if (plane.tilt <= config_.ramp_max_tilt) {
+            plane.type = PlaneType::RAMP;
+        } else if (plane.tilt >= config_.wall_min_tilt) {
+            plane.type = PlaneType::WALL;
+        } else {
+            plane.type = PlaneType::OTHER;
+        }
+    }
+};
+
+}  // namespace raisin_sdk
@@ -0,0 +1,201 @@
+/**
+ * @file parallel.hpp
+ * @brief Small persistent worker pool for data-parallel point cloud stages
+ *
+ * WorkerPool runs one parallelFor() job at a time over a fixed set of
+ * threads, with the calling thread taking tasks too. It is used by the
+ * decode, downsampling and mapping stages of the SDK; a process-wide
+ * instance is available through WorkerPool::shared().
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace raisin_sdk {
+
+/**
+ * @brief Fixed-size thread pool executing indexed task ranges
+ */
+class WorkerPool {
+public:
+    /**
+     * @param numWorkers Background threads; the caller of parallelFor() also works.
+     *                   Defaults to hardware_concurrency() - 1.
+     */
+    explicit WorkerPool(size_t numWorkers = defaultWorkerCount()) {
+        workers_.reserve(numWorkers);
+        for (size_t i = 0; i < numWorkers; ++i) {
+            workers_.emplace_back([this]() { workerLoop(); });
+        }
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wakeCv_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /// Process-wide pool shared by SDK components
+    static std::shared_ptr<WorkerPool> shared() {
+        static std::shared_ptr<WorkerPool> pool = std::make_shared<WorkerPool>();
+        return pool;
+    }
+
+    /// Number of threads that execute tasks (workers + caller)
+    size_t concurrency() const { return workers_.size() + 1; }
+
+    /**
+     * @brief Run fn(task) for task in [0, numTasks), blocking until all finish
+     *
+     * Calls from inside a task, or while another job is running on this
+     * pool from a different thread, are safe: nested calls run inline and
+     * concurrent calls are serialized.
+     */
+    void parallelFor(size_t numTasks, const std::function<void(size_t)>& fn) {
+        if (numTasks == 0) return;
+        if (numTasks == 1 || workers_.empty() || insideWorker()) {
+            for (size_t i = 0; i < numTasks; ++i) fn(i);
+            return;
+        }
+
+        std::lock_guard<std::mutex> jobLock(jobMutex_);
+        runJob(numTasks, fn);
+    }
+
+    /**
+     * @brief parallelFor() that does not wait for another thread's job
+     *
+     * For latency-sensitive callers: if the pool is busy, all tasks run on
+     * the calling thread instead of queueing behind the running job.
+     * @return false if the tasks ran on the calling thread only
+     */
+    bool tryParallelFor(size_t numTasks, const std::function<void(size_t)>& fn) {
+        if (numTasks == 0) return true;
+        std::unique_lock<std::mutex> jobLock(jobMutex_, std::defer_lock);
+        if (numTasks == 1 || workers_.empty() || insideWorker() || !jobLock.try_lock()) {
+            for (size_t i = 0; i < numTasks; ++i) fn(i);
+            return false;
+        }
+        runJob(numTasks, fn);
+        return true;
+    }
+
+    /**
+     * @brief Split [0, count) into contiguous ranges and run fn(begin, end) on each
+     * @param minRange Smallest range worth handing to a separate thread
+     */
+    void parallelForRange(size_t count, size_t minRange,
+                          const std::function<void(size_t, size_t)>& fn) {
+        if (count == 0) return;
+        const size_t maxChunks = std::max<size_t>(1, count / std::max<size_t>(1, minRange));
+        const size_t numChunks = std::min(maxChunks, concurrency());
+        const size_t chunk = (count + numChunks - 1) / numChunks;
+        parallelFor(numChunks, [&](size_t c) {
+            const size_t begin = c * chunk;
+            const size_t end = std::min(count, begin + chunk);
+            if (begin < end) fn(begin, end);
+        });
+    }
+
+private:
+    std::vector<std::thread> workers_;
+
+    std::mutex jobMutex_;   ///< Serializes parallelFor() callers; tryParallelFor() only tries it
+    std::mutex mutex_;
+    std::condition_variable wakeCv_;
+    std::condition_variable doneCv_;
+    const std::function<void(size_t)>* job_ = nullptr;
+    size_t numTasks_ = 0;
+    std::atomic<size_t> nextTask_{0};
+    size_t pending_ = 0;    ///< Tasks not yet finished
+    size_t active_ = 0;     ///< Workers currently holding job_
+    uint64_t generation_ = 0;
+    bool stopping_ = false;
+
+    static size_t defaultWorkerCount() {
+        const unsigned hw = std::thread::hardware_concurrency();
+        return hw > 1 ? hw - 1 : 0;
+    }
+
+    static bool& insideWorker() {
+        thread_local bool inside = false;
+        return inside;
+    }
+
+    /// Hand fn to the workers and take tasks until all finish (jobMutex_ held)
+    void runJob(size_t numTasks, const std::function<void(size_t)>& fn) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job_ = &fn;
+            numTasks_ = numTasks;
+            nextTask_.store(0, std::memory_order_relaxed);
+            pending_ = numTasks;
+            ++generation_;
+        }
+        wakeCv_.notify_all();
+
+        insideWorker() = true;
+        runTasks(fn, numTasks, false);
+        insideWorker() = false;
+
+        // Workers that picked up this job must let go of fn before it dies
+        std::unique_lock<std::mutex> lock(mutex_);
+        doneCv_.wait(lock, [this]() { return pending_ == 0 && active_ == 0; });
+        job_ = nullptr;
+    }
+
+    void runTasks(const std::function<void(size_t)>& fn, size_t numTasks, bool worker) {
+        size_t completed = 0;
+        for (;;) {
+            const size_t task = nextTask_.fetch_add(1, std::memory_order_relaxed);
+            if (task >= numTasks) break;
+            fn(task);
+            ++completed;
+        }
+        if (completed > 0 || worker) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_ -= completed;
+            if (worker) --active_;
+            if (pending_ == 0 && active_ == 0) doneCv_.notify_all();
+        }
+    }
+
+    void workerLoop() {
+        insideWorker() = true;
+        uint64_t seen = 0;
+        for (;;) {
+            const std::function<void(size_t)>* job;
+            size_t numTasks;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wakeCv_.wait(lock, [&]() { return stopping_ || (generation_ != seen && job_); });
+                if (stopping_) return;
+                seen = generation_;
+                job = job_;
+                numTasks = numTasks_;
+                ++active_;
+            }
+            runTasks(*job, numTasks, true);
+        }
+    }
+};
+
+}  // namespace raisin_sdk
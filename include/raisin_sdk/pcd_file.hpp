@@ -0,0 +1,395 @@
+/**
+ * @file pcd_file.hpp
+ * @brief Memory-mapped PCD reader for large map files
+ *
+ * PcdFile maps the file read-only and parses only the text header; binary
+ * point data is then read in place through the mapping, so opening a
+ * multi-gigabyte map costs no copy. binary_compressed data is inflated
+ * once into an owned buffer and ascii data is parsed into x/y/z.
+ */
+
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "raisin_sdk/point_cloud.hpp"
+
+namespace raisin_sdk {
+
+/**
+ * @brief One FIELDS entry of a PCD header
+ */
+struct PcdField {
+    std::string name;
+    char type = 'F';       ///< F (float), I (signed), U (unsigned)
+    uint32_t size = 4;     ///< Bytes per element
+    uint32_t count = 1;    ///< Elements per point
+    uint32_t offset = 0;   ///< Byte offset within an interleaved point record
+};
+
+namespace detail {
+
+/**
+ * @brief LZF decompression (liblzf format, used by PCD binary_compressed)
+ * @return Decompressed size, or 0 on corrupt input or overflow
+ */
+inline size_t lzfDecompress(const uint8_t* in, size_t size, uint8_t* out, size_t capacity) {
+    const uint8_t* ip = in;
+    const uint8_t* const end = in + size;
+    uint8_t* op = out;
+    uint8_t* const outEnd = out + capacity;
+
+    while (ip < end) {
+        size_t ctrl = *ip++;
+        if (ctrl < 32) {
+            const size_t run = ctrl + 1;
+            if (static_cast<size_t>(end - ip) < run || static_cast<size_t>(outEnd - op) < run) return 0;
+            std::memcpy(op, ip, run);
+            op += run;
+            ip += run;
+            continue;
+        }
+
+        size_t length = ctrl >> 5;
+        if (length == 7) {
+            if (ip >= end) return 0;
+            length += *ip++;
+        }
+        if (ip >= end) return 0;
+        const size_t distance = ((ctrl & 0x1f) << 8) + *ip++ + 1;
+        length += 2;
+        if (distance > static_cast<size_t>(op - out) || static_cast<size_t>(outEnd - op) < length) return 0;
+        const uint8_t* ref = op - distance;
+        for (size_t i = 0; i < length; ++i) op[i] = ref[i];   // may overlap
+        op += length;
+    }
+    return static_cast<size_t>(op - out);
+}
+
+}  // namespace detail
+
+/**
+ * @brief Read-only, memory-mapped PCD file
+ *
+ * @code
+ * raisin_sdk::PcdFile map;
+ * if (map.open("site.pcd") && map.hasXYZ()) {
+ *     for (size_t i = 0; i < map.size(); ++i) { raisin_sdk::Point3D p = map.point(i); }
+ * }
+ * @endcode
+ */
+class PcdFile {
+public:
+    enum class DataFormat { ASCII, BINARY, BINARY_COMPRESSED };
+
+    PcdFile() = default;
+    ~PcdFile() { close(); }
+
+    PcdFile(const PcdFile&) = delete;
+    PcdFile& operator=(const PcdFile&) = delete;
+
+    /**
+     * @brief Map path and parse its header
+     * @return false on I/O errors or malformed headers (see lastError())
+     */
+    bool open(const std::string& path) {
+        close();
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return fail("Cannot open " + path + ": " + std::strerror(errno));
+
+        struct stat info;
+        if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+            ::close(fd);
+            return fail("Cannot read " + path);
+        }
+        length_ = static_cast<size_t>(info.st_size);
+        void* mapped = ::mmap(nullptr, length_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);   // the mapping keeps the file alive
+        if (mapped == MAP_FAILED) {
+            length_ = 0;
+            return fail("Cannot map " + path + ": " + std::strerror(errno));
+        }
+        mapping_ = static_cast<const uint8_t*>(mapped);
+        ::madvise(mapped, length_, MADV_SEQUENTIAL);
+
+        if (!parseHeader() || !prepareData()) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        if (mapping_) ::munmap(const_cast<uint8_t*>(mapping_), length_);
+        mapping_ = nullptr;
+        length_ = 0;
+        fields_.clear();
+        owned_.clear();
+        owned_.shrink_to_fit();
+        points_ = 0;
+        pointStep_ = 0;
+        packedXYZ_ = nullptr;
+        x_ = y_ = z_ = Channel();
+    }
+
+    bool isOpen() const { return mapping_ != nullptr; }
+    size_t size() const { return points_; }
+    DataFormat format() const { return format_; }
+    const std::vector<PcdField>& fields() const { return fields_; }
+    const std::string& lastError() const { return error_; }
+
+    /// Sensor pose from VIEWPOINT: x y z qw qx qy qz
+    const double* viewpoint() const { return viewpoint_; }
+
+    const PcdField* field(const std::string& name) const {
+        for (const auto& f : fields_) {
+            if (f.name == name) return &f;
+        }
+        return nullptr;
+    }
+
+    /// True if x/y/z are float32 or float64
+    bool hasXYZ() const { return x_.base && y_.base && z_.base; }
+
+    Point3D point(size_t i) const { return {x_.read(i), y_.read(i), z_.read(i)}; }
+
+    /**
+     * @brief Raw interleaved x/y/z float32 records, if the file stores them that way
+     * Non-null only for binary files whose first fields are float x, y, z;
+     * the record size is pointStep(). Lets callers bulk-copy straight from the mapping.
+     */
+    const uint8_t* packedXYZ() const { return packedXYZ_; }
+    size_t pointStep() const { return pointStep_; }
+
+private:
+    /// Strided access to one scalar channel (interleaved or planar storage)
+    struct Channel {
+        const uint8_t* base = nullptr;
+        size_t stride = 0;
+        bool isDouble = false;
+
+        float read(size_t i) const {
+            const uint8_t* p = base + i * stride;
+            if (isDouble) {
+                double d;
+                std::memcpy(&d, p, sizeof(d));
+                return static_cast<float>(d);
+            }
+            float f;
+            std::memcpy(&f, p, sizeof(f));
+            return f;
+        }
+    };
+
+    const uint8_t* mapping_ = nullptr;
+    size_t length_ = 0;
+    size_t dataOffset_ = 0;
+    DataFormat format_ = DataFormat::BINARY;
+    std::vector<PcdField> fields_;
+    size_t points_ = 0;
+    size_t pointStep_ = 0;
+    double viewpoint_[7] = {0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0};
+    std::vector<uint8_t> owned_;   ///< Inflated (binary_compressed) or parsed (ascii) data
+    const uint8_t* packedXYZ_ = nullptr;
+    Channel x_, y_, z_;
+    std::string error_;
+
+    bool fail(const std::string& message) {
+        error_ = message;
+        return false;
+    }
+
+    bool parseHeader() {
+        std::vector<std::string> names, sizes, types, counts;
+        size_t width = 0, height = 1, points = 0;
+        bool havePoints = false;
+
+        size_t pos = 0;
+        for (;;) {
+            if (pos >= length_) return fail("PCD header has no DATA line");
+            const void* nl = std::memchr(mapping_ + pos, '\n', length_ - pos);
+            const size_t lineEnd = nl ? static_cast<size_t>(static_cast<const uint8_t*>(nl) - mapping_) : length_;
+            std::string line(reinterpret_cast<const char*>(mapping_ + pos), lineEnd - pos);
+            pos = lineEnd + 1;
+            if (line.empty() || line[0] == '#') continue;
+
+            std::istringstream words(line);
+            std::string key;
+            words >> key;
+            std::vector<std::string> values;
+            for (std::string v; words >> v;) values.push_back(v);
+
+            if (key == "FIELDS" || key == "COLUMNS") {
+                names = values;
+            } else if (key == "SIZE") {
+                sizes = values;
+            } else if (key == "TYPE") {
+                types = values;
+            } else if (key == "COUNT") {
+                counts = values;
+            } else if (key == "WIDTH" && !values.empty()) {
+                width = std::strtoull(values[0].c_str(), nullptr, 10);
+            } else if (key == "HEIGHT" && !values.empty()) {
+                height = std::strtoull(values[0].c_str(), nullptr, 10);
+            } else if (key == "POINTS" && !values.empty()) {
+                points = std::strtoull(values[0].c_str(), nullptr, 10);
+                havePoints = true;
+            } else if (key == "VIEWPOINT" && values.size() == 7) {
+                for (int k = 0; k < 7; ++k) viewpoint_[k] = std::strtod(values[k].c_str(), nullptr);
+            } else if (key == "DATA" && !values.empty()) {
+                if (values[0] == "ascii") {
+                    format_ = DataFormat::ASCII;
+                } else if (values[0] == "binary") {
+                    format_ = DataFormat::BINARY;
+                } else if (values[0] == "binary_compressed") {
+                    format_ = DataFormat::BINARY_COMPRESSED;
+                } else {
+                    return fail("Unsupported PCD DATA type: " + values[0]);
+                }
+                break;
+            }
+        }
+        dataOffset_ = std::min(pos, length_);
+
+        if (names.empty() || sizes.size() != names.size() || types.size() != names.size() ||
+            (!counts.empty() && counts.size() != names.size())) {
+            return fail("Inconsistent PCD FIELDS/SIZE/TYPE/COUNT");
+        }
+        uint32_t offset = 0;
+        for (size_t k = 0; k < names.size(); ++k) {
+            PcdField f;
+            f.name = names[k];
+            f.size = static_cast<uint32_t>(std::strtoul(sizes[k].c_str(), nullptr, 10));
+            f.type = types[k].empty() ? 'F' : types[k][0];
+            f.count = counts.empty() ? 1 : static_cast<uint32_t>(std::strtoul(counts[k].c_str(), nullptr, 10));
+            f.offset = offset;
+            if (f.size == 0 || f.count == 0) return fail("Invalid PCD field " + f.name);
+            offset += f.size * f.count;
+            fields_.push_back(f);
+        }
+        pointStep_ = offset;
+        points_ = havePoints ? points : width * height;
+        return true;
+    }
+
+    Channel channel(const std::string& name, const uint8_t* interleaved, const uint8_t* planar) const {
+        Channel c;
+        const PcdField* f = field(name);
+        if (!f || f->type != 'F' || (f->size != 4 && f->size != 8)) return c;
+        c.isDouble = f->size == 8;
+        if (interleaved) {
+            c.base = interleaved + f->offset;
+            c.stride = pointStep_;
+        } else {
+            // Planar: each field's values are stored contiguously, fields in header order
+            size_t start = 0;
+            for (const auto& g : fields_) {
+                if (&g == f) break;
+                start += static_cast<size_t>(g.size) * g.count * points_;
+            }
+            c.base = planar + start;
+            c.stride = static_cast<size_t>(f->size) * f->count;
+        }
+        return c;
+    }
+
+    bool prepareData() {
+        const uint8_t* data = mapping_ + dataOffset_;
+        const size_t available = length_ - dataOffset_;
+
+        if (format_ == DataFormat::BINARY) {
+            if (available / pointStep_ < points_) return fail("PCD file is truncated");
+            x_ = channel("x", data, nullptr);
+            y_ = channel("y", data, nullptr);
+            z_ = channel("z", data, nullptr);
+            const PcdField* fx = field("x");
+            const PcdField* fy = field("y");
+            const PcdField* fz = field("z");
+            if (fx && fy && fz && fx->offset == 0 && fy->offset == 4 && fz->offset == 8 &&
+                !x_.isDouble && !y_.isDouble && !z_.isDouble) {
+                packedXYZ_ = data;
+            }
+            return true;
+        }
+
+        if (format_ == DataFormat::BINARY_COMPRESSED) {
+            uint32_t sizes[2];
+            if (available < sizeof(sizes)) return fail("PCD file is truncated");
+            std::memcpy(sizes, data, sizeof(sizes));
+            if (available - sizeof(sizes) < sizes[0]) return fail("PCD file is truncated");
+            if (sizes[1] != pointStep_ * points_) return fail("PCD compressed size mismatch");
+            owned_.resize(sizes[1]);
+            if (sizes[1] > 0 &&
+                detail::lzfDecompress(data + sizeof(sizes), sizes[0], owned_.data(), owned_.size()) != sizes[1]) {
+                return fail("Corrupt PCD compressed data");
+            }
+            x_ = channel("x", nullptr, owned_.data());
+            y_ = channel("y", nullptr, owned_.data());
+            z_ = channel("z", nullptr, owned_.data());
+            return true;
+        }
+
+        return parseAscii(reinterpret_cast<const char*>(data), available);
+    }
+
+    /// ascii: keep x/y/z only, as packed float32 records in owned_
+    bool parseAscii(const char* text, size_t length) {
+        int columns[3] = {-1, -1, -1};
+        int column = 0;
+        int totalColumns = 0;
+        for (const auto& f : fields_) {
+            if (f.name == "x") columns[0] = column;
+            if (f.name == "y") columns[1] = column;
+            if (f.name == "z") columns[2] = column;
+            column += static_cast<int>(f.count);
+        }
+        totalColumns = column;
+        if (columns[0] < 0 || columns[1] < 0 || columns[2] < 0) return true;   // hasXYZ() stays false
+
+        // strtof needs a terminator; the mapping is not null-terminated
+        std::string copy(text, length);
+        owned_.resize(points_ * 12);
+        float* out = reinterpret_cast<float*>(owned_.data());
+        const char* p = copy.c_str();
+        size_t n = 0;
+        while (n < points_ && *p) {
+            float values[3] = {0.0f, 0.0f, 0.0f};
+            char* next = nullptr;
+            for (int c = 0; c < totalColumns; ++c) {
+                const float v = std::strtof(p, &next);
+                if (next == p) return fail("Malformed PCD ascii data");
+                for (int k = 0; k < 3; ++k) {
+                    if (columns[k] == c) values[k] = v;
+                }
+                p = next;
+            }
+            out[3 * n] = values[0];
+            out[3 * n + 1] = values[1];
+            out[3 * n + 2] = values[2];
+            ++n;
+            while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') ++p;
+        }
+        points_ = n;
+        pointStep_ = 12;
+        x_ = {owned_.data(), 12, false};
+        y_ = {owned_.data() + 4, 12, false};
+        z_ = {owned_.data() + 8, 12, false};
+        packedXYZ_ = owned_.data();
+        return true;
+    }
+};
+
+}  // namespace raisin_sdk
@@ -0,0 +1,306 @@
+/**
+ * @file point_cloud.hpp
+ * @brief Point cloud types and zero-copy access to PointCloud2 messages
+ *
+ * PointCloudView wraps a received PointCloud2 message and reads fields
+ * directly from its data buffer, so consumers that only scan the cloud
+ * never materialize a copy.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <compare>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "sensor_msgs/msg/point_cloud2.hpp"
+
+namespace raisin_sdk {
+
+/**
+ * @brief Point for simple point cloud representation
+ */
+struct Point3D {
+    float x, y, z;
+};
+
+/**
+ * @brief Decoded point cloud frame
+ * Published by RaisinClient as an immutable std::shared_ptr<const PointCloud>.
+ */
+struct PointCloud {
+    std::vector<Point3D> points;
+    uint64_t sequence = 0;   ///< Frame counter, increments per received message
+
+    size_t size() const { return points.size(); }
+    bool empty() const { return points.empty(); }
+};
+
+/**
+ * @brief PointField datatype values (sensor_msgs/PointField)
+ */
+enum class PointFieldType : uint8_t {
+    INT8 = 1,
+    UINT8 = 2,
+    INT16 = 3,
+    UINT16 = 4,
+    INT32 = 5,
+    UINT32 = 6,
+    FLOAT32 = 7,
+    FLOAT64 = 8
+};
+
+namespace detail {
+
+/// PointField datatype matching a C++ scalar type
+template <typename T> struct PointFieldTypeOf;
+template <> struct PointFieldTypeOf<int8_t>   { static constexpr PointFieldType value = PointFieldType::INT8; };
+template <> struct PointFieldTypeOf<uint8_t>  { static constexpr PointFieldType value = PointFieldType::UINT8; };
+template <> struct PointFieldTypeOf<int16_t>  { static constexpr PointFieldType value = PointFieldType::INT16; };
+template <> struct PointFieldTypeOf<uint16_t> { static constexpr PointFieldType value = PointFieldType::UINT16; };
+template <> struct PointFieldTypeOf<int32_t>  { static constexpr PointFieldType value = PointFieldType::INT32; };
+template <> struct PointFieldTypeOf<uint32_t> { static constexpr PointFieldType value = PointFieldType::UINT32; };
+template <> struct PointFieldTypeOf<float>    { static constexpr PointFieldType value = PointFieldType::FLOAT32; };
+template <> struct PointFieldTypeOf<double>   { static constexpr PointFieldType value = PointFieldType::FLOAT64; };
+
+/// Unaligned typed load from a byte buffer
+template <typename T>
+inline T loadUnaligned(const uint8_t* ptr) {
+    T value;
+    std::memcpy(&value, ptr, sizeof(T));
+    return value;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Typed, strided read-only view of one field across all points
+ *
+ * Element i is read from `base + i * stride`. Loads are unaligned-safe.
+ */
+template <typename T>
+class StridedFieldView {
+public:
+    class Iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = T;
+
+        Iterator() = default;
+        Iterator(const uint8_t* ptr, size_t stride) : ptr_(ptr), stride_(stride) {}
+
+        T operator*() const { return detail::loadUnaligned<T>(ptr_); }
+        T operator[](difference_type n) const { return *(*this + n); }
+
+        Iterator& operator++() { ptr_ += stride_; return *this; }
+        Iterator operator++(int) { Iterator tmp = *this; ++*this; return tmp; }
+        Iterator& operator--() { ptr_ -= stride_; return *this; }
+        Iterator operator--(int) { Iterator tmp = *this; --*this; return tmp; }
+        Iterator& operator+=(difference_type n) { ptr_ += n * static_cast<difference_type>(stride_); return *this; }
+        Iterator& operator-=(difference_type n) { ptr_ -= n * static_cast<difference_type>(stride_); return *this; }
+        friend Iterator operator+(Iterator it, difference_type n) { return it += n; }
+        friend Iterator operator+(difference_type n, Iterator it) { return it += n; }
+        friend Iterator operator-(Iterator it, difference_type n) { return it -= n; }
+        friend difference_type operator-(const Iterator& a, const Iterator& b) {
+            return a.stride_ ? (a.ptr_ - b.ptr_) / static_cast<difference_type>(a.stride_) : 0;
+        }
+        friend bool operator==(const Iterator& a, const Iterator& b) { return a.ptr_ == b.ptr_; }
+        friend auto operator<=>(const Iterator& a, const Iterator& b) { return a.ptr_ <=> b.ptr_; }
+
+    private:
+        const uint8_t* ptr_ = nullptr;
+        size_t stride_ = 0;
+    };
+
+    StridedFieldView() = default;
+    StridedFieldView(const uint8_t* base, size_t stride, size_t count)
+        : base_(base), stride_(stride), count_(count) {}
+
+    /// False if the field was not found or has a different datatype
+    bool valid() const { return base_ != nullptr; }
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    size_t stride() const { return stride_; }
+
+    T operator[](size_t i) const { return detail::loadUnaligned<T>(base_ + i * stride_); }
+
+    Iterator begin() const { return Iterator(base_, stride_); }
+    Iterator end() const { return Iterator(base_ + count_ * stride_, stride_); }
+
+private:
+    const uint8_t* base_ = nullptr;
+    size_t stride_ = 0;
+    size_t count_ = 0;
+};
+
+/**
+ * @brief Zero-copy view over a received PointCloud2 message
+ *
+ * Holds the message's shared pointer, so the view (and any field views or
+ * iterators obtained from it) stay valid for as long as the view is alive.
+ * Copying a view is cheap and never copies point data.
+ *
+ * @code
+ * client.subscribePointCloud([](const raisin_sdk::PointCloudView& cloud) {
+ *     float maxZ = -1e9f;
+ *     for (float z : cloud.z()) maxZ = std::max(maxZ, z);
+ *     auto intensity = cloud.field<float>("intensity");
+ *     if (intensity.valid()) { ... }
+ * });
+ * @endcode
+ */
+class PointCloudView {
+public:
+    using MessagePtr = raisin::sensor_msgs::msg::PointCloud2::SharedPtr;
+
+    /// Iterator yielding Point3D by value
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Point3D;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Point3D;
+
+        Iterator() = default;
+        Iterator(const PointCloudView* view, size_t index) : view_(view), index_(index) {}
+
+        Point3D operator*() const { return view_->point(index_); }
+        Iterator& operator++() { ++index_; return *this; }
+        Iterator operator++(int) { Iterator tmp = *this; ++index_; return tmp; }
+        friend bool operator==(const Iterator& a, const Iterator& b) { return a.index_ == b.index_; }
+
+    private:
+        const PointCloudView* view_ = nullptr;
+        size_t index_ = 0;
+    };
+
+    PointCloudView() = default;
+
+    explicit PointCloudView(MessagePtr msg) : msg_(std::move(msg)) {
+        if (!msg_ || msg_->data.empty() || msg_->point_step == 0) {
+            return;
+        }
+        numPoints_ = static_cast<size_t>(msg_->width) * msg_->height;
+        // Never index past the buffer, even if width/height disagree with data
+        numPoints_ = std::min(numPoints_, msg_->data.size() / msg_->point_step);
+
+        xOffset_ = floatFieldOffset("x");
+        yOffset_ = floatFieldOffset("y");
+        zOffset_ = floatFieldOffset("z");
+    }
+
+    /// True if the message has float32 x/y/z fields
+    bool hasXYZ() const { return xOffset_ >= 0 && yOffset_ >= 0 && zOffset_ >= 0; }
+
+    /// Byte offsets of the float32 x/y/z fields within a point (-1 if absent)
+    int xOffset() const { return xOffset_; }
+    int yOffset() const { return yOffset_; }
+    int zOffset() const { return zOffset_; }
+
+    size_t size() const { return numPoints_; }
+    bool empty() const { return numPoints_ == 0; }
+    uint32_t width() const { return msg_ ? msg_->width : 0; }
+    uint32_t height() const { return msg_ ? msg_->height : 0; }
+    size_t pointStep() const { return msg_ ? msg_->point_step : 0; }
+
+    /// Raw point buffer (msg->data)
+    const uint8_t* data() const { return msg_ ? msg_->data.data() : nullptr; }
+
+    /// Underlying message (e.g. for header, frame_id)
+    const MessagePtr& message() const { return msg_; }
+
+    /// Find a field descriptor by name, or nullptr
+    const raisin::sensor_msgs::msg::PointField* findField(const std::string& name) const {
+        if (!msg_) return nullptr;
+        for (const auto& field : msg_->fields) {
+            if (field.name == name) return &field;
+        }
+        return nullptr;
+    }
+
+    bool hasField(const std::string& name) const { return findField(name) != nullptr; }
+
+    /**
+     * @brief Typed strided view of a named field
+     * @return Invalid (empty) view if the field is missing, its datatype
+     *         does not match T, or it lies outside point_step
+     */
+    template <typename T>
+    StridedFieldView<T> field(const std::string& name) const {
+        const auto* f = findField(name);
+        if (!f || f->datatype != static_cast<uint8_t>(detail::PointFieldTypeOf<T>::value) ||
+            f->offset + sizeof(T) > pointStep()) {
+            return {};
+        }
+        return StridedFieldView<T>(data() + f->offset, pointStep(), numPoints_);
+    }
+
+    StridedFieldView<float> x() const { return axisView(xOffset_); }
+    StridedFieldView<float> y() const { return axisView(yOffset_); }
+    StridedFieldView<float> z() const { return axisView(zOffset_); }
+
+    /// Read point i (requires hasXYZ())
+    Point3D point(size_t i) const {
+        const uint8_t* ptr = data() + i * pointStep();
+        return {detail::loadUnaligned<float>(ptr + xOffset_),
+                detail::loadUnaligned<float>(ptr + yOffset_),
+                detail::loadUnaligned<float>(ptr + zOffset_)};
+    }
+
+    Point3D operator[](size_t i) const { return point(i); }
+
+    /// Iterate points as Point3D; empty range if x/y/z are missing
+    Iterator begin() const { return Iterator(this, 0); }
+    Iterator end() const { return Iterator(this, hasXYZ() ? numPoints_ : 0); }
+
+    /// Copy the x/y/z points into out, reusing its capacity
+    void copyTo(std::vector<Point3D>& out) const {
+        if (!hasXYZ()) {
+            out.clear();
+            return;
+        }
+        out.resize(numPoints_);
+        for (size_t i = 0; i < numPoints_; ++i) {
+            out[i] = point(i);
+        }
+    }
+
+    /// Materialize an owning copy of the x/y/z points
+    std::vector<Point3D> toVector() const {
+        std::vector<Point3D> points;
+        copyTo(points);
+        return points;
+    }
+
+private:
+    MessagePtr msg_;
+    size_t numPoints_ = 0;
+    int xOffset_ = -1;
+    int yOffset_ = -1;
+    int zOffset_ = -1;
+
+    int floatFieldOffset(const std::string& name) const {
+        const auto* f = findField(name);
+        if (!f || f->datatype != static_cast<uint8_t>(PointFieldType::FLOAT32) ||
+            f->offset + sizeof(float) > msg_->point_step) {
+            return -1;
+        }
+        return static_cast<int>(f->offset);
+    }
+
+    StridedFieldView<float> axisView(int offset) const {
+        if (offset < 0) return {};
+        return StridedFieldView<float>(data() + offset, pointStep(), numPoints_);
+    }
+};
+
+}  // namespace raisin_sdk
@@ -0,0 +1,612 @@
+/**
+ * @file point_cloud_decoder.hpp
+ * @brief Layout-specialized PointCloud2 decoders
+ *
+ * PointCloudDecoder inspects the field layout of the first message on a
+ * topic and selects a decode kernel once. Common sensor layouts are
+ * compiled with fixed offsets; anything else goes through a generic path
+ * that honours each PointField's datatype. The selection is re-done only
+ * when the numeric layout (point_step, field offsets/datatypes) changes.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+#include "raisin_sdk/cloud_filter.hpp"
+#include "raisin_sdk/cloud_stats.hpp"
+#include "raisin_sdk/parallel.hpp"
+#include "raisin_sdk/point_cloud.hpp"
+#include "raisin_sdk/point_cloud_soa.hpp"
+
+namespace raisin_sdk {
+
+/**
+ * @brief Field layout selected by PointCloudDecoder
+ */
+enum class CloudLayout {
+    NONE = 0,         ///< No message decoded yet, or no x/y/z fields
+    XYZ = 1,          ///< pcl::PointXYZ (step 16)
+    XYZI = 2,         ///< pcl::PointXYZI (step 32, intensity @16)
+    XYZI_NORMAL = 3,  ///< pcl::PointXYZINormal, e.g. FAST-LIO (step 48, intensity @32)
+    XYZIRT = 4,       ///< Velodyne-style (step 32, intensity @16, uint16 ring @20, float32 time @24)
+    GENERIC = 5       ///< Any other layout, datatype-aware
+};
+
+/**
+ * @brief Get human-readable name for a cloud layout
+ */
+inline const char* getCloudLayoutName(CloudLayout layout) {
+    switch (layout) {
+        case CloudLayout::NONE:        return "NONE";
+        case CloudLayout::XYZ:         return "XYZ";
+        case CloudLayout::XYZI:        return "XYZI";
+        case CloudLayout::XYZI_NORMAL: return "XYZI_NORMAL";
+        case CloudLayout::XYZIRT:      return "XYZIRT";
+        case CloudLayout::GENERIC:     return "GENERIC";
+    }
+    return "UNKNOWN";
+}
+
+namespace detail {
+
+/**
+ * @brief Compile-time description of a fixed point layout (-1 = absent)
+ * Ring is uint16, all other channels float32.
+ */
+template <CloudLayout Id, uint32_t Step, int X, int Y, int Z, int I, int Ring, int Time>
+struct FixedCloudLayout {
+    static constexpr CloudLayout id = Id;
+    static constexpr uint32_t step = Step;
+    static constexpr int x = X;
+    static constexpr int y = Y;
+    static constexpr int z = Z;
+    static constexpr int intensity = I;
+    static constexpr int ring = Ring;
+    static constexpr int time = Time;
+};
+
+using LayoutXYZ = FixedCloudLayout<CloudLayout::XYZ, 16, 0, 4, 8, -1, -1, -1>;
+using LayoutXYZI = FixedCloudLayout<CloudLayout::XYZI, 32, 0, 4, 8, 16, -1, -1>;
+using LayoutXYZINormal = FixedCloudLayout<CloudLayout::XYZI_NORMAL, 48, 0, 4, 8, 32, -1, -1>;
+using LayoutXYZIRT = FixedCloudLayout<CloudLayout::XYZIRT, 32, 0, 4, 8, 16, 20, 24>;
+
+/// True if the view has a field `name` of `type` at `offset` (or offset < 0 and no such field)
+inline bool fieldAt(const PointCloudView& view, const char* name, int offset, PointFieldType type) {
+    const auto* field = view.findField(name);
+    if (offset < 0) return field == nullptr;
+    return field && static_cast<int>(field->offset) == offset &&
+           field->datatype == static_cast<uint8_t>(type);
+}
+
+template <class Layout>
+inline bool matchesLayout(const PointCloudView& view) {
+    return view.pointStep() == Layout::step &&
+           fieldAt(view, "x", Layout::x, PointFieldType::FLOAT32) &&
+           fieldAt(view, "y", Layout::y, PointFieldType::FLOAT32) &&
+           fieldAt(view, "z", Layout::z, PointFieldType::FLOAT32) &&
+           fieldAt(view, "intensity", Layout::intensity, PointFieldType::FLOAT32) &&
+           fieldAt(view, "ring", Layout::ring, PointFieldType::UINT16) &&
+           fieldAt(view, "time", Layout::time, PointFieldType::FLOAT32);
+}
+
+/**
+ * @brief Fixed-offset kernel for Layout
+ *
+ * Decodes n points into out[dst, dst + n); out must already be sized with
+ * the layout's has_ flags set. x/y/z/intensity go through the SIMD
+ * kernels; the scalar level and the ring/time channels use loops whose
+ * stride and offsets are constants.
+ */
+template <class Layout>
+inline void decodeFixed(const uint8_t* data, size_t n, PointCloudSoA& out, SimdLevel level, size_t dst = 0) {
+    constexpr size_t step = Layout::step;
+
+    if (level == SimdLevel::SCALAR) {
+        for (size_t i = 0; i < n; ++i) {
+            const uint8_t* ptr = data + i * step;
+            out.x[dst + i] = loadUnaligned<float>(ptr + Layout::x);
+            out.y[dst + i] = loadUnaligned<float>(ptr + Layout::y);
+            out.z[dst + i] = loadUnaligned<float>(ptr + Layout::z);
+            if constexpr (Layout::intensity >= 0) {
+                out.intensity[dst + i] = loadUnaligned<float>(ptr + Layout::intensity);
+            } else {
+                out.intensity[dst + i] = 0.0f;
+            }
+        }
+    } else {
+        SoAFieldOffsets off;
+        off.step = step;
+        off.x = Layout::x;
+        off.y = Layout::y;
+        off.z = Layout::z;
+        off.intensity = Layout::intensity;
+        decodeSoA(data, off, n, out, level, dst);
+    }
+
+    if constexpr (Layout::ring >= 0) {
+        for (size_t i = 0; i < n; ++i) {
+            out.ring[dst + i] = loadUnaligned<uint16_t>(data + i * step + Layout::ring);
+        }
+    }
+    if constexpr (Layout::time >= 0) {
+        for (size_t i = 0; i < n; ++i) {
+            out.time[dst + i] = loadUnaligned<float>(data + i * step + Layout::time);
+        }
+    }
+}
+
+/// Location and datatype of one channel for the generic path
+struct GenericChannel {
+    int offset = -1;
+    uint8_t datatype = 0;
+
+    bool present() const { return offset >= 0; }
+};
+
+template <typename Src, typename Dst>
+inline void decodeColumnAs(const uint8_t* data, size_t step, int offset, size_t n, Dst* dst) {
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = static_cast<Dst>(loadUnaligned<Src>(data + i * step + offset));
+    }
+}
+
+/**
+ * @brief Convert one channel to Dst, dispatching on datatype once per column
+ */
+template <typename Dst>
+inline void decodeColumn(const uint8_t* data, size_t step, const GenericChannel& ch,
+                         size_t n, Dst* dst) {
+    switch (static_cast<PointFieldType>(ch.datatype)) {
+        case PointFieldType::INT8:    decodeColumnAs<int8_t>(data, step, ch.offset, n, dst); break;
+        case PointFieldType::UINT8:   decodeColumnAs<uint8_t>(data, step, ch.offset, n, dst); break;
+        case PointFieldType::INT16:   decodeColumnAs<int16_t>(data, step, ch.offset, n, dst); break;
+        case PointFieldType::UINT16:  decodeColumnAs<uint16_t>(data, step, ch.offset, n, dst); break;
+        case PointFieldType::INT32:   decodeColumnAs<int32_t>(data, step, ch.offset, n, dst); break;
+        case PointFieldType::UINT32:  decodeColumnAs<uint32_t>(data, step, ch.offset, n, dst); break;
+        case PointFieldType::FLOAT32: decodeColumnAs<float>(data, step, ch.offset, n, dst); break;
+        case PointFieldType::FLOAT64: decodeColumnAs<double>(data, step, ch.offset, n, dst); break;
+        default:
+            for (size_t i = 0; i < n; ++i) dst[i] = Dst{};
+            break;
+    }
+}
+
+/// Byte size of a PointField datatype (0 if unknown)
+inline size_t pointFieldTypeSize(uint8_t datatype) {
+    switch (static_cast<PointFieldType>(datatype)) {
+        case PointFieldType::INT8:
+        case PointFieldType::UINT8:   return 1;
+        case PointFieldType::INT16:
+        case PointFieldType::UINT16:  return 2;
+        case PointFieldType::INT32:
+        case PointFieldType::UINT32:
+        case PointFieldType::FLOAT32: return 4;
+        case PointFieldType::FLOAT64: return 8;
+    }
+    return 0;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Stateful PointCloud2 decoder that picks its kernel once per layout
+ *
+ * Keep one instance per topic. The first decode() matches the message
+ * against the fixed layouts (string compares happen only here); later
+ * calls compare a numeric signature of the layout and jump straight to the
+ * selected kernel.
+ *
+ * With a CloudFilter, the message is decoded in L1-sized blocks and only
+ * accepted points are written to the output, so filtering costs no extra
+ * pass over the full cloud.
+ *
+ * A CloudStatsCollector passed to decode() is fed each block right after
+ * it is decoded, while it is still in cache; it sees every point of the
+ * message, including those the filter rejects.
+ *
+ * Messages with at least parallelThreshold() points are split into
+ * contiguous point ranges that are decoded concurrently on a WorkerPool,
+ * each straight into its slice of the preallocated output. Smaller
+ * messages stay on the calling thread, as do all chunks while the pool is
+ * busy with another thread's job (e.g. scan matching on the shared pool).
+ *
+ * @code
+ * raisin_sdk::PointCloudDecoder decoder;
+ * raisin_sdk::PointCloudSoA cloud;
+ * if (decoder.decode(view, cloud) && cloud.has_ring) { ... }
+ * @endcode
+ */
+class PointCloudDecoder {
+public:
+    /// Point count from which decode() splits work across threads by default
+    static constexpr size_t kDefaultParallelThreshold = 262144;
+
+    explicit PointCloudDecoder(SimdLevel level = detail::detectSimdLevel())
+        : level_(level) {}
+
+    /**
+     * @brief Configure chunked parallel decode
+     * @param threshold Messages with fewer points decode on the calling thread (0 = never split)
+     * @param pool      Pool to run chunks on; WorkerPool::shared() if null, created on first use
+     */
+    void setParallel(size_t threshold, std::shared_ptr<WorkerPool> pool = nullptr) {
+        parallelThreshold_ = threshold;
+        pool_ = std::move(pool);
+    }
+
+    /// Change only the split threshold, keeping the pool
+    void setParallelThreshold(size_t threshold) { parallelThreshold_ = threshold; }
+
+    size_t parallelThreshold() const { return parallelThreshold_; }
+
+    /**
+     * @brief Decode view into out, reusing out's capacity
+     * @param filter Optional filter; rejected points are not written
+     * @param stats  Optional collector (begun by the caller) fed with every point
+     * @return false if the message has no usable x/y/z fields
+     */
+    bool decode(const PointCloudView& view, PointCloudSoA& out,
+                const CloudFilter* filter = nullptr, CloudStatsCollector* stats = nullptr) {
+        ensureLayout(view);
+        if (layout_ == CloudLayout::NONE) {
+            out.has_intensity = out.has_ring = out.has_time = false;
+            out.clear();
+            return false;
+        }
+
+        const size_t n = view.size();
+        prepareOutput(out, n);
+        const size_t chunks = numChunks(n);
+        prepareStats(stats, chunks);
+        if (filter && filter->active()) {
+            decodeFiltered(view, out, *filter, chunks, stats);
+        } else {
+            const uint8_t* data = view.data();
+            const size_t step = view.pointStep();
+            forEachChunk(n, chunks, [&](size_t c, size_t begin, size_t end) {
+                CloudStatsCollector* partial = chunkStats(stats, chunks, c);
+                if (!partial) {
+                    (this->*decodeFn_)(data + begin * step, end - begin, out, begin);
+                    return;
+                }
+                // Block by block so the statistics read points that are still in L1
+                for (size_t block = begin; block < end; block += kFilterBlock) {
+                    const size_t count = std::min(kFilterBlock, end - block);
+                    (this->*decodeFn_)(data + block * step, count, out, block);
+                    partial->add(out.x.data() + block, out.y.data() + block, out.z.data() + block, count);
+                }
+            });
+        }
+        mergeStats(stats, chunks);
+        return true;
+    }
+
+    /**
+     * @brief Decode float32 x/y/z into an array of points, reusing out's capacity
+     * Split across threads like the SoA overload.
+     * @return false if the message has no float32 x/y/z fields
+     */
+    bool decode(const PointCloudView& view, std::vector<Point3D>& out,
+                const CloudFilter* filter = nullptr, CloudStatsCollector* stats = nullptr) {
+        if (!view.hasXYZ()) {
+            out.clear();
+            return false;
+        }
+
+        const size_t n = view.size();
+        out.resize(n);
+        const size_t chunks = numChunks(n);
+        prepareStats(stats, chunks);
+        if (!filter || !filter->active()) {
+            forEachChunk(n, chunks, [&](size_t c, size_t begin, size_t end) {
+                CloudStatsCollector* partial = chunkStats(stats, chunks, c);
+                // Block by block so the statistics read points that are still in L1
+                for (size_t block = begin; block < end; block += kFilterBlock) {
+                    const size_t count = std::min(kFilterBlock, end - block);
+                    for (size_t i = block; i < block + count; ++i) out[i] = view.point(i);
+                    if (partial) partial->add(out.data() + block, count);
+                }
+            });
+            mergeStats(stats, chunks);
+            return true;
+        }
+
+        chunkKept_.assign(chunks, 0);
+        forEachChunk(n, chunks, [&](size_t c, size_t begin, size_t end) {
+            CloudStatsCollector* partial = chunkStats(stats, chunks, c);
+            size_t kept = begin;
+            for (size_t block = begin; block < end; block += kFilterBlock) {
+                // Decode the block in place first: kept never passes block, so
+                // out[block, block + count) is free
+                const size_t count = std::min(kFilterBlock, end - block);
+                for (size_t i = block; i < block + count; ++i) out[i] = view.point(i);
+                if (partial) partial->add(out.data() + block, count);
+                for (size_t i = block; i < block + count; ++i) {
+                    if (filter->accept(out[i])) out[kept++] = out[i];
+                }
+            }
+            chunkKept_[c] = kept - begin;
+        });
+        out.resize(compactChunks(n, chunks, [&out](size_t from, size_t count, size_t to) {
+            std::copy(out.begin() + from, out.begin() + from + count, out.begin() + to);
+        }));
+        mergeStats(stats, chunks);
+        return true;
+    }
+
+    /// Layout chosen for the most recent message
+    CloudLayout layout() const { return layout_; }
+
+    /**
+     * @brief True if the SoA decode of view fills x/y/z only (no intensity, ring or time)
+     * Selects and caches the layout like decode() does.
+     */
+    bool positionsOnly(const PointCloudView& view) {
+        ensureLayout(view);
+        return layout_ != CloudLayout::NONE && !hasIntensity_ && !hasRing_ && !hasTime_;
+    }
+
+    /// Forget the cached layout (next decode() re-inspects the fields)
+    void reset() {
+        layout_ = CloudLayout::NONE;
+        signature_ = 0;
+        selected_ = false;
+        decodeFn_ = nullptr;
+    }
+
+private:
+    /// Decodes n points from data into out[dst, dst + n)
+    using DecodeFn = void (PointCloudDecoder::*)(const uint8_t*, size_t, PointCloudSoA&, size_t) const;
+
+    /// Points per block in filtered decode (4 float channels fit in L1)
+    static constexpr size_t kFilterBlock = 1024;
+
+    SimdLevel level_;
+    CloudLayout layout_ = CloudLayout::NONE;
+    uint64_t signature_ = 0;
+    bool selected_ = false;
+    DecodeFn decodeFn_ = nullptr;
+    bool hasIntensity_ = false;
+    bool hasRing_ = false;
+    bool hasTime_ = false;
+
+    // Generic path channels
+    detail::GenericChannel x_, y_, z_, intensity_, ring_, time_;
+    size_t step_ = 0;
+
+    size_t parallelThreshold_ = kDefaultParallelThreshold;
+    std::shared_ptr<WorkerPool> pool_;      ///< WorkerPool::shared() if not given, on first large message
+
+    std::vector<PointCloudSoA> blocks_;     ///< Per-chunk scratch block for filtered decode
+    std::vector<size_t> chunkKept_;         ///< Points kept by each chunk of a filtered decode
+    std::vector<CloudStatsCollector> statsChunks_;   ///< Per-chunk partial statistics
+
+    /// FNV-1a over point_step and each field's offset/datatype/count (no strings)
+    static uint64_t computeSignature(const PointCloudView& view) {
+        uint64_t hash = 1469598103934665603ull;
+        auto mix = [&hash](uint64_t v) {
+            hash ^= v;
+            hash *= 1099511628211ull;
+        };
+        mix(view.pointStep());
+        if (!view.message()) return hash;
+        mix(view.message()->fields.size());
+        for (const auto& field : view.message()->fields) {
+            mix(field.offset);
+            mix(field.datatype);
+            mix(field.count);
+        }
+        return hash;
+    }
+
+    /// Number of ranges to split n points into (1 = stay on the calling thread)
+    size_t numChunks(size_t n) {
+        if (parallelThreshold_ == 0 || n < parallelThreshold_) return 1;
+        if (!pool_) pool_ = WorkerPool::shared();
+        return std::max<size_t>(1, std::min(pool_->concurrency(), n / detail::kSoAChunkAlign));
+    }
+
+    /**
+     * @brief Run fn(chunk, begin, end) over chunks contiguous ranges of [0, n)
+     * Range starts are multiples of kSoAChunkAlign so SIMD stores stay aligned.
+     */
+    template <typename Fn>
+    void forEachChunk(size_t n, size_t chunks, const Fn& fn) {
+        if (chunks <= 1) {
+            fn(0, 0, n);
+            return;
+        }
+        const size_t align = detail::kSoAChunkAlign;
+        const size_t chunk = ((n + chunks - 1) / chunks + align - 1) / align * align;
+        // Decode runs on the message thread: never wait behind another component's job
+        pool_->tryParallelFor(chunks, [&](size_t c) {
+            const size_t begin = std::min(n, c * chunk);
+            const size_t end = std::min(n, begin + chunk);
+            fn(c, begin, end);
+        });
+    }
+
+    /// Give every chunk an empty copy of stats (single-chunk decodes feed stats directly)
+    void prepareStats(const CloudStatsCollector* stats, size_t chunks) {
+        if (!stats || chunks <= 1) return;
+        statsChunks_.resize(chunks);
+        for (auto& partial : statsChunks_) {
+            partial = *stats;
+            partial.clear();
+        }
+    }
+
+    CloudStatsCollector* chunkStats(CloudStatsCollector* stats, size_t chunks, size_t c) {
+        if (!stats) return nullptr;
+        return chunks <= 1 ? stats : &statsChunks_[c];
+    }
+
+    void mergeStats(CloudStatsCollector* stats, size_t chunks) const {
+        if (!stats || chunks <= 1) return;
+        for (size_t c = 0; c < chunks; ++c) stats->merge(statsChunks_[c]);
+    }
+
+    /// Slide each chunk's kept points down behind the previous chunk's; returns the total
+    template <typename MoveFn>
+    size_t compactChunks(size_t n, size_t chunks, const MoveFn& move) const {
+        if (chunks <= 1) return chunkKept_.empty() ? 0 : chunkKept_[0];
+        const size_t align = detail::kSoAChunkAlign;
+        const size_t chunk = ((n + chunks - 1) / chunks + align - 1) / align * align;
+        size_t total = 0;
+        for (size_t c = 0; c < chunks; ++c) {
+            const size_t begin = std::min(n, c * chunk);
+            if (begin != total && chunkKept_[c] > 0) move(begin, chunkKept_[c], total);
+            total += chunkKept_[c];
+        }
+        return total;
+    }
+
+    void prepareOutput(PointCloudSoA& out, size_t n) const {
+        out.has_intensity = hasIntensity_;
+        out.has_ring = hasRing_;
+        out.has_time = hasTime_;
+        out.resize(n);
+    }
+
+    template <class Layout>
+    void decodeFixedFn(const uint8_t* data, size_t n, PointCloudSoA& out, size_t dst) const {
+        detail::decodeFixed<Layout>(data, n, out, level_, dst);
+    }
+
+    template <class Layout>
+    bool trySelect(const PointCloudView& view) {
+        if (!detail::matchesLayout<Layout>(view)) return false;
+        layout_ = Layout::id;
+        decodeFn_ = &PointCloudDecoder::decodeFixedFn<Layout>;
+        hasIntensity_ = Layout::intensity >= 0;
+        hasRing_ = Layout::ring >= 0;
+        hasTime_ = Layout::time >= 0;
+        return true;
+    }
+
+    detail::GenericChannel findChannel(const PointCloudView& view,
+                                       std::initializer_list<const char*> names) const {
+        detail::GenericChannel ch;
+        for (const char* name : names) {
+            const auto* field = view.findField(name);
+            if (!field) continue;
+            const size_t size = detail::pointFieldTypeSize(field->datatype);
+            if (size == 0 || field->offset + size > view.pointStep()) continue;
+            ch.offset = static_cast<int>(field->offset);
+            ch.datatype = field->datatype;
+            break;
+        }
+        return ch;
+    }
+
+    void ensureLayout(const PointCloudView& view) {
+        const uint64_t signature = computeSignature(view);
+        if (!selected_ || signature != signature_) {
+            selectLayout(view);
+            signature_ = signature;
+            selected_ = true;
+        }
+    }
+
+    void selectLayout(const PointCloudView& view) {
+        layout_ = CloudLayout::NONE;
+        decodeFn_ = nullptr;
+        if (view.pointStep() == 0) return;
+
+        if (trySelect<detail::LayoutXYZ>(view) ||
+            trySelect<detail::LayoutXYZI>(view) ||
+            trySelect<detail::LayoutXYZINormal>(view) ||
+            trySelect<detail::LayoutXYZIRT>(view)) {
+            return;
+        }
+
+        x_ = findChannel(view, {"x"});
+        y_ = findChannel(view, {"y"});
+        z_ = findChannel(view, {"z"});
+        if (!x_.present() || !y_.present() || !z_.present()) return;
+
+        intensity_ = findChannel(view, {"intensity", "reflectivity"});
+        ring_ = findChannel(view, {"ring"});
+        time_ = findChannel(view, {"time", "t", "timestamp"});
+
+        step_ = view.pointStep();
+        layout_ = CloudLayout::GENERIC;
+        decodeFn_ = &PointCloudDecoder::decodeGeneric;
+        hasIntensity_ = intensity_.present();
+        hasRing_ = ring_.present();
+        hasTime_ = time_.present();
+    }
+
+    void decodeGeneric(const uint8_t* data, size_t n, PointCloudSoA& out, size_t dst) const {
+        const size_t step = step_;
+
+        detail::decodeColumn(data, step, x_, n, out.x.data() + dst);
+        detail::decodeColumn(data, step, y_, n, out.y.data() + dst);
+        detail::decodeColumn(data, step, z_, n, out.z.data() + dst);
+        if (intensity_.present()) {
+            detail::decodeColumn(data, step, intensity_, n, out.intensity.data() + dst);
+        } else {
+            std::fill(out.intensity.begin() + dst, out.intensity.begin() + dst + n, 0.0f);
+        }
+        if (ring_.present()) detail::decodeColumn(data, step, ring_, n, out.ring.data() + dst);
+        if (time_.present()) detail::decodeColumn(data, step, time_, n, out.time.data() + dst);
+    }
+
+    /**
+     * @brief Decode block by block into scratch, copying accepted points to out
+     * Each chunk compacts into the front of its own output range; the ranges
+     * are then slid together.
+     */
+    void decodeFiltered(const PointCloudView& view, PointCloudSoA& out, const CloudFilter& filter,
+                        size_t chunks, CloudStatsCollector* stats) {
+        const uint8_t* data = view.data();
+        const size_t step = view.pointStep();
+        const size_t n = view.size();
+        if (blocks_.size() < chunks) blocks_.resize(chunks);
+        chunkKept_.assign(chunks, 0);
+
+        forEachChunk(n, chunks, [&](size_t c, size_t chunkBegin, size_t chunkEnd) {
+            PointCloudSoA& block = blocks_[c];
+            CloudStatsCollector* partial = chunkStats(stats, chunks, c);
+            prepareOutput(block, kFilterBlock);
+            size_t kept = chunkBegin;
+            for (size_t begin = chunkBegin; begin < chunkEnd; begin += kFilterBlock) {
+                const size_t count = std::min(kFilterBlock, chunkEnd - begin);
+                (this->*decodeFn_)(data + begin * step, count, block, 0);
+                if (partial) partial->add(block.x.data(), block.y.data(), block.z.data(), count);
+
+                for (size_t j = 0; j < count; ++j) {
+                    if (!filter.accept(block.x[j], block.y[j], block.z[j])) continue;
+                    out.x[kept] = block.x[j];
+                    out.y[kept] = block.y[j];
+                    out.z[kept] = block.z[j];
+                    out.intensity[kept] = block.intensity[j];
+                    if (out.has_ring) out.ring[kept] = block.ring[j];
+                    if (out.has_time) out.time[kept] = block.time[j];
+                    ++kept;
+                }
+            }
+            chunkKept_[c] = kept - chunkBegin;
+        });
+
+        out.resize(compactChunks(n, chunks, [&out](size_t from, size_t count, size_t to) {
+            auto slide = [&](auto& channel) {
+                std::copy(channel.begin() + from, channel.begin() + from + count, channel.begin() + to);
+            };
+            slide(out.x);
+            slide(out.y);
+            slide(out.z);
+            slide(out.intensity);
+            if (out.has_ring) slide(out.ring);
+            if (out.has_time) slide(out.time);
+        }));
+    }
+};
+
+}  // namespace raisin_sdk
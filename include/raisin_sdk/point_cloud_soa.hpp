@@ -0,0 +1,301 @@
+/**
+ * @file point_cloud_soa.hpp
+ * @brief Structure-of-arrays point cloud and SIMD PointCloud2 decoder
+ *
+ * PointCloudSoA stores x/y/z/intensity in separate 64-byte aligned arrays,
+ * which downstream filters and distance checks vectorize cleanly. The
+ * decoder picks an AVX2 or SSE4.1 kernel at runtime and falls back to a
+ * scalar loop on other CPUs.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define RAISIN_SDK_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+#include "raisin_sdk/point_cloud.hpp"
+
+namespace raisin_sdk {
+
+namespace detail {
+
+/**
+ * @brief std::allocator replacement returning Alignment-byte aligned storage
+ */
+template <typename T, size_t Alignment = 64>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T* p, size_t) {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+};
+
+}  // namespace detail
+
+/// Vector whose data() is 64-byte aligned
+template <typename T>
+using AlignedVector = std::vector<T, detail::AlignedAllocator<T, 64>>;
+
+/**
+ * @brief Point cloud stored as separate aligned channel arrays
+ *
+ * Reuse one instance across frames: resize() keeps capacity, so decoding
+ * into it does not allocate once it has grown to the largest frame.
+ */
+struct PointCloudSoA {
+    AlignedVector<float> x;
+    AlignedVector<float> y;
+    AlignedVector<float> z;
+    AlignedVector<float> intensity;   ///< Zero-filled if the message has no intensity field
+    AlignedVector<uint16_t> ring;     ///< Laser ring index (empty unless has_ring)
+    AlignedVector<double> time;       ///< Per-point time field as sent by the sensor (empty unless has_time)
+    bool has_intensity = false;       ///< Whether intensity came from the message
+    bool has_ring = false;            ///< Whether ring is populated
+    bool has_time = false;            ///< Whether time is populated
+
+    size_t size() const { return x.size(); }
+    bool empty() const { return x.empty(); }
+
+    /// Resize all channels; ring/time only when their has_ flag is set
+    void resize(size_t n) {
+        x.resize(n);
+        y.resize(n);
+        z.resize(n);
+        intensity.resize(n);
+        ring.resize(has_ring ? n : 0);
+        time.resize(has_time ? n : 0);
+    }
+
+    void clear() { resize(0); }
+
+    Point3D point(size_t i) const { return {x[i], y[i], z[i]}; }
+};
+
+/**
+ * @brief Instruction set used by the SoA decode kernels
+ */
+enum class SimdLevel {
+    SCALAR = 0,   ///< Portable scalar loop
+    SSE41 = 1,    ///< 4-point load + transpose (x/y/z contiguous)
+    AVX2 = 2      ///< 8-point gather
+};
+
+namespace detail {
+
+/// Byte offsets of the channels decoded into PointCloudSoA (-1 = absent)
+struct SoAFieldOffsets {
+    size_t step = 0;
+    int x = -1;
+    int y = -1;
+    int z = -1;
+    int intensity = -1;
+};
+
+/**
+ * @brief Best SIMD level supported by the running CPU (detected once)
+ */
+inline SimdLevel detectSimdLevel() {
+#ifdef RAISIN_SDK_X86_SIMD
+    static const SimdLevel level = []() {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+        if (__builtin_cpu_supports("sse4.1")) return SimdLevel::SSE41;
+        return SimdLevel::SCALAR;
+    }();
+    return level;
+#else
+    return SimdLevel::SCALAR;
+#endif
+}
+
+/// Output offsets that keep every SoA channel 64-byte aligned (16 floats)
+constexpr size_t kSoAChunkAlign = 16;
+
+/// Scalar kernel for points [begin, end), written at out[dst + i]
+inline void decodeSoAScalar(const uint8_t* data, const SoAFieldOffsets& off,
+                            size_t begin, size_t end, PointCloudSoA& out, size_t dst = 0) {
+    for (size_t i = begin; i < end; ++i) {
+        const uint8_t* ptr = data + i * off.step;
+        out.x[dst + i] = loadUnaligned<float>(ptr + off.x);
+        out.y[dst + i] = loadUnaligned<float>(ptr + off.y);
+        out.z[dst + i] = loadUnaligned<float>(ptr + off.z);
+        out.intensity[dst + i] = off.intensity >= 0 ? loadUnaligned<float>(ptr + off.intensity) : 0.0f;
+    }
+}
+
+#ifdef RAISIN_SDK_X86_SIMD
+
+/// SSE4.1 usable: x/y/z adjacent and a 16-byte load from x stays inside the point
+inline bool sseLayoutSupported(const SoAFieldOffsets& off) {
+    return off.y == off.x + 4 && off.z == off.x + 8 &&
+           static_cast<size_t>(off.x) + 16 <= off.step;
+}
+
+/**
+ * @brief SSE4.1 kernel: load 4 points' x/y/z/next as rows, transpose to columns
+ * Returns the index of the first point not decoded.
+ */
+__attribute__((target("sse4.1")))
+inline size_t decodeSoASse41(const uint8_t* data, const SoAFieldOffsets& off,
+                             size_t count, PointCloudSoA& out, size_t dst) {
+    const size_t step = off.step;
+    float* outX = out.x.data() + dst;
+    float* outY = out.y.data() + dst;
+    float* outZ = out.z.data() + dst;
+    float* outI = out.intensity.data() + dst;
+    const bool intensityInRow = off.intensity == off.x + 12;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const uint8_t* p0 = data + i * step;
+        const uint8_t* p1 = p0 + step;
+        const uint8_t* p2 = p1 + step;
+        const uint8_t* p3 = p2 + step;
+
+        __m128 r0 = _mm_loadu_ps(reinterpret_cast<const float*>(p0 + off.x));
+        __m128 r1 = _mm_loadu_ps(reinterpret_cast<const float*>(p1 + off.x));
+        __m128 r2 = _mm_loadu_ps(reinterpret_cast<const float*>(p2 + off.x));
+        __m128 r3 = _mm_loadu_ps(reinterpret_cast<const float*>(p3 + off.x));
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+        // Output arrays are 64-byte aligned; dst and i are multiples of 4
+        _mm_store_ps(outX + i, r0);
+        _mm_store_ps(outY + i, r1);
+        _mm_store_ps(outZ + i, r2);
+
+        if (intensityInRow) {
+            _mm_store_ps(outI + i, r3);
+        } else if (off.intensity >= 0) {
+            const __m128 v = _mm_setr_ps(loadUnaligned<float>(p0 + off.intensity),
+                                         loadUnaligned<float>(p1 + off.intensity),
+                                         loadUnaligned<float>(p2 + off.intensity),
+                                         loadUnaligned<float>(p3 + off.intensity));
+            _mm_store_ps(outI + i, v);
+        } else {
+            _mm_store_ps(outI + i, _mm_setzero_ps());
+        }
+    }
+    return i;
+}
+
+/**
+ * @brief AVX2 kernel: gather 8 points per channel with a stride index vector
+ * Returns the index of the first point not decoded.
+ */
+__attribute__((target("avx2")))
+inline size_t decodeSoAAvx2(const uint8_t* data, const SoAFieldOffsets& off,
+                            size_t count, PointCloudSoA& out, size_t dst) {
+    float* outX = out.x.data() + dst;
+    float* outY = out.y.data() + dst;
+    float* outZ = out.z.data() + dst;
+    float* outI = out.intensity.data() + dst;
+    const int step = static_cast<int>(off.step);
+    const __m256i index = _mm256_setr_epi32(0, step, 2 * step, 3 * step,
+                                            4 * step, 5 * step, 6 * step, 7 * step);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const uint8_t* base = data + i * off.step;
+        const __m256 vx = _mm256_i32gather_ps(reinterpret_cast<const float*>(base + off.x), index, 1);
+        const __m256 vy = _mm256_i32gather_ps(reinterpret_cast<const float*>(base + off.y), index, 1);
+        const __m256 vz = _mm256_i32gather_ps(reinterpret_cast<const float*>(base + off.z), index, 1);
+        const __m256 vi = off.intensity >= 0
+            ? _mm256_i32gather_ps(reinterpret_cast<const float*>(base + off.intensity), index, 1)
+            : _mm256_setzero_ps();
+
+        _mm256_store_ps(outX + i, vx);
+        _mm256_store_ps(outY + i, vy);
+        _mm256_store_ps(outZ + i, vz);
+        _mm256_store_ps(outI + i, vi);
+    }
+    return i;
+}
+
+#endif  // RAISIN_SDK_X86_SIMD
+
+/**
+ * @brief Decode float32 channels into out (already resized) with a given kernel
+ *
+ * Points are written to [dst, dst + count). The vector kernels need dst to
+ * keep the output aligned (a multiple of kSoAChunkAlign); other values
+ * fall back to the scalar kernel. Unsupported levels or layouts degrade
+ * to the next lower kernel.
+ */
+inline void decodeSoA(const uint8_t* data, const SoAFieldOffsets& off, size_t count,
+                      PointCloudSoA& out, SimdLevel level, size_t dst = 0) {
+    size_t done = 0;
+#ifdef RAISIN_SDK_X86_SIMD
+    if (dst % kSoAChunkAlign == 0) {
+        // Gather indices are 32-bit; absurd point_step values take the scalar path
+        if (level == SimdLevel::AVX2 && off.step <= (1u << 27)) {
+            done = decodeSoAAvx2(data, off, count, out, dst);
+        } else if (level >= SimdLevel::SSE41 && sseLayoutSupported(off)) {
+            done = decodeSoASse41(data, off, count, out, dst);
+        }
+    }
+#else
+    (void)level;
+#endif
+    decodeSoAScalar(data, off, done, count, out, dst);
+}
+
+}  // namespace detail
+
+/**
+ * @brief Decode a PointCloud2 view into structure-of-arrays form
+ *
+ * Reads float32 x/y/z and, if present, float32 "intensity". Capacity of
+ * out is reused between calls. Use PointCloudDecoder to also get ring and
+ * time channels and to skip the field lookup on every frame.
+ *
+ * @param view  Cloud to decode
+ * @param out   Destination (resized to view.size())
+ * @param level Kernel to use; defaults to the best the CPU supports
+ * @return false if the cloud has no float32 x/y/z fields
+ */
+inline bool decodePointCloudSoA(const PointCloudView& view, PointCloudSoA& out,
+                                SimdLevel level = detail::detectSimdLevel()) {
+    out.has_ring = false;
+    out.has_time = false;
+    if (!view.hasXYZ()) {
+        out.has_intensity = false;
+        out.clear();
+        return false;
+    }
+
+    detail::SoAFieldOffsets off;
+    off.step = view.pointStep();
+    off.x = view.xOffset();
+    off.y = view.yOffset();
+    off.z = view.zOffset();
+    if (view.field<float>("intensity").valid()) {
+        off.intensity = static_cast<int>(view.findField("intensity")->offset);
+    }
+
+    out.resize(view.size());
+    out.has_intensity = off.intensity >= 0;
+    detail::decodeSoA(view.data(), off, view.size(), out, level);
+    return true;
+}
+
+}  // namespace raisin_sdk
@@ -18,6 +18,10 @@
 #include <mutex>
 #include <atomic>
 #include <algorithm>
+#include <cstring>
+#include <utility>
+#include <optional>
+#include <limits>
 
 #ifndef _WIN32
 #include <ifaddrs.h>
@@ -48,46 +52,29 @@
 #include "geometry_msgs/msg/pose.hpp"
 #include "nav_msgs/msg/odometry.hpp"
 
-namespace raisin_sdk {
-
-/**
- * @brief CiA402 Status Word values from motor driver
- * These values indicate the motor driver state, not error codes.
- */
-enum class CiA402StatusWord : uint16_t {
-    NOT_READY_TO_SWITCH_ON = 0,   ///< Initial state - driver not ready (**error**)
-    FAULT = 8,                     ///< Fault detected (**error**)
-    READY_TO_SWITCH_ON = 33,       ///< Driver ready (normal state before enable)
-    SWITCHED_ON = 35,              ///< Driver switched on (normal)
-    OPERATION_ENABLED = 39,        ///< Motor operational (normal running state)
-    ECAT_CONN_ERROR = 99           ///< EtherCAT connection error (**error**)
-};
-
-/**
- * @brief Check if status word indicates an error
- * Error states: NOT_READY(0), FAULT(8), ECAT_ERROR(99)
- * Normal states: READY(33), SWITCHED_ON(35), ENABLED(39)
- */
-inline bool isActuatorStatusError(uint16_t status) {
-    return status == static_cast<uint16_t>(CiA402StatusWord::FAULT) ||
-           status == static_cast<uint16_t>(CiA402StatusWord::ECAT_CONN_ERROR) ||
-           status == static_cast<uint16_t>(CiA402StatusWord::NOT_READY_TO_SWITCH_ON);
-}
+#include "raisin_sdk/robot_state.hpp"
+#include "raisin_sdk/point_cloud.hpp"
+#include "raisin_sdk/point_cloud_soa.hpp"
+#include "raisin_sdk/point_cloud_decoder.hpp"
+#include "raisin_sdk/snapshot.hpp"
+#include "raisin_sdk/voxel_grid.hpp"
+#include "raisin_sdk/cloud_filter.hpp"
+#include "raisin_sdk/local_map.hpp"
+#include "raisin_sdk/spatial_index.hpp"
+#include "raisin_sdk/costmap.hpp"
+#include "raisin_sdk/ground_segmentation.hpp"
+#include "raisin_sdk/range_image.hpp"
+#include "raisin_sdk/normals.hpp"
+#include "raisin_sdk/executor.hpp"
+#include "raisin_sdk/cloud_recorder.hpp"
+#include "raisin_sdk/cloud_stats.hpp"
+#include "raisin_sdk/pcd_file.hpp"
+#include "raisin_sdk/registration.hpp"
+#include "raisin_sdk/telemetry.hpp"
+#include "raisin_sdk/battery.hpp"
+#include "raisin_sdk/thermal.hpp"
 
-/**
- * @brief Get human-readable name for status word
- */
-inline std::string getActuatorStatusName(uint16_t status) {
-    switch (status) {
-        case 0:  return "NOT_READY";
-        case 8:  return "FAULT";
-        case 33: return "READY";
-        case 35: return "SWITCHED_ON";
-        case 39: return "ENABLED";
-        case 99: return "ECAT_ERROR";
-        default: return "UNKNOWN(" + std::to_string(status) + ")";
-    }
-}
+namespace raisin_sdk {
 
 namespace detail {
 
@@ -253,62 +240,54 @@ struct RefineWaypointsResult {
     std::vector<int32_t> path_node_ids;       ///< Node IDs forming the path
 };
 
-/**
- * @brief Robot state from odometry (map frame)
- */
-struct RobotState {
-    double x = 0.0;        ///< X position in map frame
-    double y = 0.0;        ///< Y position in map frame
-    double z = 0.0;        ///< Z position in map frame
-    double yaw = 0.0;      ///< Yaw angle in radians
-    double vx = 0.0;       ///< Linear velocity X
-    double vy = 0.0;       ///< Linear velocity Y
-    double omega = 0.0;    ///< Angular velocity
-    bool valid = false;    ///< True when odometry is received
-};
+namespace detail {
 
 /**
- * @brief Actuator (motor) information
+ * @brief Immutable actuator name table shared by published state frames
+ * A new table (with the next generation) replaces the old one whenever the
+ * robot reports a different actuator list.
  */
-struct ActuatorInfo {
-    std::string name;           ///< Motor name (e.g., "FR_hip", "FL_thigh")
-    uint16_t status = 0;        ///< CiA402 status word (see CiA402StatusWord enum)
-    double temperature = 0.0;   ///< Motor temperature in Celsius
-    double position = 0.0;      ///< Joint position in radians
-    double velocity = 0.0;      ///< Joint velocity in rad/s
-    double effort = 0.0;        ///< Joint torque in Nm
+struct ActuatorNameTable {
+    uint64_t generation = 0;
+    std::vector<std::string> names;
 };
 
 /**
- * @brief Locomotion state enum values
+ * @brief Frames named by the latest odometry message
+ * parent is the frame the pose is expressed in, child the robot body frame.
  */
-enum class LocomotionState : int32_t {
-    COMM_DISABLED = 0,      ///< Communication disabled
-    COMM_ENABLED = 1,       ///< Communication enabled
-    MOTOR_READY = 2,        ///< Motors ready
-    MOTOR_COMMUTATION = 3,  ///< Motor commutation in progress
-    MOTOR_ENABLED = 4,      ///< Motors enabled
-    IN_TEST_MODE = 5,       ///< Test mode active
-    STANDING_MODE = 6,      ///< Robot is standing
-    IN_CONTROL = 7,         ///< Robot is under control (walking)
-    SITDOWN_MODE = 8,       ///< Robot is sitting down
-    MOTOR_DISABLED = 9      ///< Motors disabled
+struct OdometryFrames {
+    std::string parent;
+    std::string child;
 };
 
 /**
- * @brief Joy listen source type
+ * @brief Full ExtendedRobotState published when it does not fit a frame
+ * version is the SeqLock version of the frame that announces it.
  */
-enum class JoySourceType : int32_t {
-    JOY = 0,           ///< Manual joystick control
-    VEL_CMD = 1,       ///< Autonomous velocity command
-    NUM_SOURCES = 2    ///< No source / disabled
+struct ExtendedStateOverflow {
+    uint64_t version = 0;
+    ExtendedRobotState state;
 };
 
 /**
- * @brief Extended robot state with full information from robot_state topic
+ * @brief Trivially copyable image of ExtendedRobotState for SeqLock publication
+ * Actuator names are not copied: the frame records the generation of the
+ * ActuatorNameTable it was packed against. Robots with more than
+ * kMaxActuators actuators leave the array empty and publish the whole state
+ * as an ExtendedStateOverflow snapshot instead.
  */
-struct ExtendedRobotState {
-    // Position and velocity
+struct ExtendedStateFrame {
+    static constexpr size_t kMaxActuators = 32;   ///< Legs plus arm fit in the frame itself
+
+    struct Actuator {
+        double temperature = 0.0;
+        double position = 0.0;
+        double velocity = 0.0;
+        double effort = 0.0;
+        uint16_t status = 0;
+    };
+
     double x = 0.0;
     double y = 0.0;
     double z = 0.0;
@@ -316,96 +295,125 @@ struct ExtendedRobotState {
     double vx = 0.0;
     double vy = 0.0;
     double omega = 0.0;
-
-    // Locomotion state
-    int32_t locomotion_state = 0;   ///< See LocomotionState enum (0-9)
-
-    // Battery information
-    double voltage = 0.0;           ///< Current battery voltage
-    double current = 0.0;           ///< Current draw in Amps
-    double max_voltage = 0.0;       ///< Maximum voltage
-    double min_voltage = 0.0;       ///< Minimum voltage
-
-    // Temperature
-    double body_temperature = 0.0;  ///< Body temperature in Celsius
-
-    // Joy control state
-    int32_t joy_listen_type = 2;    ///< See JoySourceType enum
-
-    // Actuator states
-    std::vector<ActuatorInfo> actuators;
-
+    int32_t locomotion_state = 0;
+    int32_t joy_listen_type = 2;
+    double voltage = 0.0;
+    double current = 0.0;
+    double max_voltage = 0.0;
+    double min_voltage = 0.0;
+    double body_temperature = 0.0;
     bool valid = false;
-
-    /// Get locomotion state as string
-    std::string getLocomotionStateName() const {
-        static const std::vector<std::string> names = {
-            "COMM_DISABLED", "COMM_ENABLED", "MOTOR_READY",
-            "MOTOR_COMMUTATION", "MOTOR_ENABLED", "IN_TEST_MODE",
-            "STANDING_MODE", "IN_CONTROL", "SITDOWN_MODE", "MOTOR_DISABLED"
-        };
-        if (locomotion_state >= 0 && locomotion_state < static_cast<int32_t>(names.size())) {
-            return names[locomotion_state];
+    uint64_t table_generation = 0;
+    uint64_t actuator_error_mask = 0;
+    uint32_t actuator_count = 0;       ///< Actuators in the message; may exceed kMaxActuators
+    Actuator actuators[kMaxActuators];
+
+    bool overflow() const { return actuator_count > kMaxActuators; }
+
+    void pack(const ExtendedRobotState& s, uint64_t generation) {
+        x = s.x; y = s.y; z = s.z; yaw = s.yaw;
+        vx = s.vx; vy = s.vy; omega = s.omega;
+        locomotion_state = s.locomotion_state;
+        joy_listen_type = s.joy_listen_type;
+        voltage = s.voltage; current = s.current;
+        max_voltage = s.max_voltage; min_voltage = s.min_voltage;
+        body_temperature = s.body_temperature;
+        valid = s.valid;
+        table_generation = generation;
+        actuator_error_mask = s.actuator_error_mask;
+        actuator_count = static_cast<uint32_t>(s.actuators.size());
+        if (overflow()) return;
+        for (uint32_t i = 0; i < actuator_count; ++i) {
+            const ActuatorInfo& src = s.actuators[i];
+            actuators[i].temperature = src.temperature;
+            actuators[i].position = src.position;
+            actuators[i].velocity = src.velocity;
+            actuators[i].effort = src.effort;
+            actuators[i].status = src.status;
         }
-        return "UNKNOWN";
     }
 
-    /// Get joy source type as string
-    std::string getJoySourceName() const {
-        switch (static_cast<JoySourceType>(joy_listen_type)) {
-            case JoySourceType::JOY: return "JOY (Manual)";
-            case JoySourceType::VEL_CMD: return "VEL_CMD (Autonomous)";
-            default: return "NONE";
+    /**
+     * @brief Copy into out (not for overflow frames)
+     * Names are assigned only when they differ, so a reused out does not allocate.
+     * @param table Name table whose generation matches table_generation
+     */
+    void unpack(ExtendedRobotState& out, const ActuatorNameTable* table) const {
+        out.x = x; out.y = y; out.z = z; out.yaw = yaw;
+        out.vx = vx; out.vy = vy; out.omega = omega;
+        out.locomotion_state = locomotion_state;
+        out.joy_listen_type = joy_listen_type;
+        out.voltage = voltage; out.current = current;
+        out.max_voltage = max_voltage; out.min_voltage = min_voltage;
+        out.body_temperature = body_temperature;
+        out.valid = valid;
+        out.actuator_error_mask = actuator_error_mask;
+        out.actuators.resize(actuator_count);
+        for (uint32_t i = 0; i < actuator_count; ++i) {
+            ActuatorInfo& dst = out.actuators[i];
+            const std::string& name = table->names[i];
+            if (dst.name != name) dst.name = name;
+            dst.temperature = actuators[i].temperature;
+            dst.position = actuators[i].position;
+            dst.velocity = actuators[i].velocity;
+            dst.effort = actuators[i].effort;
+            dst.status = actuators[i].status;
         }
     }
+};
 
-    /// Check if robot is standing or walking
-    bool isOperational() const {
-        return locomotion_state == static_cast<int32_t>(LocomotionState::STANDING_MODE) ||
-               locomotion_state == static_cast<int32_t>(LocomotionState::IN_CONTROL);
-    }
+}  // namespace detail
 
-    /// Check if any actuator has an error
-    bool hasActuatorError() const {
-        for (const auto& act : actuators) {
-            if (isActuatorStatusError(act.status)) return true;
-        }
-        return false;
-    }
+// Callback types
+using OdometryCallback = std::function<void(const RobotState&)>;
+using PointCloudCallback = std::function<void(const std::vector<Point3D>&)>;
+using PointCloudViewCallback = std::function<void(const PointCloudView&)>;
+using PointCloudSoACallback = std::function<void(const PointCloudSoA&)>;
+using RangeImageCallback = std::function<void(const RangeImage&)>;
+using GroundSegmentationCallback = std::function<void(const PointCloudSoA& ground, const PointCloudSoA& obstacles)>;
+using SurfaceCallback = std::function<void(const RangeImage& image, const SurfaceNormals& normals,
+                                           const std::vector<Plane>& planes)>;
 
-    /// Get list of actuators with errors
-    std::vector<std::string> getActuatorsWithErrors() const {
-        std::vector<std::string> errorList;
-        for (const auto& act : actuators) {
-            if (isActuatorStatusError(act.status)) {
-                errorList.push_back(act.name + " (" + getActuatorStatusName(act.status) + ")");
-            }
-        }
-        return errorList;
-    }
+/**
+ * @brief Per-subscription processing applied in the SDK's decode path
+ */
+struct PointCloudOptions {
+    CloudFilter filter;           ///< Crop/range/z-band/body filter fused into decode (inactive by default)
+    VoxelGridConfig downsample;   ///< Voxel-grid downsampling after filtering (disabled by default)
+    size_t parallel_decode_threshold = PointCloudDecoder::kDefaultParallelThreshold;  ///< Split decode of larger messages across threads (0 = never; per subscription)
+    std::optional<ExecutorOptions> executor;   ///< Cloud executor for all cloud subscriptions; unset keeps the current one, INLINE turns it off
+    CloudStatsConfig stats;       ///< Per-frame statistics filled during decode (shared by all cloud subscriptions; off by default; see setCloudStats())
+};
 
-    /// Check if all actuators are in operational state
-    bool allActuatorsOperational() const {
-        for (const auto& act : actuators) {
-            if (act.status != static_cast<uint16_t>(CiA402StatusWord::OPERATION_ENABLED)) {
-                return false;
-            }
-        }
-        return true;
-    }
+/**
+ * @brief Settings for RaisinClient::subscribeSurfaces()
+ */
+struct SurfaceConfig {
+    RangeImageConfig range_image;     ///< Projection that provides the neighbourhoods
+    NormalEstimationConfig normals;   ///< Window/edge settings (radius settings are unused here)
+    PlaneExtractionConfig planes;
 };
 
 /**
- * @brief Point for simple point cloud representation
+ * @brief Options for RaisinClient::uploadMap()
  */
-struct Point3D {
-    float x, y, z;
+struct MapUploadOptions {
+    float voxel_size = 0.0f;   ///< Downsample before upload (<= 0 sends every point)
+    int timeout_sec = 120;     ///< Service timeout; large maps take a while to transfer
+    /// Optional progress reports: stage is "map", "downsample"/"pack" or "upload", fraction in [0, 1]
+    std::function<void(const std::string& stage, double fraction)> progress;
 };
 
-// Callback types
-using OdometryCallback = std::function<void(const RobotState&)>;
-using PointCloudCallback = std::function<void(const std::vector<Point3D>&)>;
+/**
+ * @brief Topics whose handling can be moved to a TopicExecutor
+ */
+enum class SdkTopic {
+    ODOMETRY,      ///< /Odometry or the map-frame odometry
+    POINT_CLOUD,   ///< /cloud_registered (all cloud subscriptions and map features)
+    ROBOT_STATE    ///< robot_state
+};
 using ExtendedRobotStateCallback = std::function<void(const ExtendedRobotState&)>;
+using ActuatorStatusCallback = std::function<void(const ActuatorStatusChange&)>;
 
 /**
  * @brief High-level client for controlling Raisin robot autonomy
@@ -505,6 +513,11 @@ public:
         cloudSubscriber_.reset();
         robotStateSubscriber_.reset();
 
+        odomExecutor_.stop();
+        cloudExecutor_.stop();
+        robotStateExecutor_.stop();
+        stopRecording();
+
         setWaypointsClient_.reset();
         getWaypointsClient_.reset();
         setMapClient_.reset();
@@ -1169,19 +1182,7 @@ public:
         auto request = std::make_shared<raisin::raisin_interfaces::srv::SetLaserMap::Request>();
         request->name = mapFrameName_;
 
-        // Set initial pose
-        raisin::geometry_msgs::msg::Pose initial_pose;
-        initial_pose.position.x = x;
-        initial_pose.position.y = y;
-        initial_pose.position.z = 0.0;
-
-        double half_yaw = yaw * 0.5;
-        initial_pose.orientation.x = 0.0;
-        initial_pose.orientation.y = 0.0;
-        initial_pose.orientation.z = std::sin(half_yaw);
-        initial_pose.orientation.w = std::cos(half_yaw);
-
-        request->initial_pose = initial_pose;
+        request->initial_pose = planarPose(x, y, yaw);
         // Note: pc field is empty - we're using the map already loaded on robot
 
         ServiceResult result;
@@ -1202,6 +1203,100 @@ public:
         return result;
     }
 
+    /**
+     * @brief Send a local PCD map to the robot and start localization on it
+     *
+     * The PCD is memory-mapped and its x/y/z written straight into the
+     * SetLaserMap request, optionally voxel-downsampled on the way. On
+     * success the map becomes the loaded map, as after loadMap().
+     *
+     * @param pcdPath Local PCD file (ascii, binary or binary_compressed)
+     * @param name Map name on the robot
+     * @param x Initial X position
+     * @param y Initial Y position
+     * @param yaw Initial yaw angle in radians
+     * @return Result of the operation
+     */
+    ServiceResult uploadMap(const std::string& pcdPath, const std::string& name,
+                            double x, double y, double yaw, const MapUploadOptions& options = {}) {
+        if (!connected_) {
+            return {false, "Not connected to robot"};
+        }
+
+        reportProgress(options, "map", 0.0);
+        PcdFile pcd;
+        if (!pcd.open(pcdPath)) {
+            return {false, pcd.lastError()};
+        }
+        if (!pcd.hasXYZ()) {
+            return {false, "PCD has no float x/y/z fields: " + pcdPath};
+        }
+        if (options.voxel_size <= 0.0f && pcd.size() > kMaxMapPoints) {
+            return {false, mapTooLargeMessage(pcd.size())};
+        }
+        reportProgress(options, "map", 1.0);
+
+        auto request = std::make_shared<raisin::raisin_interfaces::srv::SetLaserMap::Request>();
+        request->name = name;
+        request->initial_pose = planarPose(x, y, yaw);
+        size_t packed = 0;
+        if (!packMapCloud(pcd, options, request->pc, packed)) {
+            return {false, mapTooLargeMessage(packed)};
+        }
+        pcd.close();
+
+        ensureMapClient();
+        ServiceResult result;
+        reportProgress(options, "upload", 0.0);
+        auto future = setMapClient_->asyncSendRequest(request);
+
+        if (future.wait_for(std::chrono::seconds(options.timeout_sec)) == std::future_status::ready) {
+            auto response = future.get();
+            result.success = response->success;
+            result.message = response->message;
+            if (result.success) {
+                mapFrameName_ = name;
+                reportProgress(options, "upload", 1.0);
+                std::cout << "[RaisinClient] Map uploaded: " << name << " ("
+                          << request->pc.width << " points)" << std::endl;
+            }
+        } else {
+            result.success = false;
+            result.message = "Request timeout";
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Register the latest point cloud against a local copy of the map
+     *
+     * Uses the cloud and odometry received last, so the point cloud and
+     * odometry subscriptions must be active. Pass a successful result to
+     * setInitialPose().
+     *
+     * @param matcher Matcher holding the map (see ScanMatcher::setMap())
+     * @param x Rough X position in the map
+     * @param y Rough Y position in the map
+     * @param yaw Rough yaw angle in radians
+     * @return Refined pose and fitness
+     */
+    RegistrationResult matchLatestScan(ScanMatcher& matcher, double x, double y, double yaw) {
+        PointCloudView scan = getLatestPointCloudView();
+        RobotState state = getRobotState();
+        if (scan.empty() || !state.valid) {
+            RegistrationResult result;
+            result.message = "No point cloud or odometry received yet";
+            return result;
+        }
+
+        RegistrationPose origin{state.x, state.y, state.z, state.yaw};
+        auto result = matcher.match(scan, origin, {x, y, 0.0, yaw});
+        std::cout << "[RaisinClient] Scan match: " << result.message << " (fitness " << result.fitness
+                  << ", " << result.elapsed_ms << " ms)" << std::endl;
+        return result;
+    }
+
     /**
      * @brief Get the currently loaded map name
      * @return Map name or empty string if no map is loaded
@@ -1300,43 +1395,21 @@ public:
      * @brief Subscribe to robot odometry in map frame
      * Call this after setMap() succeeds to get robot position in map coordinates.
      * Topic: /{map_name}/{robot_id}/Odometry
+     * @param executor Optional dedicated thread and mailbox policy (inline by default)
      */
-    void subscribeMapOdometry(OdometryCallback callback) {
+    void subscribeMapOdometry(OdometryCallback callback, const ExecutorOptions& executor = {}) {
         if (mapFrameName_.empty()) {
             std::cerr << "[RaisinClient] Error: Call setMap() first before subscribeMapOdometry()" << std::endl;
             return;
         }
 
         odomCallback_ = callback;
+        odomExecutor_.configure(executor);
         std::string topic = "/" + mapFrameName_ + "/" + robotId_ + "/Odometry";
         odomSubscriber_ = node_->createSubscriber<raisin::nav_msgs::msg::Odometry>(
             topic, connection_,
             [this](const raisin::nav_msgs::msg::Odometry::SharedPtr& msg) {
-                RobotState state;
-                state.x = msg->pose.pose.position.x;
-                state.y = msg->pose.pose.position.y;
-                state.z = msg->pose.pose.position.z;
-
-                double qx = msg->pose.pose.orientation.x;
-                double qy = msg->pose.pose.orientation.y;
-                double qz = msg->pose.pose.orientation.z;
-                double qw = msg->pose.pose.orientation.w;
-                state.yaw = std::atan2(2.0 * (qw * qz + qx * qy),
-                                       1.0 - 2.0 * (qy * qy + qz * qz));
-
-                state.vx = msg->twist.twist.linear.x;
-                state.vy = msg->twist.twist.linear.y;
-                state.omega = msg->twist.twist.angular.z;
-                state.valid = true;
-
-                {
-                    std::lock_guard<std::mutex> lock(stateMutex_);
-                    latestState_ = state;
-                }
-
-                if (odomCallback_) {
-                    odomCallback_(state);
-                }
+                odomExecutor_.post(msg);
             });
         std::cout << "[RaisinClient] Subscribed to " << topic << std::endl;
     }
@@ -1344,167 +1417,455 @@ public:
     /**
      * @brief Subscribe to robot odometry in odom frame (raw Fast-LIO output)
      * Use subscribeMapOdometry() instead for map-aligned coordinates.
+     * @param executor Optional dedicated thread and mailbox policy (inline by default)
      */
-    void subscribeOdometry(OdometryCallback callback) {
+    void subscribeOdometry(OdometryCallback callback, const ExecutorOptions& executor = {}) {
         odomCallback_ = callback;
+        odomExecutor_.configure(executor);
         odomSubscriber_ = node_->createSubscriber<raisin::nav_msgs::msg::Odometry>(
             "/Odometry", connection_,
             [this](const raisin::nav_msgs::msg::Odometry::SharedPtr& msg) {
-                RobotState state;
-                state.x = msg->pose.pose.position.x;
-                state.y = msg->pose.pose.position.y;
-                state.z = msg->pose.pose.position.z;
-
-                double qx = msg->pose.pose.orientation.x;
-                double qy = msg->pose.pose.orientation.y;
-                double qz = msg->pose.pose.orientation.z;
-                double qw = msg->pose.pose.orientation.w;
-                state.yaw = std::atan2(2.0 * (qw * qz + qx * qy),
-                                       1.0 - 2.0 * (qy * qy + qz * qz));
-
-                state.vx = msg->twist.twist.linear.x;
-                state.vy = msg->twist.twist.linear.y;
-                state.omega = msg->twist.twist.angular.z;
-                state.valid = true;
-
-                {
-                    std::lock_guard<std::mutex> lock(stateMutex_);
-                    latestState_ = state;
-                }
-
-                if (odomCallback_) {
-                    odomCallback_(state);
-                }
+                odomExecutor_.post(msg);
             });
         std::cout << "[RaisinClient] Subscribed to /Odometry" << std::endl;
     }
 
     /**
      * @brief Subscribe to live LiDAR point cloud
+     * Each message is decoded into an owning vector of x/y/z points. Like
+     * the other cloud subscriptions it may be made or replaced while clouds
+     * arrive; the change applies from the next cloud.
+     * @param options Optional processing (e.g. voxel downsampling) done before
+     *                the callback and before the cloud is published to getters
      */
-    void subscribePointCloud(PointCloudCallback callback) {
-        cloudCallback_ = callback;
-        cloudSubscriber_ = node_->createSubscriber<raisin::sensor_msgs::msg::PointCloud2>(
-            "/cloud_registered", connection_,
-            [this](const raisin::sensor_msgs::msg::PointCloud2::SharedPtr& msg) {
-                std::vector<Point3D> points;
+    void subscribePointCloud(PointCloudCallback callback, const PointCloudOptions& options = {}) {
+        updateCloudSubscriptions([&](CloudSubscriptions& s) {
+            s.cloud = callback;
+            s.cloud_options = options;
+            s.decode_cloud = true;
+        });
+        configureCloudExecutor(options.executor);
+        configureCloudStats(options.stats);
+        ensureCloudSubscriber();
+    }
 
-                if (msg->data.empty()) return;
+    /**
+     * @brief Subscribe to live LiDAR point cloud without copying
+     *
+     * The callback receives a PointCloudView over the received message
+     * buffer. Keep a copy of the view to hold on to the data; it is cheap.
+     * If only this overload is used, getLatestPointCloud() stays empty;
+     * use getLatestPointCloudView() instead.
+     */
+    void subscribePointCloud(PointCloudViewCallback callback) {
+        updateCloudSubscriptions([&](CloudSubscriptions& s) { s.view = callback; });
+        ensureCloudSubscriber();
+    }
 
-                size_t point_step = msg->point_step;
-                size_t num_points = msg->width * msg->height;
+    /**
+     * @brief Move /cloud_registered handling off the network thread
+     *
+     * All cloud subscriptions and map features share this executor. With
+     * KEEP_LATEST and capacity 1, a slow consumer only ever sees the newest
+     * scan and the other topics keep flowing; see getTopicCounters() for
+     * how many scans were dropped. Pass INLINE to go back to decoding on
+     * the network thread.
+     * @return false if called from a cloud callback running on the executor
+     */
+    bool setPointCloudExecutor(const ExecutorOptions& executor) {
+        return configureCloudExecutor(executor);
+    }
 
-                int x_offset = -1, y_offset = -1, z_offset = -1;
-                for (const auto& field : msg->fields) {
-                    if (field.name == "x") x_offset = field.offset;
-                    else if (field.name == "y") y_offset = field.offset;
-                    else if (field.name == "z") z_offset = field.offset;
-                }
+    /**
+     * @brief Subscribe to live LiDAR point cloud in structure-of-arrays form
+     *
+     * The decode kernel is chosen from the first message's field layout
+     * (see PointCloudDecoder), so intensity/ring/time are filled when the
+     * sensor provides them. Decoded into a buffer reused across frames; the
+     * reference passed to the callback is only valid during the call.
+     */
+    void subscribePointCloud(PointCloudSoACallback callback, const PointCloudOptions& options = {}) {
+        updateCloudSubscriptions([&](CloudSubscriptions& s) {
+            s.soa = callback;
+            s.soa_options = options;
+        });
+        configureCloudExecutor(options.executor);
+        configureCloudStats(options.stats);
+        ensureCloudSubscriber();
+    }
 
-                if (x_offset < 0 || y_offset < 0 || z_offset < 0) return;
+    /**
+     * @brief Subscribe to live LiDAR point cloud split into ground and obstacles
+     *
+     * Each cloud is decoded (with the optional filter/downsampling), then
+     * classified by a polar-grid GroundSegmenter centred on the latest
+     * odometry pose. Both clouds are reused buffers, valid only during the
+     * callback. With the same filter as the SoA or vector subscription the
+     * cloud is not decoded again (the vector form only when the message has
+     * no channel besides x/y/z).
+     */
+    void subscribeGroundSegmentation(GroundSegmentationCallback callback,
+                                     const GroundSegmentationConfig& config = {},
+                                     const PointCloudOptions& options = {}) {
+        updateCloudSubscriptions([&](CloudSubscriptions& s) {
+            s.ground = callback;
+            s.ground_config = config;
+            s.ground_options = options;
+        });
+        ensureCloudSubscriber();
+    }
 
-                points.reserve(num_points);
-                for (size_t i = 0; i < num_points; ++i) {
-                    const uint8_t* ptr = msg->data.data() + i * point_step;
-                    Point3D p;
-                    p.x = *reinterpret_cast<const float*>(ptr + x_offset);
-                    p.y = *reinterpret_cast<const float*>(ptr + y_offset);
-                    p.z = *reinterpret_cast<const float*>(ptr + z_offset);
-                    points.push_back(p);
-                }
+    /**
+     * @brief Subscribe to live LiDAR point cloud as a spherical range image
+     *
+     * Each message is projected in one pass around the latest odometry pose
+     * (the ring field picks the row when present). RangeImage::index maps
+     * pixels back to message points and RangeImage::pixel the other way.
+     * The image is a reused buffer, valid only during the callback.
+     */
+    void subscribeRangeImage(RangeImageCallback callback, const RangeImageConfig& config = {}) {
+        updateCloudSubscriptions([&](CloudSubscriptions& s) {
+            s.range_image = callback;
+            s.range_image_config = config;
+        });
+        ensureCloudSubscriber();
+    }
 
-                {
-                    std::lock_guard<std::mutex> lock(cloudMutex_);
-                    latestCloud_ = std::move(points);
-                }
+    /**
+     * @brief Subscribe to per-pixel normals and dominant planes of each scan
+     *
+     * Each message is projected into a range image around the latest
+     * odometry pose, normals are fitted over adjacent pixels and the
+     * dominant planes (floor, ramps, walls) extracted, all without decoding
+     * the cloud into a separate buffer. Normals are indexed like the image
+     * pixels; the image, normals and planes are reused buffers, valid only
+     * during the callback.
+     */
+    void subscribeSurfaces(SurfaceCallback callback, const SurfaceConfig& config = {}) {
+        updateCloudSubscriptions([&](CloudSubscriptions& s) {
+            s.surface = callback;
+            s.surface_config = config;
+        });
+        ensureCloudSubscriber();
+    }
 
-                if (cloudCallback_) {
-                    std::lock_guard<std::mutex> lock(cloudMutex_);
-                    cloudCallback_(latestCloud_);
-                }
-            });
-        std::cout << "[RaisinClient] Subscribed to /cloud_registered" << std::endl;
+    /**
+     * @brief Accumulate /cloud_registered into a sliding-window voxel map
+     *
+     * Every received cloud is fused into the returned map, and voxels are
+     * evicted by age and by distance from the latest odometry pose (call
+     * subscribeOdometry() for distance eviction). The map is thread-safe;
+     * query it from any thread. Calling again replaces the map.
+     */
+    std::shared_ptr<LocalMapAccumulator> enableLocalMap(const LocalMapConfig& config = {}) {
+        auto map = std::make_shared<LocalMapAccumulator>(config);
+        localMap_.store(map);
+        ensureCloudSubscriber();
+        return map;
+    }
+
+    /// Map created by enableLocalMap(), or nullptr
+    std::shared_ptr<LocalMapAccumulator> getLocalMap() const { return localMap_.load(); }
+
+    /**
+     * @brief Keep a KD-tree over the latest /cloud_registered frame
+     *
+     * The tree is rebuilt on the index's own thread for every new cloud
+     * (skipping frames if builds fall behind), so this never slows down the
+     * network thread. Queries run against the last completed tree.
+     *
+     * @code
+     * auto index = client.enableSpatialIndex({0.05f});
+     * raisin_sdk::Neighbor closest;
+     * if (index->nearest({x, y, z}, closest)) { ... }
+     * @endcode
+     */
+    std::shared_ptr<SpatialIndex> enableSpatialIndex(const SpatialIndexConfig& config = {}) {
+        auto index = std::make_shared<SpatialIndex>(config);
+        spatialIndex_.store(index);
+        ensureCloudSubscriber();
+        return index;
+    }
+
+    /// Index created by enableSpatialIndex(), or nullptr
+    std::shared_ptr<SpatialIndex> getSpatialIndex() const { return spatialIndex_.load(); }
+
+    /**
+     * @brief Maintain a rolling 2D costmap from /cloud_registered and odometry
+     *
+     * Each cloud is ray-cast from the latest subscribeOdometry() pose and
+     * only the cells it touches are updated. Read the result from any
+     * thread with getCostmap() (an immutable snapshot, O(1)). The client
+     * is the costmap's only updater; use snapshot()/costAt() on the
+     * returned object, not update().
+     */
+    std::shared_ptr<RollingCostmap> enableCostmap(const CostmapConfig& config = {}) {
+        auto costmap = std::make_shared<RollingCostmap>(config);
+        costmap_.store(costmap);
+        ensureCloudSubscriber();
+        return costmap;
+    }
+
+    /// Latest costmap grid (nullptr until enableCostmap() and the first cloud)
+    std::shared_ptr<const CostmapGrid> getCostmap() const {
+        auto costmap = costmap_.load();
+        return costmap ? costmap->snapshot() : nullptr;
+    }
+
+    /**
+     * @brief Record every /cloud_registered message to PCD with its odometry pose
+     *
+     * Frames are copied on the cloud thread and written by the recorder's
+     * own thread; watch stats() for dropped frames.
+     * @return The recorder, or nullptr if the output could not be created
+     */
+    std::shared_ptr<CloudRecorder> startRecording(const CloudRecorderConfig& config) {
+        auto recorder = std::make_shared<CloudRecorder>();
+        if (!recorder->open(config)) {
+            std::cerr << "[RaisinClient] Error: " << recorder->lastError() << std::endl;
+            return nullptr;
+        }
+        stopRecording();
+        recorder_.store(recorder);
+        ensureCloudSubscriber();
+        std::cout << "[RaisinClient] Recording clouds to " << config.path << std::endl;
+        return recorder;
+    }
+
+    /// Stop recording and write out the frames still queued
+    void stopRecording() {
+        auto recorder = recorder_.load();
+        if (!recorder) return;
+        recorder_.reset();
+        recorder->close();
     }
 
     /**
      * @brief Subscribe to extended robot state (battery, actuators, locomotion state)
+     * @param executor Optional dedicated thread and mailbox policy (inline by default)
      */
-    void subscribeRobotState(ExtendedRobotStateCallback callback) {
-        extRobotStateCallback_ = callback;
-        robotStateSubscriber_ = node_->createSubscriber<raisin::raisin_interfaces::msg::RobotState>(
-            "robot_state", connection_,
-            [this](const raisin::raisin_interfaces::msg::RobotState::SharedPtr& msg) {
-                ExtendedRobotState state;
-
-                state.x = msg->base_pos[0];
-                state.y = msg->base_pos[1];
-                state.z = msg->base_pos[2];
-
-                double qx = msg->base_quat[0];
-                double qy = msg->base_quat[1];
-                double qz = msg->base_quat[2];
-                double qw = msg->base_quat[3];
-                state.yaw = std::atan2(2.0 * (qw * qz + qx * qy),
-                                       1.0 - 2.0 * (qy * qy + qz * qz));
-
-                state.vx = msg->base_lin_vel[0];
-                state.vy = msg->base_lin_vel[1];
-                state.omega = msg->base_ang_vel[2];
-
-                state.locomotion_state = msg->state;
-
-                state.voltage = msg->voltage;
-                state.current = msg->current;
-                state.max_voltage = msg->max_voltage;
-                state.min_voltage = msg->min_voltage;
-
-                state.body_temperature = msg->body_temperature;
-
-                state.joy_listen_type = msg->joy_listen_type;
-
-                state.actuators.reserve(msg->actuator_states.size());
-                for (const auto& act : msg->actuator_states) {
-                    ActuatorInfo info;
-                    info.name = act.name;
-                    info.status = act.status;
-                    info.temperature = act.temperature;
-                    info.position = act.position;
-                    info.velocity = act.velocity;
-                    info.effort = act.effort;
-                    state.actuators.push_back(info);
-                }
+    void subscribeRobotState(ExtendedRobotStateCallback callback, const ExecutorOptions& executor = {}) {
+        updateRobotStateCallbacks([&](RobotStateCallbacks& c) { c.state = callback; });
+        robotStateExecutor_.configure(executor);
+        ensureRobotStateSubscriber();
+    }
 
-                state.valid = true;
+    /**
+     * @brief Called when an actuator enters an error status (or switches between error statuses)
+     *
+     * Fires on the robot_state thread only when a CiA402 status word changes,
+     * after the status words are compared against the previous message; an
+     * actuator already faulted in the first message is reported with
+     * first_seen set. Subscribes to robot_state if needed.
+     *
+     * @code
+     * client.onActuatorFault([](const raisin_sdk::ActuatorStatusChange& change) {
+     *     std::cerr << change.actuator->name << " -> "
+     *               << raisin_sdk::getActuatorStatusName(change.status) << std::endl;
+     * });
+     * @endcode
+     */
+    void onActuatorFault(ActuatorStatusCallback callback) {
+        updateRobotStateCallbacks([&](RobotStateCallbacks& c) { c.fault = callback; });
+        ensureRobotStateSubscriber();
+    }
 
-                {
-                    std::lock_guard<std::mutex> lock(extStateMutex_);
-                    latestExtState_ = state;
-                }
+    /// Called when an actuator leaves an error status (see onActuatorFault())
+    void onActuatorRecovered(ActuatorStatusCallback callback) {
+        updateRobotStateCallbacks([&](RobotStateCallbacks& c) { c.recovered = callback; });
+        ensureRobotStateSubscriber();
+    }
 
-                if (extRobotStateCallback_) {
-                    extRobotStateCallback_(state);
-                }
-            });
-        std::cout << "[RaisinClient] Subscribed to robot_state" << std::endl;
+    /**
+     * @brief Record every robot_state message into a TelemetryHistory
+     *
+     * Battery, body temperature and per-actuator columns are kept in ring
+     * buffers with O(1) windowed statistics; query the returned history from
+     * any thread. Subscribes to robot_state if needed.
+     *
+     * @code
+     * auto history = client.enableTelemetryHistory();
+     * auto current = history->stats(raisin_sdk::TelemetryChannel::CURRENT, 10.0);
+     * std::cout << "10 s current: " << current.mean << " A (p95 " << current.p95 << ")" << std::endl;
+     * @endcode
+     */
+    std::shared_ptr<TelemetryHistory> enableTelemetryHistory(const TelemetryHistoryConfig& config = {}) {
+        auto history = std::make_shared<TelemetryHistory>(config);
+        telemetryHistory_.store(history);
+        ensureRobotStateSubscriber();
+        return history;
+    }
+
+    /// History created by enableTelemetryHistory(), or nullptr
+    std::shared_ptr<TelemetryHistory> getTelemetryHistory() const {
+        return telemetryHistory_.load();
+    }
+
+    /**
+     * @brief Estimate state of charge, runtime and energy per metre from robot_state
+     *
+     * Every message updates the returned estimator (coulomb counting plus a
+     * load-compensated voltage EKF); read estimate() from any thread.
+     * Subscribes to robot_state if needed.
+     *
+     * @code
+     * raisin_sdk::BatteryEstimatorConfig config;
+     * config.capacity_ah = 28.0;                 // pack rating
+     * auto battery = client.enableBatteryEstimator(config);
+     * auto e = battery->estimate();
+     * if (e.valid) std::cout << e.soc * 100.0 << "% " << e.remaining_runtime_sec / 60.0 << " min" << std::endl;
+     * @endcode
+     */
+    std::shared_ptr<BatteryEstimator> enableBatteryEstimator(const BatteryEstimatorConfig& config = {}) {
+        auto estimator = std::make_shared<BatteryEstimator>(config);
+        batteryEstimator_.store(estimator);
+        ensureRobotStateSubscriber();
+        return estimator;
+    }
+
+    /// Estimator created by enableBatteryEstimator(), or nullptr
+    std::shared_ptr<BatteryEstimator> getBatteryEstimator() const {
+        return batteryEstimator_.load();
+    }
+
+    /**
+     * @brief Fit per-actuator thermal models and forecast time to a temperature threshold
+     *
+     * Every robot_state message updates the returned forecaster in
+     * O(actuators); query it from any thread. Subscribes to robot_state if
+     * needed.
+     *
+     * @code
+     * raisin_sdk::ThermalForecastConfig config;
+     * config.threshold = 75.0;                  // derating onset
+     * auto thermal = client.enableThermalForecast(config);
+     * double seconds = 0.0;
+     * int hottest = thermal->soonestOverheat(&seconds);
+     * @endcode
+     */
+    std::shared_ptr<ThermalForecaster> enableThermalForecast(const ThermalForecastConfig& config = {}) {
+        auto forecaster = std::make_shared<ThermalForecaster>(config);
+        thermalForecaster_.store(forecaster);
+        ensureRobotStateSubscriber();
+        return forecaster;
+    }
+
+    /// Forecaster created by enableThermalForecast(), or nullptr
+    std::shared_ptr<ThermalForecaster> getThermalForecaster() const {
+        return thermalForecaster_.load();
     }
 
     // ========================================================================
     // Getters (Thread-safe)
     // ========================================================================
 
-    ExtendedRobotState getExtendedRobotState() {
-        std::lock_guard<std::mutex> lock(extStateMutex_);
-        return latestExtState_;
+    // The latest states are published through SeqLocks: getters never take a
+    // lock the network thread holds, and the network thread never waits for
+    // a reader. Versions count received messages (0 = nothing yet).
+
+    ExtendedRobotState getExtendedRobotState() const {
+        ExtendedRobotState state;
+        getExtendedRobotState(state);
+        return state;
     }
 
-    RobotState getRobotState() {
-        std::lock_guard<std::mutex> lock(stateMutex_);
-        return latestState_;
+    /**
+     * @brief Copy the latest state into out, reusing its actuator buffers
+     * No allocation once out is sized. Every actuator in the message is
+     * returned; beyond detail::ExtendedStateFrame::kMaxActuators the state
+     * comes from a pooled snapshot instead of the SeqLock frame.
+     * @return Version of the copied state
+     */
+    uint64_t getExtendedRobotState(ExtendedRobotState& out) const {
+        detail::ExtendedStateFrame frame;
+        for (;;) {
+            const uint64_t version = latestExtState_.load(frame);
+            if (frame.overflow()) {
+                // Stored before its frame, so it is at least as new as version
+                auto full = extStateOverflow_.load();
+                if (!full || full->version < version) continue;
+                out = full->state;
+                return full->version;
+            }
+            // The table is replaced before the first frame that uses it; a
+            // newer table means a newer frame is on its way
+            auto table = actuatorTable_.load();
+            const uint64_t generation = table ? table->generation : 0;
+            if (generation != frame.table_generation) continue;
+            frame.unpack(out, table.get());
+            return version;
+        }
     }
 
+    /// Number of robot_state messages published so far (no copy)
+    uint64_t getExtendedRobotStateVersion() const { return latestExtState_.version(); }
+
+    RobotState getRobotState() const { return latestState_.load(); }
+
+    /**
+     * @brief Copy the latest odometry state into out
+     * @return Version of the copied state; compare with getRobotStateVersion()
+     *         to skip polls that would return the same data
+     */
+    uint64_t getRobotState(RobotState& out) const { return latestState_.load(out); }
+
+    /// Number of odometry messages published so far (no copy)
+    uint64_t getRobotStateVersion() const { return latestState_.version(); }
+
+    /// Copy of the latest decoded cloud (prefer getLatestPointCloudSnapshot())
     std::vector<Point3D> getLatestPointCloud() {
-        std::lock_guard<std::mutex> lock(cloudMutex_);
-        return latestCloud_;
+        auto snapshot = latestCloud_.load();
+        return snapshot ? snapshot->points : std::vector<Point3D>();
+    }
+
+    /**
+     * @brief Latest decoded cloud as an immutable shared snapshot
+     * O(1) and never blocks on the network thread or callbacks.
+     * @return nullptr before the first decoded message
+     */
+    std::shared_ptr<const PointCloud> getLatestPointCloudSnapshot() const {
+        return latestCloud_.load();
+    }
+
+    /// Latest received cloud as a zero-copy view (empty before the first message)
+    PointCloudView getLatestPointCloudView() const {
+        auto snapshot = latestCloudView_.load();
+        return snapshot ? *snapshot : PointCloudView();
+    }
+
+    /**
+     * @brief Statistics of the latest cloud (see PointCloudOptions::stats)
+     * Bounding box, NaN count, range histogram, sector density and z
+     * percentiles, computed in the decode loop of the subscription.
+     * @return nullptr until statistics are enabled and a cloud arrived
+     */
+    std::shared_ptr<const CloudStats> getLatestCloudStats() const {
+        return latestStats_.load();
+    }
+
+    /**
+     * @brief Enable, reconfigure or (with enabled = false) stop cloud statistics
+     * Takes effect from the next cloud. Subscriptions whose options leave
+     * stats disabled do not change the current setting; this call does.
+     * Disabling also clears getLatestCloudStats().
+     */
+    void setCloudStats(const CloudStatsConfig& stats) {
+        {
+            std::lock_guard<std::mutex> lock(statsConfigMutex_);
+            pendingStatsConfig_ = stats;
+        }
+        statsConfigChanged_.store(true, std::memory_order_release);
+        if (!stats.enabled) latestStats_.reset();
+    }
+
+    /// Received/decoded/delivered/dropped counters of a topic
+    TopicCounters getTopicCounters(SdkTopic topic) const {
+        switch (topic) {
+            case SdkTopic::ODOMETRY: return odomExecutor_.counters();
+            case SdkTopic::POINT_CLOUD: return cloudExecutor_.counters();
+            case SdkTopic::ROBOT_STATE: return robotStateExecutor_.counters();
+        }
+        return {};
     }
 
 private:
@@ -1542,18 +1903,123 @@ private:
     std::string robotId_;
     std::string mapFrameName_;
 
+    /**
+     * @brief Callbacks and settings of every cloud subscription
+     * Subscribe calls edit pendingCloudSubscriptions_ under a mutex; the
+     * cloud thread copies it into the members below before the next cloud.
+     */
+    struct CloudSubscriptions {
+        PointCloudCallback cloud;
+        PointCloudOptions cloud_options;
+        bool decode_cloud = false;   ///< Vector subscription made (even with an empty callback)
+        PointCloudViewCallback view;
+        PointCloudSoACallback soa;
+        PointCloudOptions soa_options;
+        GroundSegmentationCallback ground;
+        GroundSegmentationConfig ground_config;
+        PointCloudOptions ground_options;
+        RangeImageCallback range_image;
+        RangeImageConfig range_image_config;
+        SurfaceCallback surface;
+        SurfaceConfig surface_config;
+    };
+
     // Callbacks
     OdometryCallback odomCallback_;
+    // Cloud callbacks and the cloud settings further down belong to the
+    // cloud thread; they only change in applyCloudSubscriptions()
     PointCloudCallback cloudCallback_;
+    PointCloudViewCallback cloudViewCallback_;
+    PointCloudSoACallback cloudSoACallback_;
+    GroundSegmentationCallback groundCallback_;
+    RangeImageCallback rangeImageCallback_;
+    SurfaceCallback surfaceCallback_;
+    bool decodeCloud_ = false;   ///< Decode into latestCloud_ snapshots (vector subscription active)
+    std::atomic<bool> cloudSubscriptionsChanged_{false};
+    std::mutex cloudSubscriptionsMutex_;            ///< Guards pendingCloudSubscriptions_
+    CloudSubscriptions pendingCloudSubscriptions_;  ///< Latest state of the subscribe calls
+    /// robot_state callbacks as last registered (guarded by robotStateCallbacksMutex_)
+    struct RobotStateCallbacks {
+        ExtendedRobotStateCallback state;
+        ActuatorStatusCallback fault;
+        ActuatorStatusCallback recovered;
+    };
+    // robot_state thread copies, refreshed by applyRobotStateCallbacks()
     ExtendedRobotStateCallback extRobotStateCallback_;
+    ActuatorStatusCallback actuatorFaultCallback_;
+    ActuatorStatusCallback actuatorRecoveredCallback_;
+    std::atomic<bool> robotStateCallbacksChanged_{false};
+    std::mutex robotStateCallbacksMutex_;
+    RobotStateCallbacks pendingRobotStateCallbacks_;
 
     // Cached data
-    mutable std::mutex stateMutex_;
-    mutable std::mutex cloudMutex_;
-    mutable std::mutex extStateMutex_;
-    RobotState latestState_;
-    std::vector<Point3D> latestCloud_;
-    ExtendedRobotState latestExtState_;
+    SeqLock<RobotState> latestState_;
+    AtomicSnapshot<detail::OdometryFrames> odomFrames_;  ///< Frames of the latest odometry, for robot-relative filters
+    std::shared_ptr<const detail::OdometryFrames> odomFramesSeen_;  ///< Last frames stored (odometry thread only)
+    bool filterPoseWarned_ = false;  ///< A robot-relative filter had no pose (cloud thread only)
+    AtomicSnapshot<PointCloud> latestCloud_;
+    AtomicSnapshot<PointCloudView> latestCloudView_;
+    std::shared_ptr<SnapshotPool<PointCloud>> cloudPool_ = SnapshotPool<PointCloud>::create();
+    uint64_t cloudSequence_ = 0;
+    PointCloudDecoder cloudDecoder_;  ///< Layout-specialized decoder for /cloud_registered
+    // Parallel decode thresholds of each decoding subscription, applied before its decode
+    size_t cloudParallelThreshold_ = PointCloudDecoder::kDefaultParallelThreshold;
+    size_t soaParallelThreshold_ = PointCloudDecoder::kDefaultParallelThreshold;
+    size_t groundParallelThreshold_ = PointCloudDecoder::kDefaultParallelThreshold;
+    PointCloudSoA cloudSoA_;          ///< Reused SoA decode buffer (network thread only)
+    PointCloudSoA cloudSoAReduced_;   ///< Reused downsampled SoA buffer
+    std::vector<Point3D> cloudScratch_;   ///< Filtered points before downsampling
+    CloudFilter cloudFilter_;
+    CloudFilter soaFilter_;
+    VoxelGridFilter cloudVoxelFilter_;
+    VoxelGridFilter soaVoxelFilter_;
+    CloudFilter groundFilter_;
+    VoxelGridFilter groundVoxelFilter_;
+    GroundSegmenter groundSegmenter_;
+    PointCloudSoA groundInput_;       ///< Decoded cloud for ground segmentation
+    PointCloudSoA groundReduced_;
+    PointCloudSoA groundPoints_;
+    PointCloudSoA obstaclePoints_;
+    RangeImageProjector rangeProjector_;
+    RangeImage rangeImage_;
+    RangeImageProjector surfaceProjector_;
+    RangeImage surfaceImage_;
+    NormalEstimator normalEstimator_;
+    SurfaceNormals surfaceNormals_;
+    PlaneExtractor planeExtractor_;
+    std::vector<Plane> surfacePlanes_;
+    AtomicShared<LocalMapAccumulator> localMap_;   ///< Fed by the cloud thread, queried anywhere (own mutex)
+    AtomicShared<SpatialIndex> spatialIndex_;   ///< update() from the cloud thread; queries use its tree snapshots
+    AtomicShared<RollingCostmap> costmap_;   ///< update() from the cloud thread only; snapshot()/costAt() anywhere
+    AtomicShared<CloudRecorder> recorder_;   ///< record() from the cloud thread only; stats()/close() anywhere (own mutexes)
+    std::atomic<bool> statsEnabled_{false};   ///< Statistics gathered for each cloud (written by the cloud thread)
+    std::atomic<bool> statsConfigChanged_{false};
+    std::mutex statsConfigMutex_;             ///< Guards pendingStatsConfig_
+    CloudStatsConfig pendingStatsConfig_;     ///< Last setCloudStats() request
+    CloudStatsCollector statsCollector_;      ///< Cloud thread only
+    std::shared_ptr<SnapshotPool<CloudStats>> statsPool_ = SnapshotPool<CloudStats>::create();
+    AtomicSnapshot<CloudStats> latestStats_;
+    SeqLock<detail::ExtendedStateFrame> latestExtState_;
+    detail::ExtendedStateFrame extFrame_;  ///< Publish staging (robot_state handler only)
+    ExtendedRobotState decodedExtState_;   ///< Decode target reused across messages (robot_state handler only)
+    AtomicSnapshot<detail::ActuatorNameTable> actuatorTable_;   ///< Replaced on actuator list changes
+    uint64_t actuatorTableGeneration_ = 0;                      ///< robot_state handler only
+    std::shared_ptr<SnapshotPool<detail::ExtendedStateOverflow>> extStatePool_ =
+        SnapshotPool<detail::ExtendedStateOverflow>::create(2);
+    AtomicSnapshot<detail::ExtendedStateOverflow> extStateOverflow_;   ///< Only for robots beyond kMaxActuators
+    AtomicShared<TelemetryHistory> telemetryHistory_;   ///< record() from the robot_state thread, queries anywhere (own mutex)
+    AtomicShared<BatteryEstimator> batteryEstimator_;   ///< update() from the robot_state thread, queries anywhere (own mutex)
+    AtomicShared<ThermalForecaster> thermalForecaster_;   ///< update() from the robot_state thread, queries anywhere (own mutex)
+    std::vector<uint16_t> actuatorStatus_;  ///< Status words of the previous message (robot_state handler only)
+    bool actuatorStatusKnown_ = false;      ///< False until a message with the current actuator list was seen
+
+    // Per-topic executors (declared last so they stop before the state they use)
+    TopicExecutor<raisin::nav_msgs::msg::Odometry::SharedPtr> odomExecutor_{
+        [this](const raisin::nav_msgs::msg::Odometry::SharedPtr& msg) { handleOdometry(msg); }};
+    TopicExecutor<raisin::sensor_msgs::msg::PointCloud2::SharedPtr> cloudExecutor_{
+        [this](const raisin::sensor_msgs::msg::PointCloud2::SharedPtr& msg) { handlePointCloud(msg); }};
+    TopicExecutor<raisin::raisin_interfaces::msg::RobotState::SharedPtr> robotStateExecutor_{
+        [this](const raisin::raisin_interfaces::msg::RobotState::SharedPtr& msg) { handleRobotState(msg); }};
 
     void ensureWaypointClients() {
         if (!setWaypointsClient_) {
@@ -1580,6 +2046,113 @@ private:
         }
     }
 
+    static raisin::geometry_msgs::msg::Pose planarPose(double x, double y, double yaw) {
+        raisin::geometry_msgs::msg::Pose pose;
+        pose.position.x = x;
+        pose.position.y = y;
+        pose.position.z = 0.0;
+
+        double half_yaw = yaw * 0.5;
+        pose.orientation.x = 0.0;
+        pose.orientation.y = 0.0;
+        pose.orientation.z = std::sin(half_yaw);
+        pose.orientation.w = std::cos(half_yaw);
+        return pose;
+    }
+
+    static void reportProgress(const MapUploadOptions& options, const char* stage, double fraction) {
+        if (options.progress) {
+            options.progress(stage, fraction);
+        }
+    }
+
+    /// Most points one PointCloud2 row can hold: row_step is a uint32 byte count
+    static constexpr size_t kMaxMapPoints = std::numeric_limits<uint32_t>::max() / sizeof(Point3D);
+
+    static std::string mapTooLargeMessage(size_t points) {
+        return "Map has " + std::to_string(points) + " points, more than one upload can carry (" +
+               std::to_string(kMaxMapPoints) + "); set MapUploadOptions::voxel_size to downsample it";
+    }
+
+    /**
+     * @brief Write the map's x/y/z as float32 records straight into pc.data
+     *
+     * The whole map goes out as one row of one SetLaserMap request: the robot
+     * replaces its map per request, so it cannot be sent in chunks, and a
+     * single row's uint32 row_step caps it at kMaxMapPoints. Larger maps
+     * must be downsampled with MapUploadOptions::voxel_size.
+     * @param count Number of points packed (after downsampling)
+     * @return false, with pc.data emptied, if count exceeds kMaxMapPoints
+     */
+    static bool packMapCloud(const PcdFile& pcd, const MapUploadOptions& options,
+                             raisin::sensor_msgs::msg::PointCloud2& pc, size_t& count) {
+        pc.height = 1;
+        pc.is_bigendian = false;
+        pc.point_step = sizeof(Point3D);
+        pc.fields.clear();
+        const char* names[3] = {"x", "y", "z"};
+        for (uint32_t k = 0; k < 3; ++k) {
+            raisin::sensor_msgs::msg::PointField field;
+            field.name = names[k];
+            field.offset = k * sizeof(float);
+            field.datatype = raisin::sensor_msgs::msg::PointField::FLOAT32;
+            field.count = 1;
+            pc.fields.push_back(field);
+        }
+        // The downsampled size is only known here, so an oversized result is
+        // still written (the filter needs the storage) and rejected afterwards
+        auto allocate = [&pc, &count](size_t points) {
+            count = points;
+            const size_t rowPoints = std::min(points, kMaxMapPoints);
+            pc.width = static_cast<uint32_t>(rowPoints);
+            pc.row_step = static_cast<uint32_t>(rowPoints * sizeof(Point3D));
+            pc.data.resize(points * sizeof(Point3D));
+            return reinterpret_cast<Point3D*>(pc.data.data());
+        };
+
+        if (options.voxel_size > 0.0f) {
+            reportProgress(options, "downsample", 0.0);
+            VoxelGridConfig config;
+            config.voxel_size = options.voxel_size;
+            VoxelGridFilter filter(config);
+            filter.apply(pcd.size(), [&pcd](size_t i) { return pcd.point(i); }, allocate);
+            pc.is_dense = true;   // non-finite points fall in no voxel
+            reportProgress(options, "downsample", 1.0);
+            if (count > kMaxMapPoints) {
+                pc.data.clear();
+                pc.data.shrink_to_fit();
+                return false;
+            }
+            return true;
+        }
+
+        // Bulk copy from the mapping when the file already stores packed x/y/z
+        const size_t n = pcd.size();
+        Point3D* out = allocate(n);
+        const uint8_t* packed = pcd.packedXYZ();
+        const size_t step = pcd.pointStep();
+        auto pool = WorkerPool::shared();
+        constexpr size_t kBatch = size_t(1) << 22;   // progress granularity
+        reportProgress(options, "pack", 0.0);
+        for (size_t batch = 0; batch < n; batch += kBatch) {
+            const size_t batchCount = std::min(kBatch, n - batch);
+            pool->parallelForRange(batchCount, size_t(1) << 16, [&](size_t begin, size_t end) {
+                begin += batch;
+                end += batch;
+                if (packed && step == sizeof(Point3D)) {
+                    std::memcpy(out + begin, packed + begin * step, (end - begin) * step);
+                } else if (packed) {
+                    for (size_t i = begin; i < end; ++i) std::memcpy(out + i, packed + i * step, sizeof(Point3D));
+                } else {
+                    for (size_t i = begin; i < end; ++i) out[i] = pcd.point(i);
+                }
+            });
+            reportProgress(options, "pack", static_cast<double>(batch + batchCount) / n);
+        }
+        pc.is_dense = false;
+        return true;
+    }
+
     void ensureLocomotionClients() {
         if (!standUpClient_) {
             standUpClient_ = node_->createClient<raisin::std_srvs::srv::Trigger>(
@@ -1632,6 +2205,493 @@ private:
         }
     }
 
+    void handleOdometry(const raisin::nav_msgs::msg::Odometry::SharedPtr& msg) {
+        RobotState state;
+        state.x = msg->pose.pose.position.x;
+        state.y = msg->pose.pose.position.y;
+        state.z = msg->pose.pose.position.z;
+
+        double qx = msg->pose.pose.orientation.x;
+        double qy = msg->pose.pose.orientation.y;
+        double qz = msg->pose.pose.orientation.z;
+        double qw = msg->pose.pose.orientation.w;
+        state.yaw = std::atan2(2.0 * (qw * qz + qx * qy),
+                               1.0 - 2.0 * (qy * qy + qz * qz));
+
+        state.vx = msg->twist.twist.linear.x;
+        state.vy = msg->twist.twist.linear.y;
+        state.omega = msg->twist.twist.angular.z;
+        state.valid = true;
+
+        // Frame names rarely change: only publish a new snapshot when they do
+        if (!odomFramesSeen_ || odomFramesSeen_->parent != msg->header.frame_id ||
+            odomFramesSeen_->child != msg->child_frame_id) {
+            odomFramesSeen_ = std::make_shared<const detail::OdometryFrames>(
+                detail::OdometryFrames{msg->header.frame_id, msg->child_frame_id});
+            odomFrames_.store(odomFramesSeen_);
+        }
+        latestState_.store(state);
+        odomExecutor_.markDecoded();
+
+        if (odomCallback_) {
+            odomCallback_(state);
+            odomExecutor_.markDelivered();
+        }
+    }
+
+    void handleRobotState(const raisin::raisin_interfaces::msg::RobotState::SharedPtr& msg) {
+        // Reused across messages: in steady state decoding allocates nothing
+        ExtendedRobotState& state = decodedExtState_;
+
+        state.x = msg->base_pos[0];
+        state.y = msg->base_pos[1];
+        state.z = msg->base_pos[2];
+
+        double qx = msg->base_quat[0];
+        double qy = msg->base_quat[1];
+        double qz = msg->base_quat[2];
+        double qw = msg->base_quat[3];
+        state.yaw = std::atan2(2.0 * (qw * qz + qx * qy),
+                               1.0 - 2.0 * (qy * qy + qz * qz));
+
+        state.vx = msg->base_lin_vel[0];
+        state.vy = msg->base_lin_vel[1];
+        state.omega = msg->base_ang_vel[2];
+
+        state.locomotion_state = msg->state;
+
+        state.voltage = msg->voltage;
+        state.current = msg->current;
+        state.max_voltage = msg->max_voltage;
+        state.min_voltage = msg->min_voltage;
+
+        state.body_temperature = msg->body_temperature;
+
+        state.joy_listen_type = msg->joy_listen_type;
+
+        internActuators(msg->actuator_states);
+        uint64_t errorMask = 0;
+        for (size_t i = 0; i < state.actuators.size(); ++i) {
+            const auto& act = msg->actuator_states[i];
+            ActuatorInfo& info = state.actuators[i];
+            info.status = act.status;
+            info.temperature = act.temperature;
+            info.position = act.position;
+            info.velocity = act.velocity;
+            info.effort = act.effort;
+            if (i < kActuatorErrorMaskBits && isActuatorStatusError(act.status)) {
+                errorMask |= uint64_t(1) << i;
+            }
+        }
+        state.actuator_error_mask = errorMask;
+
+        state.valid = true;
+
+        extFrame_.pack(state, actuatorTableGeneration_);
+        if (extFrame_.overflow()) {
+            // Pooled buffers keep their vector and string capacity
+            auto full = extStatePool_->acquire();
+            full->version = latestExtState_.version() + 1;
+            full->state = state;
+            extStateOverflow_.store(extStatePool_->publish(std::move(full)));
+        }
+        latestExtState_.store(extFrame_);
+        if (auto history = telemetryHistory_.load()) {
+            history->record(state);
+        }
+        if (auto battery = batteryEstimator_.load()) {
+            battery->update(state);
+        }
+        if (auto thermal = thermalForecaster_.load()) {
+            thermal->update(state);
+        }
+        robotStateExecutor_.markDecoded();
+
+        applyRobotStateCallbacks();
+        dispatchStatusChanges(state);
+        if (extRobotStateCallback_) {
+            extRobotStateCallback_(state);
+            robotStateExecutor_.markDelivered();
+        }
+    }
+
+    /**
+     * @brief Keep decodedExtState_.actuators in the message's actuator order
+     * Names are copied only on the first message or when the robot reports a
+     * different actuator list; otherwise this is a string compare per entry.
+     */
+    template <typename ActuatorStates>
+    void internActuators(const ActuatorStates& actuators) {
+        auto& table = decodedExtState_.actuators;
+        bool same = table.size() == actuators.size();
+        for (size_t i = 0; same && i < table.size(); ++i) {
+            same = table[i].name == actuators[i].name;
+        }
+        if (same) return;
+
+        table.resize(actuators.size());
+        actuatorStatus_.assign(actuators.size(), 0);
+        actuatorStatusKnown_ = false;
+        auto names = std::make_shared<detail::ActuatorNameTable>();
+        names->generation = ++actuatorTableGeneration_;
+        names->names.reserve(actuators.size());
+        for (size_t i = 0; i < table.size(); ++i) {
+            table[i].name = actuators[i].name;
+            names->names.push_back(actuators[i].name);
+        }
+        actuatorTable_.store(std::move(names));
+        std::cout << "[RaisinClient] Actuator table: " << table.size() << " actuators" << std::endl;
+    }
+
+    /**
+     * @brief Fire fault/recovery callbacks for status words that changed
+     * Integer compares only; strings are touched by the callbacks, if at all.
+     */
+    void dispatchStatusChanges(const ExtendedRobotState& state) {
+        const bool first = !actuatorStatusKnown_;
+        actuatorStatusKnown_ = true;
+        for (size_t i = 0; i < state.actuators.size(); ++i) {
+            const uint16_t status = state.actuators[i].status;
+            const uint16_t previous = actuatorStatus_[i];
+            if (!first && status == previous) continue;
+            actuatorStatus_[i] = status;
+
+            const bool wasError = !first && isActuatorStatusError(previous);
+            const bool isError = isActuatorStatusError(status);
+            if (!isError && !wasError) continue;
+
+            ActuatorStatusChange change;
+            change.index = i;
+            change.actuator = &state.actuators[i];
+            change.previous_status = first ? status : previous;
+            change.status = status;
+            change.first_seen = first;
+            if (isError && actuatorFaultCallback_) {
+                actuatorFaultCallback_(change);
+            } else if (!isError && actuatorRecoveredCallback_) {
+                actuatorRecoveredCallback_(change);
+            }
+        }
+    }
+
+    /// The cloud executor is shared, so subscriptions without executor options leave it alone
+    bool configureCloudExecutor(const std::optional<ExecutorOptions>& executor) {
+        if (!executor) return true;
+        if (!cloudExecutor_.configure(*executor)) {
+            std::cout << "[RaisinClient] Cannot reconfigure the cloud executor from its own callback" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    void configureCloudStats(const CloudStatsConfig& stats) {
+        if (stats.enabled) setCloudStats(stats);
+    }
+
+    /// Pick up a setCloudStats() change (cloud thread; the collector is never touched elsewhere)
+    /// Replace robot_state callbacks; the robot_state thread picks them up with its next message
+    template <typename EditFn>
+    void updateRobotStateCallbacks(const EditFn& edit) {
+        {
+            std::lock_guard<std::mutex> lock(robotStateCallbacksMutex_);
+            edit(pendingRobotStateCallbacks_);
+        }
+        robotStateCallbacksChanged_.store(true, std::memory_order_release);
+    }
+
+    void applyRobotStateCallbacks() {
+        if (!robotStateCallbacksChanged_.exchange(false, std::memory_order_acquire)) return;
+        std::lock_guard<std::mutex> lock(robotStateCallbacksMutex_);
+        extRobotStateCallback_ = pendingRobotStateCallbacks_.state;
+        actuatorFaultCallback_ = pendingRobotStateCallbacks_.fault;
+        actuatorRecoveredCallback_ = pendingRobotStateCallbacks_.recovered;
+    }
+
+    /// Edit the pending cloud subscriptions; the cloud thread picks them up before its next cloud
+    template <typename EditFn>
+    void updateCloudSubscriptions(const EditFn& edit) {
+        {
+            std::lock_guard<std::mutex> lock(cloudSubscriptionsMutex_);
+            edit(pendingCloudSubscriptions_);
+        }
+        cloudSubscriptionsChanged_.store(true, std::memory_order_release);
+    }
+
+    /// Cloud thread: take the latest subscribe calls into the handler's own copies
+    void applyCloudSubscriptions() {
+        if (!cloudSubscriptionsChanged_.exchange(false, std::memory_order_acquire)) return;
+        std::lock_guard<std::mutex> lock(cloudSubscriptionsMutex_);
+        const CloudSubscriptions& s = pendingCloudSubscriptions_;
+        cloudCallback_ = s.cloud;
+        cloudFilter_ = s.cloud_options.filter;
+        cloudVoxelFilter_.setConfig(s.cloud_options.downsample);
+        cloudParallelThreshold_ = s.cloud_options.parallel_decode_threshold;
+        decodeCloud_ = s.decode_cloud;
+        cloudViewCallback_ = s.view;
+        cloudSoACallback_ = s.soa;
+        soaFilter_ = s.soa_options.filter;
+        soaVoxelFilter_.setConfig(s.soa_options.downsample);
+        soaParallelThreshold_ = s.soa_options.parallel_decode_threshold;
+        groundCallback_ = s.ground;
+        groundSegmenter_.setConfig(s.ground_config);
+        groundFilter_ = s.ground_options.filter;
+        groundVoxelFilter_.setConfig(s.ground_options.downsample);
+        groundParallelThreshold_ = s.ground_options.parallel_decode_threshold;
+        rangeImageCallback_ = s.range_image;
+        rangeProjector_.setConfig(s.range_image_config);
+        surfaceCallback_ = s.surface;
+        surfaceProjector_.setConfig(s.surface_config.range_image);
+        normalEstimator_.setConfig(s.surface_config.normals);
+        planeExtractor_.setConfig(s.surface_config.planes);
+    }
+
+    void applyCloudStatsConfig() {
+        if (!statsConfigChanged_.exchange(false, std::memory_order_acquire)) return;
+        std::lock_guard<std::mutex> lock(statsConfigMutex_);
+        statsCollector_.setConfig(pendingStatsConfig_);
+        statsEnabled_.store(pendingStatsConfig_.enabled, std::memory_order_relaxed);
+        if (!pendingStatsConfig_.enabled) latestStats_.reset();   // in case this thread published after the request
+    }
+
+    void ensureRobotStateSubscriber() {
+        if (robotStateSubscriber_) {
+            return;
+        }
+        robotStateSubscriber_ = node_->createSubscriber<raisin::raisin_interfaces::msg::RobotState>(
+            "robot_state", connection_,
+            [this](const raisin::raisin_interfaces::msg::RobotState::SharedPtr& msg) {
+                robotStateExecutor_.post(msg);
+            });
+        std::cout << "[RaisinClient] Subscribed to robot_state" << std::endl;
+    }
+
+    void ensureCloudSubscriber() {
+        if (cloudSubscriber_) {
+            return;
+        }
+        cloudSubscriber_ = node_->createSubscriber<raisin::sensor_msgs::msg::PointCloud2>(
+            "/cloud_registered", connection_,
+            [this](const raisin::sensor_msgs::msg::PointCloud2::SharedPtr& msg) {
+                cloudExecutor_.post(msg);
+            });
+        std::cout << "[RaisinClient] Subscribed to /cloud_registered" << std::endl;
+    }
+
+    void handlePointCloud(const raisin::sensor_msgs::msg::PointCloud2::SharedPtr& msg) {
+        PointCloudView view(msg);
+        if (view.empty()) return;
+        applyCloudSubscriptions();
+
+        latestCloudView_.store(std::make_shared<const PointCloudView>(view));
+        bool delivered = false;
+
+        if (cloudViewCallback_) {
+            cloudViewCallback_(view);
+            delivered = true;
+        }
+
+        // Statistics ride along with the first decode below (a standalone pass if none runs)
+        applyCloudStatsConfig();
+        const bool statsEnabled = statsEnabled_.load(std::memory_order_relaxed);
+        CloudStatsCollector* stats = nullptr;
+        if (statsEnabled) {
+            const RobotState state = getRobotState();
+            statsCollector_.begin(state.x, state.y, state.z, state.yaw);
+            stats = &statsCollector_;
+        }
+        // The first decode that succeeds feeds the collector; a failed one hands it back
+        auto decodeWithStats = [&](auto& out, const CloudFilter* filter) {
+            CloudStatsCollector* collector = std::exchange(stats, nullptr);
+            const bool ok = cloudDecoder_.decode(view, out, filter, collector);
+            if (!ok) stats = collector;
+            return ok;
+        };
+
+        const std::string& cloudFrame = msg->header.frame_id;
+
+        // Vector form first, so the map, costmap and ground paths below can
+        // read it instead of decoding the message again
+        std::shared_ptr<const PointCloud> snapshot;
+        bool snapshotFiltered = false;   // snapshot holds exactly the points cloudFilter_ accepts
+        if (decodeCloud_ && view.hasXYZ() &&
+            updateFilterPose(cloudFilter_, cloudFrame)) {
+            // Decode into a recycled buffer, then publish it read-only
+            std::unique_ptr<PointCloud> cloud = cloudPool_->acquire();
+            cloudDecoder_.setParallelThreshold(cloudParallelThreshold_);
+            if (cloudFilter_.active() && cloudVoxelFilter_.config().enabled()) {
+                decodeWithStats(cloudScratch_, &cloudFilter_);
+                cloudVoxelFilter_.apply(cloudScratch_, cloud->points);
+            } else if (cloudVoxelFilter_.config().enabled()) {
+                cloudVoxelFilter_.apply(view, cloud->points);
+            } else {
+                // Large scans are decoded in parallel chunks
+                decodeWithStats(cloud->points, &cloudFilter_);
+                snapshotFiltered = true;
+            }
+            cloud->sequence = ++cloudSequence_;
+
+            snapshot = cloudPool_->publish(std::move(cloud));
+            latestCloud_.store(snapshot);
+        }
+        // Every point of the message, in message order
+        const bool snapshotComplete = snapshotFiltered && !cloudFilter_.active();
+
+        auto map = getLocalMap();
+        auto costmap = costmap_.load();
+        auto recorder = recorder_.load();
+        if (map || costmap || recorder) {
+            const RobotState state = latestState_.load();
+            if (map) {
+                map->updateRobotPose(state.x, state.y);
+                if (snapshotComplete) {
+                    map->insert(snapshot->points);
+                } else {
+                    map->insert(view);
+                }
+            }
+            if (costmap) {
+                if (snapshotComplete) {
+                    costmap->update(snapshot->points, state.x, state.y, state.z);
+                } else {
+                    costmap->update(view, state.x, state.y, state.z);
+                }
+            }
+            if (recorder) {
+                recorder->record(view, CloudPose::fromYaw(state.x, state.y, state.z, state.yaw));
+            }
+        }
+
+        if (auto index = getSpatialIndex()) {
+            index->update(view);
+        }
+
+        const bool soaReady = cloudSoACallback_ && updateFilterPose(soaFilter_, cloudFrame);
+        if (soaReady) cloudDecoder_.setParallelThreshold(soaParallelThreshold_);
+        const bool soaDecoded = soaReady && decodeWithStats(cloudSoA_, &soaFilter_);
+        if (soaDecoded) {
+            if (soaVoxelFilter_.config().enabled()) {
+                soaVoxelFilter_.apply(cloudSoA_, cloudSoAReduced_);
+                cloudSoACallback_(cloudSoAReduced_);
+            } else {
+                cloudSoACallback_(cloudSoA_);
+            }
+            delivered = true;
+        }
+
+        if (rangeImageCallback_) {
+            const RobotState state = getRobotState();
+            rangeProjector_.project(view, state.x, state.y, state.z, state.yaw, rangeImage_);
+            rangeImageCallback_(rangeImage_);
+            delivered = true;
+        }
+
+        if (surfaceCallback_) {
+            const RobotState state = getRobotState();
+            surfaceProjector_.project(view, state.x, state.y, state.z, state.yaw, surfaceImage_);
+            normalEstimator_.compute(surfaceImage_, state.x, state.y, state.z, surfaceNormals_);
+            planeExtractor_.extract(surfaceImage_, surfaceNormals_, state.x, state.y, state.z, surfacePlanes_);
+            surfaceCallback_(surfaceImage_, surfaceNormals_, surfacePlanes_);
+            delivered = true;
+        }
+
+        const PointCloudSoA* groundDecoded = nullptr;
+        if (groundCallback_ && updateFilterPose(groundFilter_, cloudFrame)) {
+            if (soaDecoded && soaFilter_ == groundFilter_) {
+                groundDecoded = &cloudSoA_;   // the SoA callback does not modify it
+            } else if (snapshotFiltered && cloudFilter_ == groundFilter_ && cloudDecoder_.positionsOnly(view)) {
+                // No channel beyond x/y/z to lose: transpose the vector form
+                copyToSoA(snapshot->points, groundInput_);
+                groundDecoded = &groundInput_;
+            } else {
+                cloudDecoder_.setParallelThreshold(groundParallelThreshold_);
+                if (decodeWithStats(groundInput_, &groundFilter_)) groundDecoded = &groundInput_;
+            }
+        }
+        if (groundDecoded) {
+            const PointCloudSoA* input = groundDecoded;
+            if (groundVoxelFilter_.config().enabled()) {
+                groundVoxelFilter_.apply(*groundDecoded, groundReduced_);
+                input = &groundReduced_;
+            }
+            const RobotState state = getRobotState();
+            groundSegmenter_.segment(*input, state.x, state.y, state.z, groundPoints_, obstaclePoints_);
+            groundCallback_(groundPoints_, obstaclePoints_);
+            delivered = true;
+        }
+
+        // No SDK lock is held here; a slow callback only delays this topic
+        if (snapshot && cloudCallback_) {
+            cloudCallback_(snapshot->points);
+            delivered = true;
+        }
+
+        if (statsEnabled) {
+            bool fed = stats == nullptr;   // a decode above already fed the collector
+            if (stats && view.hasXYZ()) {
+                statsCollector_.add(view);
+                fed = true;
+            }
+            if (fed) {   // no x/y/z to read: keep the previous statistics
+                std::unique_ptr<CloudStats> frameStats = statsPool_->acquire();
+                statsCollector_.finish(*frameStats);
+                latestStats_.store(statsPool_->publish(std::move(frameStats)));
+            }
+        }
+
+        cloudExecutor_.markDecoded();
+        if (delivered) cloudExecutor_.markDelivered();
+    }
+
+    /// x/y/z-only SoA copy of points, reusing out's capacity
+    static void copyToSoA(const std::vector<Point3D>& points, PointCloudSoA& out) {
+        out.has_intensity = out.has_ring = out.has_time = false;
+        out.resize(points.size());
+        for (size_t i = 0; i < points.size(); ++i) {
+            out.x[i] = points[i].x;
+            out.y[i] = points[i].y;
+            out.z[i] = points[i].z;
+        }
+        std::fill(out.intensity.begin(), out.intensity.end(), 0.0f);
+    }
+
+    /**
+     * @brief Place a robot-relative filter at the robot's pose in the cloud's frame
+     *
+     * A cloud in the odometry frame (or with no frame_id) uses the latest
+     * odometry pose; a cloud already in the robot body frame needs none.
+     * @return false, warning once, if an active filter has no pose for
+     *         cloudFrame (no odometry yet, or an unrelated frame); the cloud
+     *         is then dropped for this subscription rather than filtered
+     *         around the origin
+     */
+    bool updateFilterPose(CloudFilter& filter, const std::string& cloudFrame) {
+        if (!filter.active() || !filter.isRobotRelative()) return true;
+        const auto frames = odomFrames_.load();
+        const RobotState state = latestState_.load();
+        if (frames && !cloudFrame.empty() && cloudFrame == frames->child) {
+            filter.setRobotPose(0.0, 0.0, 0.0, 0.0);
+        } else if (!state.valid) {
+            if (!filterPoseWarned_) {
+                std::cout << "[RaisinClient] Robot-relative cloud filter has no odometry yet; "
+                          << "dropping clouds until it arrives" << std::endl;
+            }
+            filterPoseWarned_ = true;
+            return false;
+        } else if (frames && !cloudFrame.empty() && !frames->parent.empty() && cloudFrame != frames->parent) {
+            if (!filterPoseWarned_) {
+                std::cout << "[RaisinClient] Cloud frame '" << cloudFrame << "' is neither odometry frame '"
+                          << frames->parent << "' nor '" << frames->child
+                          << "'; dropping clouds for the robot-relative filter" << std::endl;
+            }
+            filterPoseWarned_ = true;
+            return false;
+        } else {
+            filter.setRobotPose(state.x, state.y, state.z, state.yaw);
+        }
+        filterPoseWarned_ = false;
+        return true;
+    }
+
     void ensureRefineWaypointsClient() {
         if (!refineWaypointsClient_) {
             refineWaypointsClient_ = node_->createClient<raisin::raisin_interfaces::srv::RefineWaypoints>(
@@ -0,0 +1,203 @@
+/**
+ * @file range_image.hpp
+ * @brief Spherical range-image projection of point clouds
+ *
+ * RangeImageProjector maps every point to an (azimuth, elevation) pixel
+ * around the sensor origin, keeping the nearest point per pixel. The
+ * resulting RangeImage stores range, position and source index per pixel,
+ * so neighbours of a point are simply the adjacent pixels: normal
+ * estimation and clustering become O(1) lookups instead of tree searches.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "raisin_sdk/point_cloud.hpp"
+#include "raisin_sdk/point_cloud_soa.hpp"
+
+namespace raisin_sdk {
+
+/**
+ * @brief Range image settings
+ */
+struct RangeImageConfig {
+    uint32_t width = 1024;             ///< Azimuth columns over 360 degrees
+    uint32_t height = 64;              ///< Elevation rows
+    float min_elevation_deg = -25.0f;  ///< Bottom edge of the lowest row
+    float max_elevation_deg = 15.0f;   ///< Top edge of the highest row
+    float min_range = 0.3f;            ///< Closer points are dropped (self hits)
+    float max_range = 100.0f;          ///< Farther points are dropped
+    bool use_ring = true;              ///< Use the ring channel as row when the cloud has one
+};
+
+/**
+ * @brief Projected cloud, row-major with row 0 at the lowest elevation
+ *
+ * Column 0 points along the sensor's +X axis and columns increase
+ * counter-clockwise. Empty pixels have index -1 and infinite range.
+ */
+struct RangeImage {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<float> range;     ///< Distance from the sensor origin
+    std::vector<float> x;         ///< Point position in the cloud's frame
+    std::vector<float> y;
+    std::vector<float> z;
+    std::vector<int32_t> index;   ///< Source point index, -1 if empty
+    std::vector<int32_t> pixel;   ///< Pixel of each source point, -1 if dropped or hidden
+
+    size_t pixelIndex(uint32_t col, uint32_t row) const { return static_cast<size_t>(row) * width + col; }
+    bool valid(uint32_t col, uint32_t row) const { return index[pixelIndex(col, row)] >= 0; }
+
+    /// Column offset with azimuth wrap-around
+    uint32_t wrapColumn(int64_t col) const {
+        const int64_t w = width;
+        return static_cast<uint32_t>(((col % w) + w) % w);
+    }
+
+    /**
+     * @brief Call fn(pixel) for valid pixels within a (2*dc+1) x (2*dr+1) window
+     * Columns wrap around; rows are clipped. The centre pixel is included.
+     * Does nothing on an empty image.
+     */
+    template <typename Fn>
+    void forEachNeighbor(uint32_t col, uint32_t row, uint32_t dc, uint32_t dr, const Fn& fn) const {
+        if (width == 0 || height == 0) return;   // height - 1 would wrap, wrapColumn would divide by 0
+        const uint32_t rowBegin = row > dr ? row - dr : 0;
+        const uint32_t rowEnd = std::min(height - 1, row + dr);
+        for (uint32_t r = rowBegin; r <= rowEnd; ++r) {
+            for (int64_t c = static_cast<int64_t>(col) - dc; c <= static_cast<int64_t>(col) + dc; ++c) {
+                const size_t p = pixelIndex(wrapColumn(c), r);
+                if (index[p] >= 0) fn(p);
+            }
+        }
+    }
+
+    void reset(uint32_t w, uint32_t h, size_t numPoints) {
+        width = w;
+        height = h;
+        const size_t n = static_cast<size_t>(w) * h;
+        range.assign(n, std::numeric_limits<float>::infinity());
+        x.resize(n);
+        y.resize(n);
+        z.resize(n);
+        index.assign(n, -1);
+        pixel.assign(numPoints, -1);
+    }
+};
+
+/**
+ * @brief Projects clouds into a RangeImage (buffers are reused by the caller)
+ *
+ * The sensor pose (ox, oy, oz, yaw) is given in the cloud's frame; for
+ * /cloud_registered this is the latest odometry pose.
+ *
+ * @code
+ * raisin_sdk::RangeImageProjector projector({2048, 32});
+ * raisin_sdk::RangeImage image;
+ * projector.project(cloud, state.x, state.y, state.z, state.yaw, image);
+ * image.forEachNeighbor(col, row, 1, 1, [&](size_t p) { ... image.x[p] ... });
+ * @endcode
+ */
+class RangeImageProjector {
+public:
+    explicit RangeImageProjector(const RangeImageConfig& config = {}) : config_(config) {}
+
+    const RangeImageConfig& config() const { return config_; }
+    void setConfig(const RangeImageConfig& config) { config_ = config; }
+
+    /// Project straight from the message (one pass, no intermediate cloud)
+    void project(const PointCloudView& cloud, double ox, double oy, double oz, double yaw,
+                 RangeImage& out) const {
+        if (!cloud.hasXYZ()) {
+            out.reset(config_.width, config_.height, 0);
+            return;
+        }
+        auto ring = cloud.field<uint16_t>("ring");
+        const bool useRing = config_.use_ring && ring.valid();
+        projectPoints(cloud.size(), [&cloud](size_t i) { return cloud.point(i); },
+                      [&ring, useRing](size_t i) { return useRing ? static_cast<int32_t>(ring[i]) : -1; },
+                      ox, oy, oz, yaw, out);
+    }
+
+    void project(const PointCloudSoA& cloud, double ox, double oy, double oz, double yaw,
+                 RangeImage& out) const {
+        const bool useRing = config_.use_ring && cloud.has_ring;
+        projectPoints(cloud.size(), [&cloud](size_t i) { return cloud.point(i); },
+                      [&cloud, useRing](size_t i) { return useRing ? static_cast<int32_t>(cloud.ring[i]) : -1; },
+                      ox, oy, oz, yaw, out);
+    }
+
+    void project(const std::vector<Point3D>& cloud, double ox, double oy, double oz, double yaw,
+                 RangeImage& out) const {
+        projectPoints(cloud.size(), [&cloud](size_t i) { return cloud[i]; },
+                      [](size_t) { return -1; }, ox, oy, oz, yaw, out);
+    }
+
+private:
+    RangeImageConfig config_;
+
+    template <typename PointFn, typename RingFn>
+    void projectPoints(size_t n, const PointFn& pointAt, const RingFn& ringAt,
+                       double ox, double oy, double oz, double yaw, RangeImage& out) const {
+        constexpr float kTwoPi = 6.283185307179586f;
+        constexpr float kDegToRad = 0.017453292519943295f;
+        const uint32_t width = std::max<uint32_t>(config_.width, 1);
+        const uint32_t height = std::max<uint32_t>(config_.height, 1);
+        out.reset(width, height, n);
+
+        const float fx = static_cast<float>(ox);
+        const float fy = static_cast<float>(oy);
+        const float fz = static_cast<float>(oz);
+        const float c = static_cast<float>(std::cos(yaw));
+        const float s = static_cast<float>(std::sin(yaw));
+        const float minElevation = config_.min_elevation_deg * kDegToRad;
+        const float rowScale = height / ((config_.max_elevation_deg - config_.min_elevation_deg) * kDegToRad);
+        const float colScale = width / kTwoPi;
+
+        for (size_t i = 0; i < n; ++i) {
+            const Point3D p = pointAt(i);
+            const float wx = p.x - fx;
+            const float wy = p.y - fy;
+            const float dz = p.z - fz;
+            const float dx = c * wx + s * wy;    // into the sensor heading
+            const float dy = -s * wx + c * wy;
+            const float horizontal = std::sqrt(dx * dx + dy * dy);
+            const float range = std::sqrt(horizontal * horizontal + dz * dz);
+            if (!(range >= config_.min_range && range <= config_.max_range)) continue;   // also drops NaN
+
+            float azimuth = std::atan2(dy, dx);
+            if (azimuth < 0.0f) azimuth += kTwoPi;
+            const uint32_t col = std::min(static_cast<uint32_t>(azimuth * colScale), width - 1);
+
+            int32_t row = ringAt(i);
+            if (row < 0) {
+                const float elevation = std::atan2(dz, horizontal);
+                const float fr = std::floor((elevation - minElevation) * rowScale);
+                if (fr < 0.0f || fr >= static_cast<float>(height)) continue;
+                row = static_cast<int32_t>(fr);
+            } else if (row >= static_cast<int32_t>(height)) {
+                continue;
+            }
+
+            // Nearest point wins the pixel
+            const size_t pix = out.pixelIndex(col, static_cast<uint32_t>(row));
+            if (range >= out.range[pix]) continue;
+            if (out.index[pix] >= 0) out.pixel[out.index[pix]] = -1;
+            out.range[pix] = range;
+            out.x[pix] = p.x;
+            out.y[pix] = p.y;
+            out.z[pix] = p.z;
+            out.index[pix] = static_cast<int32_t>(i);
+            out.pixel[i] = static_cast<int32_t>(pix);
+        }
+    }
+};
+
+}  // namespace raisin_sdk
@@ -0,0 +1,539 @@
+/**
+ * @file registration.hpp
+ * @brief Scan-to-map registration for seeding localization
+ *
+ * ScanMatcher caches a voxelized copy of the site map with a KD-tree and
+ * per-point normals. match() scores a yaw/x/y grid of hypotheses around a
+ * rough guess against a coarse occupancy grid of the map, then refines the
+ * best few with multithreaded point-to-plane ICP over x, y, z and yaw. The
+ * resulting pose can be passed to RaisinClient::setInitialPose().
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "raisin_sdk/normals.hpp"
+#include "raisin_sdk/parallel.hpp"
+#include "raisin_sdk/pcd_file.hpp"
+#include "raisin_sdk/point_cloud.hpp"
+#include "raisin_sdk/spatial_index.hpp"
+#include "raisin_sdk/voxel_grid.hpp"
+
+namespace raisin_sdk {
+
+/**
+ * @brief Planar robot pose (z is kept for the ICP refinement)
+ */
+struct RegistrationPose {
+    double x = 0.0;
+    double y = 0.0;
+    double z = 0.0;
+    double yaw = 0.0;
+};
+
+/**
+ * @brief Registration settings
+ */
+struct ScanMatcherConfig {
+    float map_voxel_size = 0.2f;       ///< Resolution of the cached map
+    float scan_voxel_size = 0.3f;      ///< Scan downsampling before matching
+    size_t max_scan_points = 1500;     ///< Scan points used by ICP (evenly subsampled)
+    size_t coarse_scan_points = 400;   ///< Scan points used to score grid hypotheses
+    float max_range = 40.0f;           ///< Scan points farther from the robot are ignored
+    float search_radius = 2.0f;        ///< Grid search covers guess +/- this in x and y (m)
+    float position_step = 0.5f;        ///< Grid step in x/y, also the coarse occupancy resolution
+    float yaw_range = 3.14159265f;     ///< Grid search covers guess +/- this yaw (rad)
+    float yaw_step = 0.0872665f;       ///< Grid step in yaw (5 degrees)
+    size_t refine_candidates = 2;      ///< Best grid hypotheses refined by ICP
+    int icp_iterations = 20;
+    float icp_max_distance = 1.0f;     ///< Correspondence gate of the first iteration; shrinks to inlier_distance
+    float inlier_distance = 0.3f;      ///< Points closer than this to the map count towards fitness
+    float min_fitness = 0.5f;          ///< Lowest fitness reported as success
+    size_t normal_neighbors = 8;       ///< Map neighbours used per normal
+};
+
+/**
+ * @brief Outcome of ScanMatcher::match()
+ */
+struct RegistrationResult {
+    bool success = false;       ///< fitness >= min_fitness
+    RegistrationPose pose;      ///< Robot pose in the map frame
+    float fitness = 0.0f;       ///< Fraction of scan points within inlier_distance of the map
+    float rmse = 0.0f;          ///< Point-to-plane RMS error of the inliers (m)
+    int iterations = 0;         ///< ICP iterations of the chosen candidate
+    double elapsed_ms = 0.0;
+    std::string message;
+};
+
+namespace detail {
+
+/// Solve the symmetric positive 4x4 system h x = b in place (Gaussian elimination); false if singular
+inline bool solve4(double h[4][4], double b[4], double x[4]) {
+    for (int col = 0; col < 4; ++col) {
+        int pivot = col;
+        for (int r = col + 1; r < 4; ++r) {
+            if (std::fabs(h[r][col]) > std::fabs(h[pivot][col])) pivot = r;
+        }
+        if (std::fabs(h[pivot][col]) < 1e-12) return false;
+        if (pivot != col) {
+            std::swap(h[pivot], h[col]);
+            std::swap(b[pivot], b[col]);
+        }
+        for (int r = col + 1; r < 4; ++r) {
+            const double f = h[r][col] / h[col][col];
+            for (int c = col; c < 4; ++c) h[r][c] -= f * h[col][c];
+            b[r] -= f * b[col];
+        }
+    }
+    for (int r = 3; r >= 0; --r) {
+        double sum = b[r];
+        for (int c = r + 1; c < 4; ++c) sum -= h[r][c] * x[c];
+        x[r] = sum / h[r][r];
+    }
+    return true;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Matches scans against a cached site map
+ *
+ * setMap() is the expensive part (downsampling, KD-tree, normals) and is
+ * done once per map. match() reuses its buffers and is not thread-safe;
+ * use one matcher per thread.
+ *
+ * @code
+ * raisin_sdk::ScanMatcher matcher;
+ * raisin_sdk::PcdFile site;
+ * site.open("site.pcd");
+ * matcher.setMap(site);
+ * auto result = matcher.match(scan, odomPose, {x0, y0, 0.0, yaw0});
+ * if (result.success) client.setInitialPose(result.pose.x, result.pose.y, result.pose.yaw);
+ * @endcode
+ */
+class ScanMatcher {
+public:
+    explicit ScanMatcher(const ScanMatcherConfig& config = {}, std::shared_ptr<WorkerPool> pool = nullptr)
+        : config_(config), pool_(pool ? std::move(pool) : WorkerPool::shared()) {}
+
+    const ScanMatcherConfig& config() const { return config_; }
+
+    /// Change search/ICP settings (map_voxel_size and normal_neighbors apply on the next setMap())
+    void setConfig(const ScanMatcherConfig& config) { config_ = config; }
+
+    /// Cache a map given as points
+    void setMap(const std::vector<Point3D>& map) {
+        VoxelGridConfig voxel;
+        voxel.voxel_size = config_.map_voxel_size;
+        VoxelGridFilter filter(voxel, pool_);
+        filter.apply(map, mapPoints_);
+        indexMap();
+    }
+
+    /// Cache a map read from a (memory-mapped) PCD file
+    void setMap(const PcdFile& map) {
+        VoxelGridConfig voxel;
+        voxel.voxel_size = config_.map_voxel_size;
+        VoxelGridFilter filter(voxel, pool_);
+        filter.apply(map.size(), [&map](size_t i) { return map.point(i); }, [this](size_t count) {
+            mapPoints_.resize(count);
+            return mapPoints_.data();
+        });
+        indexMap();
+    }
+
+    bool hasMap() const { return !tree_.empty(); }
+    size_t mapSize() const { return tree_.size(); }
+
+    /**
+     * @brief Register a scan against the map
+     * @param scan        Scan points in any frame (e.g. /cloud_registered in odom)
+     * @param scanOrigin  Robot pose in the scan's frame (e.g. the odometry pose)
+     * @param guess       Rough robot pose in the map; the grid search covers its surroundings
+     */
+    RegistrationResult match(const std::vector<Point3D>& scan, const RegistrationPose& scanOrigin,
+                             const RegistrationPose& guess) {
+        return run([&]() { scanFilter_.apply(scan, scanReduced_); }, scanOrigin, guess);
+    }
+
+    /// Same, reading straight from a received message
+    RegistrationResult match(const PointCloudView& scan, const RegistrationPose& scanOrigin,
+                             const RegistrationPose& guess) {
+        return run([&]() { scanFilter_.apply(scan, scanReduced_); }, scanOrigin, guess);
+    }
+
+private:
+    struct Candidate {
+        uint32_t score = 0;
+        double x = 0.0, y = 0.0, yaw = 0.0;
+    };
+
+    /// Scan points as structure-of-arrays in the robot frame
+    struct ScanPoints {
+        std::vector<float> x, y, z;
+        size_t size() const { return x.size(); }
+        void resize(size_t n) { x.resize(n); y.resize(n); z.resize(n); }
+    };
+
+    ScanMatcherConfig config_;
+    std::shared_ptr<WorkerPool> pool_;
+
+    // Cached map
+    std::vector<Point3D> mapPoints_;
+    KdTree tree_;
+    std::vector<float> normals_;   ///< 3 per map point (original order); all zero if not planar
+
+    // match() scratch
+    VoxelGridFilter scanFilter_;
+    std::vector<Point3D> scanReduced_;
+    ScanPoints scan_;
+    ScanPoints coarse_;
+    std::vector<uint8_t> occupancy_;
+    std::vector<Candidate> candidates_;
+
+    /// Build the KD-tree and estimate a normal per map point
+    void indexMap() {
+        tree_.build(mapPoints_);
+        normals_.assign(mapPoints_.size() * 3, 0.0f);
+        const size_t k = std::max<size_t>(config_.normal_neighbors, 3);
+        pool_->parallelForRange(tree_.size(), 4096, [&](size_t begin, size_t end) {
+            std::vector<Neighbor> neighbors;
+            for (size_t i = begin; i < end; ++i) {
+                const Point3D& p = tree_.points()[i];
+                tree_.nearest(p, k, neighbors, 4.0f * config_.map_voxel_size);
+                detail::CovarianceAccumulator acc;
+                for (const auto& n : neighbors) acc.add(n.point.x, n.point.y, n.point.z);
+                double values[3], vectors[3][3];
+                if (!acc.solve(values, vectors) || values[1] <= 3.0 * values[0]) continue;   // not a surface
+
+                float* normal = &normals_[3 * size_t(neighbors.front().index)];
+                normal[0] = static_cast<float>(vectors[0][0]);
+                normal[1] = static_cast<float>(vectors[1][0]);
+                normal[2] = static_cast<float>(vectors[2][0]);
+            }
+        });
+    }
+
+    template <typename ReduceFn>
+    RegistrationResult run(const ReduceFn& reduceScan, const RegistrationPose& scanOrigin,
+                           const RegistrationPose& guess) {
+        const auto start = std::chrono::steady_clock::now();
+        RegistrationResult result;
+        result.pose = guess;
+        auto finish = [&](const std::string& message) {
+            result.message = message;
+            result.elapsed_ms = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+            return result;
+        };
+        if (!hasMap()) return finish("No map: call setMap() first");
+
+        VoxelGridConfig voxel;
+        voxel.voxel_size = config_.scan_voxel_size;
+        scanFilter_.setConfig(voxel);
+        reduceScan();
+        prepareScan(scanOrigin);
+        if (scan_.size() < 10) return finish("Too few scan points");
+
+        coarseSearch(guess);
+        if (candidates_.empty()) return finish("Grid search found no overlap with the map");
+
+        bool first = true;
+        for (const Candidate& candidate : candidates_) {
+            RegistrationResult refined;
+            refined.pose = {candidate.x, candidate.y, guess.z, candidate.yaw};
+            refine(refined);
+            if (first || refined.fitness > result.fitness ||
+                (refined.fitness == result.fitness && refined.rmse < result.rmse)) {
+                result = refined;
+                first = false;
+            }
+        }
+        result.success = result.fitness >= config_.min_fitness;
+        return finish(result.success ? "Matched" : "Fitness below min_fitness");
+    }
+
+    /// Express the reduced scan in the robot frame and subsample it evenly
+    void prepareScan(const RegistrationPose& origin) {
+        const float c = static_cast<float>(std::cos(origin.yaw));
+        const float s = static_cast<float>(std::sin(origin.yaw));
+        const float ox = static_cast<float>(origin.x);
+        const float oy = static_cast<float>(origin.y);
+        const float oz = static_cast<float>(origin.z);
+        const float maxRangeSq = config_.max_range * config_.max_range;
+
+        ScanPoints& all = coarse_;   // temporary: all usable points
+        all.resize(0);
+        for (const Point3D& p : scanReduced_) {
+            const float wx = p.x - ox;
+            const float wy = p.y - oy;
+            const float lx = c * wx + s * wy;
+            const float ly = -s * wx + c * wy;
+            const float lz = p.z - oz;
+            if (!(lx * lx + ly * ly + lz * lz <= maxRangeSq)) continue;   // also drops NaN
+            all.x.push_back(lx);
+            all.y.push_back(ly);
+            all.z.push_back(lz);
+        }
+
+        auto subsample = [&all](ScanPoints& out, size_t limit) {
+            const size_t n = all.size();
+            const size_t count = std::min(n, std::max<size_t>(limit, 1));
+            out.resize(count);
+            for (size_t i = 0; i < count; ++i) {
+                const size_t j = i * n / count;
+                out.x[i] = all.x[j];
+                out.y[i] = all.y[j];
+                out.z[i] = all.z[j];
+            }
+        };
+        subsample(scan_, config_.max_scan_points);
+        ScanPoints coarse;
+        subsample(coarse, config_.coarse_scan_points);
+        coarse_ = std::move(coarse);
+    }
+
+    /// Score every (yaw, x, y) hypothesis by how many coarse scan points land on occupied cells
+    void coarseSearch(const RegistrationPose& guess) {
+        candidates_.clear();
+        const float res = std::max(config_.position_step, 0.05f);
+        const float inv = 1.0f / res;
+
+        // Dense occupancy around the guess, big enough for every hypothesis
+        float zMin = std::numeric_limits<float>::max(), zMax = std::numeric_limits<float>::lowest();
+        float reach = 0.0f;
+        for (size_t i = 0; i < coarse_.size(); ++i) {
+            zMin = std::min(zMin, coarse_.z[i]);
+            zMax = std::max(zMax, coarse_.z[i]);
+            reach = std::max(reach, std::sqrt(coarse_.x[i] * coarse_.x[i] + coarse_.y[i] * coarse_.y[i]));
+        }
+        const float half = config_.search_radius + reach + 2.0f * res;
+        const float x0 = static_cast<float>(guess.x) - half;
+        const float y0 = static_cast<float>(guess.y) - half;
+        const float z0 = static_cast<float>(guess.z) + zMin - 2.0f * res;
+        const int nx = static_cast<int>(std::ceil(2.0f * half * inv)) + 1;
+        const int ny = nx;
+        const int nz = static_cast<int>(std::ceil((zMax - zMin + 4.0f * res) * inv)) + 1;
+        occupancy_.assign(static_cast<size_t>(nx) * ny * nz, 0);
+        auto cell = [nx, ny](int ix, int iy, int iz) { return (static_cast<size_t>(iz) * ny + iy) * nx + ix; };
+
+        for (const Point3D& p : tree_.points()) {
+            const int ix = static_cast<int>(std::floor((p.x - x0) * inv));
+            const int iy = static_cast<int>(std::floor((p.y - y0) * inv));
+            const int iz = static_cast<int>(std::floor((p.z - z0) * inv));
+            if (ix < 0 || iy < 0 || iz < 0 || ix >= nx || iy >= ny || iz >= nz) continue;
+            occupancy_[cell(ix, iy, iz)] = 1;
+        }
+        dilate(nx, ny, nz);
+
+        // Grid of hypotheses; each yaw is one task
+        const int steps = std::max(0, static_cast<int>(std::floor(config_.search_radius / res)));
+        const int side = 2 * steps + 1;
+        const float yawStep = std::max(config_.yaw_step, 1e-3f);
+        const int yawSteps = std::max(0, static_cast<int>(std::floor(config_.yaw_range / yawStep)));
+        const int numYaw = std::min(2 * yawSteps + 1, static_cast<int>(std::ceil(6.2831853f / yawStep)));
+        std::vector<uint32_t> scores(static_cast<size_t>(numYaw) * side * side, 0);
+
+        pool_->parallelFor(static_cast<size_t>(numYaw), [&](size_t t) {
+            const double yaw = guess.yaw + (static_cast<int>(t) - yawSteps) * yawStep;
+            const float c = static_cast<float>(std::cos(yaw));
+            const float s = static_cast<float>(std::sin(yaw));
+            const size_t n = coarse_.size();
+            std::vector<float> rx(n), ry(n);
+            std::vector<int> iz(n);
+            for (size_t i = 0; i < n; ++i) {
+                rx[i] = (c * coarse_.x[i] - s * coarse_.y[i] + static_cast<float>(guess.x) - x0) * inv;
+                ry[i] = (s * coarse_.x[i] + c * coarse_.y[i] + static_cast<float>(guess.y) - y0) * inv;
+                iz[i] = static_cast<int>(std::floor((coarse_.z[i] + static_cast<float>(guess.z) - z0) * inv));
+            }
+            for (int gy = 0; gy < side; ++gy) {
+                for (int gx = 0; gx < side; ++gx) {
+                    const float dx = static_cast<float>(gx - steps);
+                    const float dy = static_cast<float>(gy - steps);
+                    uint32_t score = 0;
+                    for (size_t i = 0; i < n; ++i) {
+                        const int ix = static_cast<int>(rx[i] + dx);
+                        const int iy = static_cast<int>(ry[i] + dy);
+                        const bool inside = ix >= 0 && iy >= 0 && iz[i] >= 0 && ix < nx && iy < ny && iz[i] < nz;
+                        score += inside ? occupancy_[cell(inside ? ix : 0, inside ? iy : 0, inside ? iz[i] : 0)] : 0;
+                    }
+                    scores[(t * side + gy) * side + gx] = score;
+                }
+            }
+        });
+
+        // Best hypotheses, skipping near-duplicates of ones already kept
+        std::vector<uint32_t> order(scores.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = static_cast<uint32_t>(i);
+        const size_t keep = std::max<size_t>(config_.refine_candidates, 1);
+        std::partial_sort(order.begin(), order.begin() + std::min(order.size(), keep * 16), order.end(),
+                          [&scores](uint32_t a, uint32_t b) { return scores[a] > scores[b]; });
+        for (size_t o = 0; o < std::min(order.size(), keep * 16) && candidates_.size() < keep; ++o) {
+            const uint32_t i = order[o];
+            if (scores[i] == 0) break;
+            Candidate candidate;
+            candidate.score = scores[i];
+            const int t = static_cast<int>(i / (side * side));
+            candidate.yaw = guess.yaw + (t - yawSteps) * yawStep;
+            candidate.x = guess.x + (static_cast<int>(i % side) - steps) * res;
+            candidate.y = guess.y + (static_cast<int>((i / side) % side) - steps) * res;
+            bool duplicate = false;
+            for (const Candidate& kept : candidates_) {
+                duplicate |= std::fabs(kept.x - candidate.x) <= res && std::fabs(kept.y - candidate.y) <= res &&
+                             std::fabs(std::remainder(kept.yaw - candidate.yaw, 6.283185307179586)) <= 2.0 * yawStep;
+            }
+            if (!duplicate) candidates_.push_back(candidate);
+        }
+    }
+
+    /// Grow occupied cells by one in every direction (separable max filter)
+    void dilate(int nx, int ny, int nz) {
+        std::vector<uint8_t> tmp(occupancy_.size());
+        const int dims[3] = {nx, ny, nz};
+        const size_t strides[3] = {1, static_cast<size_t>(nx), static_cast<size_t>(nx) * ny};
+        for (int axis = 0; axis < 3; ++axis) {
+            const size_t stride = strides[axis];
+            const int len = dims[axis];
+            for (size_t i = 0; i < occupancy_.size(); ++i) {
+                const int coord = static_cast<int>((i / stride) % len);
+                uint8_t v = occupancy_[i];
+                if (coord > 0) v |= occupancy_[i - stride];
+                if (coord + 1 < len) v |= occupancy_[i + stride];
+                tmp[i] = v;
+            }
+            occupancy_.swap(tmp);
+        }
+    }
+
+    /// Point-to-plane Gauss-Newton over (x, y, z, yaw)
+    void refine(RegistrationResult& result) {
+        RegistrationPose pose = result.pose;
+        const size_t n = scan_.size();
+        const size_t chunks = pool_->concurrency();
+        struct Accumulator {
+            double h[4][4];
+            double b[4];
+            size_t count;
+        };
+        std::vector<Accumulator> acc(chunks);
+
+        int iteration = 0;
+        float gate = config_.icp_max_distance;
+        for (; iteration < config_.icp_iterations; ++iteration) {
+            const float c = static_cast<float>(std::cos(pose.yaw));
+            const float s = static_cast<float>(std::sin(pose.yaw));
+            const float tx = static_cast<float>(pose.x);
+            const float ty = static_cast<float>(pose.y);
+            const float tz = static_cast<float>(pose.z);
+
+            pool_->parallelFor(chunks, [&](size_t chunk) {
+                Accumulator& a = acc[chunk];
+                a = Accumulator{};
+                std::vector<Neighbor> nearest;
+                const size_t begin = chunk * n / chunks;
+                const size_t end = (chunk + 1) * n / chunks;
+                for (size_t i = begin; i < end; ++i) {
+                    const float rx = c * scan_.x[i] - s * scan_.y[i];
+                    const float ry = s * scan_.x[i] + c * scan_.y[i];
+                    const Point3D p{rx + tx, ry + ty, scan_.z[i] + tz};
+                    tree_.nearest(p, 1, nearest, gate);
+                    if (nearest.empty()) continue;
+                    const float* normal = &normals_[3 * size_t(nearest.front().index)];
+                    if (normal[0] == 0.0f && normal[1] == 0.0f && normal[2] == 0.0f) continue;
+
+                    const Point3D& q = nearest.front().point;
+                    const double residual = normal[0] * (p.x - q.x) + normal[1] * (p.y - q.y) + normal[2] * (p.z - q.z);
+                    const double j[4] = {normal[0], normal[1], normal[2], normal[1] * rx - normal[0] * ry};
+                    for (int r = 0; r < 4; ++r) {
+                        for (int col = r; col < 4; ++col) a.h[r][col] += j[r] * j[col];
+                        a.b[r] -= j[r] * residual;
+                    }
+                    ++a.count;
+                }
+            });
+
+            double h[4][4] = {};
+            double b[4] = {};
+            size_t count = 0;
+            for (const Accumulator& a : acc) {
+                for (int r = 0; r < 4; ++r) {
+                    for (int col = r; col < 4; ++col) h[r][col] += a.h[r][col];
+                    b[r] += a.b[r];
+                }
+                count += a.count;
+            }
+            if (count < 6) break;
+            for (int r = 0; r < 4; ++r) {
+                for (int col = 0; col < r; ++col) h[r][col] = h[col][r];
+                h[r][r] += 1e-6;   // keeps yaw solvable on degenerate (e.g. single-plane) scans
+            }
+
+            double delta[4];
+            if (!detail::solve4(h, b, delta)) break;
+            pose.x += delta[0];
+            pose.y += delta[1];
+            pose.z += delta[2];
+            pose.yaw += delta[3];
+            gate = std::max(config_.inlier_distance, gate * 0.7f);
+
+            const double step = std::sqrt(delta[0] * delta[0] + delta[1] * delta[1] + delta[2] * delta[2]);
+            if (step < 1e-3 && std::fabs(delta[3]) < 1e-4 && gate <= config_.inlier_distance) {
+                ++iteration;
+                break;
+            }
+        }
+
+        pose.yaw = std::remainder(pose.yaw, 6.283185307179586);
+        result.pose = pose;
+        result.iterations = iteration;
+        score(result);
+    }
+
+    /// Fitness (inlier fraction) and point-to-plane RMSE at result.pose
+    void score(RegistrationResult& result) {
+        const RegistrationPose& pose = result.pose;
+        const float c = static_cast<float>(std::cos(pose.yaw));
+        const float s = static_cast<float>(std::sin(pose.yaw));
+        const size_t n = scan_.size();
+        const size_t chunks = pool_->concurrency();
+        std::vector<size_t> inliers(chunks, 0);
+        std::vector<double> sumSq(chunks, 0.0);
+        pool_->parallelFor(chunks, [&](size_t chunk) {
+            std::vector<Neighbor> nearest;
+            for (size_t i = chunk * n / chunks; i < (chunk + 1) * n / chunks; ++i) {
+                const Point3D p{c * scan_.x[i] - s * scan_.y[i] + static_cast<float>(pose.x),
+                                s * scan_.x[i] + c * scan_.y[i] + static_cast<float>(pose.y),
+                                scan_.z[i] + static_cast<float>(pose.z)};
+                tree_.nearest(p, 1, nearest, config_.inlier_distance);
+                if (nearest.empty()) continue;
+                const Point3D& q = nearest.front().point;
+                const float* normal = &normals_[3 * size_t(nearest.front().index)];
+                const bool planar = normal[0] != 0.0f || normal[1] != 0.0f || normal[2] != 0.0f;
+                const double e = planar
+                    ? normal[0] * (p.x - q.x) + normal[1] * (p.y - q.y) + normal[2] * (p.z - q.z)
+                    : std::sqrt(static_cast<double>(nearest.front().distance_sq));
+                sumSq[chunk] += e * e;
+                ++inliers[chunk];
+            }
+        });
+        size_t total = 0;
+        double sum = 0.0;
+        for (size_t k = 0; k < chunks; ++k) {
+            total += inliers[k];
+            sum += sumSq[k];
+        }
+        result.fitness = n ? static_cast<float>(total) / n : 0.0f;
+        result.rmse = total ? static_cast<float>(std::sqrt(sum / total)) : 0.0f;
+    }
+};
+
+}  // namespace raisin_sdk
@@ -0,0 +1,231 @@
+/**
+ * @file robot_state.hpp
+ * @brief Robot, actuator and locomotion state types delivered by RaisinClient
+ *
+ * Kept apart from the client so telemetry consumers (history, estimators)
+ * can work on decoded states without pulling in raisin_network.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace raisin_sdk {
+
+/**
+ * @brief CiA402 Status Word values from motor driver
+ * These values indicate the motor driver state, not error codes.
+ */
+enum class CiA402StatusWord : uint16_t {
+    NOT_READY_TO_SWITCH_ON = 0,   ///< Initial state - driver not ready (**error**)
+    FAULT = 8,                     ///< Fault detected (**error**)
+    READY_TO_SWITCH_ON = 33,       ///< Driver ready (normal state before enable)
+    SWITCHED_ON = 35,              ///< Driver switched on (normal)
+    OPERATION_ENABLED = 39,        ///< Motor operational (normal running state)
+    ECAT_CONN_ERROR = 99           ///< EtherCAT connection error (**error**)
+};
+
+/**
+ * @brief Check if status word indicates an error
+ * Error states: NOT_READY(0), FAULT(8), ECAT_ERROR(99)
+ * Normal states: READY(33), SWITCHED_ON(35), ENABLED(39)
+ */
+inline bool isActuatorStatusError(uint16_t status) {
+    return status == static_cast<uint16_t>(CiA402StatusWord::FAULT) ||
+           status == static_cast<uint16_t>(CiA402StatusWord::ECAT_CONN_ERROR) ||
+           status == static_cast<uint16_t>(CiA402StatusWord::NOT_READY_TO_SWITCH_ON);
+}
+
+/// Actuators covered by ExtendedRobotState::actuator_error_mask
+constexpr size_t kActuatorErrorMaskBits = 64;
+
+/**
+ * @brief Get human-readable name for status word
+ */
+inline std::string getActuatorStatusName(uint16_t status) {
+    switch (status) {
+        case 0:  return "NOT_READY";
+        case 8:  return "FAULT";
+        case 33: return "READY";
+        case 35: return "SWITCHED_ON";
+        case 39: return "ENABLED";
+        case 99: return "ECAT_ERROR";
+        default: return "UNKNOWN(" + std::to_string(status) + ")";
+    }
+}
+
+/**
+ * @brief Robot state from odometry (map frame)
+ */
+struct RobotState {
+    double x = 0.0;        ///< X position in map frame
+    double y = 0.0;        ///< Y position in map frame
+    double z = 0.0;        ///< Z position in map frame
+    double yaw = 0.0;      ///< Yaw angle in radians
+    double vx = 0.0;       ///< Linear velocity X
+    double vy = 0.0;       ///< Linear velocity Y
+    double omega = 0.0;    ///< Angular velocity
+    bool valid = false;    ///< True when odometry is received
+};
+
+/**
+ * @brief Actuator (motor) information
+ */
+struct ActuatorInfo {
+    std::string name;           ///< Motor name (e.g., "FR_hip", "FL_thigh")
+    uint16_t status = 0;        ///< CiA402 status word (see CiA402StatusWord enum)
+    double temperature = 0.0;   ///< Motor temperature in Celsius
+    double position = 0.0;      ///< Joint position in radians
+    double velocity = 0.0;      ///< Joint velocity in rad/s
+    double effort = 0.0;        ///< Joint torque in Nm
+};
+
+/**
+ * @brief Locomotion state enum values
+ */
+enum class LocomotionState : int32_t {
+    COMM_DISABLED = 0,      ///< Communication disabled
+    COMM_ENABLED = 1,       ///< Communication enabled
+    MOTOR_READY = 2,        ///< Motors ready
+    MOTOR_COMMUTATION = 3,  ///< Motor commutation in progress
+    MOTOR_ENABLED = 4,      ///< Motors enabled
+    IN_TEST_MODE = 5,       ///< Test mode active
+    STANDING_MODE = 6,      ///< Robot is standing
+    IN_CONTROL = 7,         ///< Robot is under control (walking)
+    SITDOWN_MODE = 8,       ///< Robot is sitting down
+    MOTOR_DISABLED = 9      ///< Motors disabled
+};
+
+/**
+ * @brief Joy listen source type
+ */
+enum class JoySourceType : int32_t {
+    JOY = 0,           ///< Manual joystick control
+    VEL_CMD = 1,       ///< Autonomous velocity command
+    NUM_SOURCES = 2    ///< No source / disabled
+};
+
+/**
+ * @brief Extended robot state with full information from robot_state topic
+ */
+struct ExtendedRobotState {
+    // Position and velocity
+    double x = 0.0;
+    double y = 0.0;
+    double z = 0.0;
+    double yaw = 0.0;
+    double vx = 0.0;
+    double vy = 0.0;
+    double omega = 0.0;
+
+    // Locomotion state
+    int32_t locomotion_state = 0;   ///< See LocomotionState enum (0-9)
+
+    // Battery information
+    double voltage = 0.0;           ///< Current battery voltage
+    double current = 0.0;           ///< Current draw in Amps
+    double max_voltage = 0.0;       ///< Maximum voltage
+    double min_voltage = 0.0;       ///< Minimum voltage
+
+    // Temperature
+    double body_temperature = 0.0;  ///< Body temperature in Celsius
+
+    // Joy control state
+    int32_t joy_listen_type = 2;    ///< See JoySourceType enum
+
+    // Actuator states
+    std::vector<ActuatorInfo> actuators;
+    /// Bit i set when actuators[i] reported an error status in the decoded message
+    /// (first kActuatorErrorMaskBits actuators). Set once per message by RaisinClient;
+    /// editing actuators does not update it, the is/hasActuatorError() queries read the status words.
+    uint64_t actuator_error_mask = 0;
+
+    bool valid = false;
+
+    /// Get locomotion state as string
+    std::string getLocomotionStateName() const {
+        static const std::vector<std::string> names = {
+            "COMM_DISABLED", "COMM_ENABLED", "MOTOR_READY",
+            "MOTOR_COMMUTATION", "MOTOR_ENABLED", "IN_TEST_MODE",
+            "STANDING_MODE", "IN_CONTROL", "SITDOWN_MODE", "MOTOR_DISABLED"
+        };
+        if (locomotion_state >= 0 && locomotion_state < static_cast<int32_t>(names.size())) {
+            return names[locomotion_state];
+        }
+        return "UNKNOWN";
+    }
+
+    /// Get joy source type as string
+    std::string getJoySourceName() const {
+        switch (static_cast<JoySourceType>(joy_listen_type)) {
+            case JoySourceType::JOY: return "JOY (Manual)";
+            case JoySourceType::VEL_CMD: return "VEL_CMD (Autonomous)";
+            default: return "NONE";
+        }
+    }
+
+    /// Index of the named actuator in actuators, or -1
+    int findActuator(const std::string& name) const {
+        for (size_t i = 0; i < actuators.size(); ++i) {
+            if (actuators[i].name == name) return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    /// Check if robot is standing or walking
+    bool isOperational() const {
+        return locomotion_state == static_cast<int32_t>(LocomotionState::STANDING_MODE) ||
+               locomotion_state == static_cast<int32_t>(LocomotionState::IN_CONTROL);
+    }
+
+    /// Whether actuators[index] reports an error status
+    bool isActuatorError(size_t index) const {
+        return index < actuators.size() && isActuatorStatusError(actuators[index].status);
+    }
+
+    /// Check if any actuator has an error (integer compares only; no strings)
+    bool hasActuatorError() const {
+        for (const auto& act : actuators) {
+            if (isActuatorStatusError(act.status)) return true;
+        }
+        return false;
+    }
+
+    /// Get list of actuators with errors
+    std::vector<std::string> getActuatorsWithErrors() const {
+        std::vector<std::string> errorList;
+        for (const auto& act : actuators) {
+            if (isActuatorStatusError(act.status)) {
+                errorList.push_back(act.name + " (" + getActuatorStatusName(act.status) + ")");
+            }
+        }
+        return errorList;
+    }
+
+    /// Check if all actuators are in operational state
+    bool allActuatorsOperational() const {
+        for (const auto& act : actuators) {
+            if (act.status != static_cast<uint16_t>(CiA402StatusWord::OPERATION_ENABLED)) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief CiA402 status transition of one actuator
+ * Delivered by RaisinClient::onActuatorFault() / onActuatorRecovered().
+ */
+struct ActuatorStatusChange {
+    size_t index = 0;                        ///< Position in ExtendedRobotState::actuators
+    const ActuatorInfo* actuator = nullptr;  ///< Actuator after the change (valid during the callback)
+    uint16_t previous_status = 0;            ///< Status word before the change
+    uint16_t status = 0;                     ///< New status word
+    bool first_seen = false;                 ///< No earlier status: first message or new actuator list
+};
+
+}  // namespace raisin_sdk
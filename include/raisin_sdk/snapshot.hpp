@@ -0,0 +1,228 @@
+/**
+ * @file snapshot.hpp
+ * @brief Lock-free publication of immutable snapshots between threads
+ *
+ * The network thread builds a new object, publishes it as a
+ * std::shared_ptr<const T>, and readers grab the current pointer in O(1)
+ * without ever waiting on the writer or on user callbacks. Buffers of
+ * snapshots nobody references any more go back to a pool for reuse.
+ * Small fixed-size values (poses, state frames) go through SeqLock instead,
+ * which copies by value and never allocates. Long-lived mutable objects
+ * that do their own locking (maps, estimators) are swapped with AtomicShared.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace raisin_sdk {
+
+/**
+ * @brief Atomically replaceable std::shared_ptr<T>
+ *
+ * load() and store() are atomic on the shared pointer itself; neither
+ * takes an SDK mutex, so a reader is never blocked by decode or callbacks.
+ * Only swapping the pointer is synchronized: with a mutable T, concurrent
+ * use of the object relies on T's own locking.
+ */
+template <typename T>
+class AtomicShared {
+public:
+    using Ptr = std::shared_ptr<T>;
+
+    /// Current object, or nullptr if nothing was stored yet
+    Ptr load() const {
+#if defined(__cpp_lib_atomic_shared_ptr)
+        return ptr_.load(std::memory_order_acquire);
+#else
+        return std::atomic_load_explicit(&ptr_, std::memory_order_acquire);
+#endif
+    }
+
+    /// Replace the current object (the previous one lives on while referenced)
+    void store(Ptr value) {
+#if defined(__cpp_lib_atomic_shared_ptr)
+        ptr_.store(std::move(value), std::memory_order_release);
+#else
+        std::atomic_store_explicit(&ptr_, std::move(value), std::memory_order_release);
+#endif
+    }
+
+    void reset() { store(nullptr); }
+
+private:
+#if defined(__cpp_lib_atomic_shared_ptr)
+    std::atomic<Ptr> ptr_;
+#else
+    Ptr ptr_;
+#endif
+};
+
+/// Single-slot holder of the latest immutable snapshot
+template <typename T>
+using AtomicSnapshot = AtomicShared<const T>;
+
+/**
+ * @brief Pool of reusable snapshot buffers
+ *
+ * acquire() hands out a writable object (recycled when possible, so large
+ * vectors keep their capacity); publish() wraps it in a shared pointer whose
+ * deleter returns it to the pool once the last reader drops it. The pool
+ * must be owned by a shared_ptr (use create()); snapshots that outlive the
+ * pool are simply deleted.
+ */
+template <typename T>
+class SnapshotPool : public std::enable_shared_from_this<SnapshotPool<T>> {
+public:
+    /**
+     * @param maxIdle Maximum number of idle buffers kept for reuse
+     */
+    static std::shared_ptr<SnapshotPool> create(size_t maxIdle = 4) {
+        return std::shared_ptr<SnapshotPool>(new SnapshotPool(maxIdle));
+    }
+
+    /// Get a writable buffer; contents are whatever the previous user left
+    std::unique_ptr<T> acquire() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!idle_.empty()) {
+                std::unique_ptr<T> obj = std::move(idle_.back());
+                idle_.pop_back();
+                return obj;
+            }
+        }
+        return std::make_unique<T>();
+    }
+
+    /// Turn a filled buffer into an immutable, pool-returning snapshot
+    std::shared_ptr<const T> publish(std::unique_ptr<T> obj) {
+        std::weak_ptr<SnapshotPool> weak = this->shared_from_this();
+        return std::shared_ptr<const T>(obj.release(), [weak](const T* p) {
+            std::unique_ptr<T> owned(const_cast<T*>(p));
+            if (auto pool = weak.lock()) {
+                pool->recycle(std::move(owned));
+            }
+        });
+    }
+
+    /// Number of idle buffers currently pooled
+    size_t idleCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return idle_.size();
+    }
+
+private:
+    explicit SnapshotPool(size_t maxIdle) : maxIdle_(maxIdle) {}
+
+    void recycle(std::unique_ptr<T> obj) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (idle_.size() < maxIdle_) {
+            idle_.push_back(std::move(obj));
+        }
+    }
+
+    size_t maxIdle_;
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<T>> idle_;
+};
+
+/**
+ * @brief Single-writer sequence lock for trivially copyable values
+ *
+ * A double-buffered seqlock ("latch"): store() bumps the sequence and
+ * fills one slot while readers copy the other, then repeats for the second
+ * slot. The low bit of the sequence tells readers which slot is stable, so
+ * load() never waits for a store to finish; it retries only if the writer
+ * moved on to the other slot during the copy. store() takes no lock and
+ * never waits on readers. The payload is kept in relaxed atomic words,
+ * which compile to plain moves but keep the concurrent copy well-defined.
+ *
+ * version() counts completed stores: a poller compares it with the version
+ * returned by its last load() to skip the copy when nothing new arrived.
+ * Only one thread may call store().
+ */
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock needs a trivially copyable type");
+
+public:
+    SeqLock() {
+        const T empty{};
+        write(0, empty);
+        write(1, empty);
+    }
+
+    /// Publish a new value (single writer only)
+    void store(const T& value) {
+        const uint64_t seq = seq_.load(std::memory_order_relaxed);
+        // Release: the previous store's write(1) must be visible to readers
+        // that acquire the odd sequence and copy slot 1
+        seq_.store(seq + 1, std::memory_order_release);   // readers move to slot 1
+        std::atomic_thread_fence(std::memory_order_release);
+        write(0, value);
+        std::atomic_thread_fence(std::memory_order_release);
+        seq_.store(seq + 2, std::memory_order_relaxed);   // readers back to slot 0
+        std::atomic_thread_fence(std::memory_order_release);
+        write(1, value);
+    }
+
+    /**
+     * @brief Copy the latest value into out
+     * @return Version of the copied value (0 before the first store)
+     */
+    uint64_t load(T& out) const {
+        for (;;) {
+            const uint64_t seq = seq_.load(std::memory_order_acquire);
+            read(seq & 1, out);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) == seq) {
+                return seq >> 1;
+            }
+        }
+    }
+
+    T load() const {
+        T value;
+        load(value);
+        return value;
+    }
+
+    /// Number of completed stores; cheap enough to poll every control cycle
+    uint64_t version() const { return seq_.load(std::memory_order_acquire) >> 1; }
+
+private:
+    static constexpr size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    static constexpr size_t chunk(size_t i) {
+        return i + 1 < kWords ? sizeof(uint64_t) : sizeof(T) - i * sizeof(uint64_t);
+    }
+
+    void write(size_t slot, const T& value) {
+        const auto* bytes = reinterpret_cast<const unsigned char*>(&value);
+        for (size_t i = 0; i < kWords; ++i) {
+            uint64_t word = 0;
+            std::memcpy(&word, bytes + i * sizeof(uint64_t), chunk(i));
+            slots_[slot][i].store(word, std::memory_order_relaxed);
+        }
+    }
+
+    void read(size_t slot, T& out) const {
+        auto* bytes = reinterpret_cast<unsigned char*>(&out);
+        for (size_t i = 0; i < kWords; ++i) {
+            const uint64_t word = slots_[slot][i].load(std::memory_order_relaxed);
+            std::memcpy(bytes + i * sizeof(uint64_t), &word, chunk(i));
+        }
+    }
+
+    std::atomic<uint64_t> seq_{0};
+    std::atomic<uint64_t> slots_[2][kWords];
+};
+
+}  // namespace raisin_sdk
@@ -0,0 +1,344 @@
+/**
+ * @file spatial_index.hpp
+ * @brief KD-tree over the latest cloud for nearest-neighbour and radius queries
+ *
+ * KdTree is a flat, pointer-free KD-tree built in O(n log n) with
+ * nth_element. SpatialIndex rebuilds one on a background thread whenever
+ * a new cloud arrives and publishes it as an immutable snapshot, so the
+ * network thread never waits on a build and queries always run against
+ * the last completed tree.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "raisin_sdk/point_cloud.hpp"
+#include "raisin_sdk/snapshot.hpp"
+#include "raisin_sdk/voxel_grid.hpp"
+
+namespace raisin_sdk {
+
+/**
+ * @brief One query result
+ */
+struct Neighbor {
+    Point3D point;               ///< Indexed point
+    float distance_sq = 0.0f;    ///< Squared distance to the query point
+    uint32_t index = 0;          ///< Index of the point in the indexed cloud
+};
+
+/**
+ * @brief Static 3D KD-tree over a point set
+ *
+ * Nodes are implicit: the subtree over [begin, end) splits at
+ * mid = (begin + end) / 2 on axis_[mid], so the tree is just the reordered
+ * points plus one byte per point. build() reuses its buffers.
+ */
+class KdTree {
+public:
+    static constexpr size_t kLeafSize = 8;   ///< Ranges this small are scanned linearly
+
+    /// Build over points (non-finite points are skipped)
+    void build(const std::vector<Point3D>& points) {
+        points_.clear();
+        indices_.clear();
+        points_.reserve(points.size());
+        indices_.reserve(points.size());
+        for (size_t i = 0; i < points.size(); ++i) {
+            const Point3D& p = points[i];
+            if (std::isfinite(p.x) && std::isfinite(p.y) && std::isfinite(p.z)) {
+                points_.push_back(p);
+                indices_.push_back(static_cast<uint32_t>(i));
+            }
+        }
+        axis_.assign(points_.size(), 0);
+        order_.resize(points_.size());
+        for (size_t i = 0; i < order_.size(); ++i) order_[i] = static_cast<uint32_t>(i);
+        buildRange(0, order_.size());
+
+        // Store points in tree order so leaf scans are contiguous
+        scratch_.resize(points_.size());
+        scratchIndices_.resize(points_.size());
+        for (size_t i = 0; i < order_.size(); ++i) {
+            scratch_[i] = points_[order_[i]];
+            scratchIndices_[i] = indices_[order_[i]];
+        }
+        points_.swap(scratch_);
+        indices_.swap(scratchIndices_);
+    }
+
+    size_t size() const { return points_.size(); }
+    bool empty() const { return points_.empty(); }
+
+    /// Indexed points in tree order
+    const std::vector<Point3D>& points() const { return points_; }
+
+    /**
+     * @brief k nearest neighbours, closest first
+     * @param maxDistance Ignore points farther than this
+     */
+    void nearest(const Point3D& query, size_t k, std::vector<Neighbor>& out,
+                 float maxDistance = std::numeric_limits<float>::infinity()) const {
+        out.clear();
+        if (k == 0 || points_.empty()) return;
+        out.reserve(k);
+        float worst = maxDistance * maxDistance;
+        searchKnn(0, points_.size(), query, k, out, worst);
+        std::sort_heap(out.begin(), out.end(), closer);
+    }
+
+    /// Closest point; false if the tree is empty or nothing lies within maxDistance
+    bool nearest(const Point3D& query, Neighbor& out,
+                 float maxDistance = std::numeric_limits<float>::infinity()) const {
+        std::vector<Neighbor> result;
+        nearest(query, 1, result, maxDistance);
+        if (result.empty()) return false;
+        out = result.front();
+        return true;
+    }
+
+    /// All points within radius of query (unordered)
+    void radius(const Point3D& query, float radius, std::vector<Neighbor>& out) const {
+        out.clear();
+        if (points_.empty()) return;
+        searchRadius(0, points_.size(), query, radius * radius, out);
+    }
+
+private:
+    std::vector<Point3D> points_;
+    std::vector<uint32_t> indices_;    ///< Original index of each point
+    std::vector<uint8_t> axis_;        ///< Split axis of the node whose median is here
+    std::vector<uint32_t> order_;      ///< Build permutation
+    std::vector<Point3D> scratch_;
+    std::vector<uint32_t> scratchIndices_;
+
+    static float coord(const Point3D& p, int axis) {
+        return axis == 0 ? p.x : (axis == 1 ? p.y : p.z);
+    }
+
+    static float distanceSq(const Point3D& a, const Point3D& b) {
+        const float dx = a.x - b.x;
+        const float dy = a.y - b.y;
+        const float dz = a.z - b.z;
+        return dx * dx + dy * dy + dz * dz;
+    }
+
+    static bool closer(const Neighbor& a, const Neighbor& b) { return a.distance_sq < b.distance_sq; }
+
+    void buildRange(size_t begin, size_t end) {
+        if (end - begin <= kLeafSize) return;
+
+        // Split on the axis with the largest extent
+        float lo[3] = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+                       std::numeric_limits<float>::max()};
+        float hi[3] = {std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(),
+                       std::numeric_limits<float>::lowest()};
+        for (size_t i = begin; i < end; ++i) {
+            const Point3D& p = points_[order_[i]];
+            lo[0] = std::min(lo[0], p.x); hi[0] = std::max(hi[0], p.x);
+            lo[1] = std::min(lo[1], p.y); hi[1] = std::max(hi[1], p.y);
+            lo[2] = std::min(lo[2], p.z); hi[2] = std::max(hi[2], p.z);
+        }
+        int axis = 0;
+        if (hi[1] - lo[1] > hi[axis] - lo[axis]) axis = 1;
+        if (hi[2] - lo[2] > hi[axis] - lo[axis]) axis = 2;
+
+        const size_t mid = begin + (end - begin) / 2;
+        std::nth_element(order_.begin() + begin, order_.begin() + mid, order_.begin() + end,
+                         [&](uint32_t a, uint32_t b) {
+                             return coord(points_[a], axis) < coord(points_[b], axis);
+                         });
+        axis_[mid] = static_cast<uint8_t>(axis);
+        buildRange(begin, mid);
+        buildRange(mid + 1, end);
+    }
+
+    void offer(size_t i, const Point3D& query, size_t k, std::vector<Neighbor>& heap, float& worst) const {
+        const float d = distanceSq(points_[i], query);
+        if (d > worst) return;
+        if (heap.size() == k) {
+            std::pop_heap(heap.begin(), heap.end(), closer);
+            heap.pop_back();
+        }
+        heap.push_back({points_[i], d, indices_[i]});
+        std::push_heap(heap.begin(), heap.end(), closer);
+        if (heap.size() == k) worst = heap.front().distance_sq;
+    }
+
+    void searchKnn(size_t begin, size_t end, const Point3D& query, size_t k,
+                   std::vector<Neighbor>& heap, float& worst) const {
+        if (end - begin <= kLeafSize) {
+            for (size_t i = begin; i < end; ++i) offer(i, query, k, heap, worst);
+            return;
+        }
+        const size_t mid = begin + (end - begin) / 2;
+        const float diff = coord(query, axis_[mid]) - coord(points_[mid], axis_[mid]);
+
+        // Near side first, far side only if the splitting plane is closer than the k-th hit
+        if (diff < 0.0f) {
+            searchKnn(begin, mid, query, k, heap, worst);
+            offer(mid, query, k, heap, worst);
+            if (diff * diff <= worst) searchKnn(mid + 1, end, query, k, heap, worst);
+        } else {
+            searchKnn(mid + 1, end, query, k, heap, worst);
+            offer(mid, query, k, heap, worst);
+            if (diff * diff <= worst) searchKnn(begin, mid, query, k, heap, worst);
+        }
+    }
+
+    void searchRadius(size_t begin, size_t end, const Point3D& query, float radiusSq,
+                      std::vector<Neighbor>& out) const {
+        if (end - begin <= kLeafSize) {
+            for (size_t i = begin; i < end; ++i) {
+                const float d = distanceSq(points_[i], query);
+                if (d <= radiusSq) out.push_back({points_[i], d, indices_[i]});
+            }
+            return;
+        }
+        const size_t mid = begin + (end - begin) / 2;
+        const float diff = coord(query, axis_[mid]) - coord(points_[mid], axis_[mid]);
+        const float d = distanceSq(points_[mid], query);
+        if (d <= radiusSq) out.push_back({points_[mid], d, indices_[mid]});
+        if (diff <= 0.0f || diff * diff <= radiusSq) searchRadius(begin, mid, query, radiusSq, out);
+        if (diff >= 0.0f || diff * diff <= radiusSq) searchRadius(mid + 1, end, query, radiusSq, out);
+    }
+};
+
+/**
+ * @brief Spatial index settings
+ */
+struct SpatialIndexConfig {
+    float voxel_size = 0.0f;   ///< Downsample before indexing (<= 0 indexes every point)
+};
+
+/**
+ * @brief KD-tree over the latest cloud, rebuilt on a background thread
+ *
+ * update() only stores the cloud and wakes the builder; if clouds arrive
+ * faster than trees are built, intermediate clouds are skipped. Queries use
+ * the last completed tree, which stays valid for as long as the caller
+ * holds the snapshot returned by tree().
+ *
+ * @code
+ * raisin_sdk::SpatialIndex index;
+ * index.update(cloudView);   // network thread
+ * raisin_sdk::Neighbor closest;
+ * if (index.nearest({0.0f, 0.0f, 0.0f}, closest)) { ... }   // any thread
+ * @endcode
+ */
+class SpatialIndex {
+public:
+    explicit SpatialIndex(const SpatialIndexConfig& config = {})
+        : voxelFilter_(VoxelGridConfig{config.voxel_size}) {
+        builder_ = std::thread([this]() { buildLoop(); });
+    }
+
+    ~SpatialIndex() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_one();
+        builder_.join();
+    }
+
+    SpatialIndex(const SpatialIndex&) = delete;
+    SpatialIndex& operator=(const SpatialIndex&) = delete;
+
+    /// Queue a cloud for indexing (never blocks on a build)
+    void update(const PointCloudView& cloud) {
+        if (!cloud.hasXYZ()) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_ = cloud;
+            hasPending_ = true;
+        }
+        cv_.notify_one();
+    }
+
+    /// Last completed tree (nullptr before the first build)
+    std::shared_ptr<const KdTree> tree() const { return tree_.load(); }
+
+    /// Number of trees built so far
+    uint64_t buildCount() const { return buildCount_.load(std::memory_order_relaxed); }
+
+    /// k nearest neighbours in the last completed tree, closest first
+    void nearest(const Point3D& query, size_t k, std::vector<Neighbor>& out,
+                 float maxDistance = std::numeric_limits<float>::infinity()) const {
+        auto current = tree();
+        if (current) {
+            current->nearest(query, k, out, maxDistance);
+        } else {
+            out.clear();
+        }
+    }
+
+    bool nearest(const Point3D& query, Neighbor& out,
+                 float maxDistance = std::numeric_limits<float>::infinity()) const {
+        auto current = tree();
+        return current && current->nearest(query, out, maxDistance);
+    }
+
+    /// Points within radius in the last completed tree
+    void radius(const Point3D& query, float radius, std::vector<Neighbor>& out) const {
+        auto current = tree();
+        if (current) {
+            current->radius(query, radius, out);
+        } else {
+            out.clear();
+        }
+    }
+
+private:
+    std::thread builder_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    PointCloudView pending_;
+    bool hasPending_ = false;
+    bool stopping_ = false;
+
+    VoxelGridFilter voxelFilter_;   ///< Builder thread only
+    std::vector<Point3D> points_;   ///< Builder thread only
+    std::shared_ptr<SnapshotPool<KdTree>> pool_ = SnapshotPool<KdTree>::create(2);
+    AtomicSnapshot<KdTree> tree_;
+    std::atomic<uint64_t> buildCount_{0};
+
+    void buildLoop() {
+        for (;;) {
+            PointCloudView cloud;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this]() { return stopping_ || hasPending_; });
+                if (stopping_) return;
+                cloud = std::move(pending_);
+                pending_ = PointCloudView();
+                hasPending_ = false;
+            }
+
+            if (voxelFilter_.config().enabled()) {
+                voxelFilter_.apply(cloud, points_);
+            } else {
+                cloud.copyTo(points_);
+            }
+            cloud = PointCloudView();   // release the message before the build
+
+            std::unique_ptr<KdTree> tree = pool_->acquire();
+            tree->build(points_);
+            tree_.store(pool_->publish(std::move(tree)));
+            buildCount_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+};
+
+}  // namespace raisin_sdk
@@ -0,0 +1,492 @@
+/**
+ * @file telemetry.hpp
+ * @brief Columnar ring-buffer history of robot_state telemetry
+ *
+ * TelemetryHistory keeps the last N samples of battery, body temperature
+ * and per-actuator temperature/position/velocity/effort in one ring buffer
+ * per column. For a few configured windows ("last 1/10/60 s") it maintains
+ * running sums, monotonic min/max queues and a small histogram per column,
+ * so min/max/mean/stddev and approximate percentiles cost O(1) per query
+ * and O(1) amortized per recorded sample. Other windows are answered by a
+ * scan of the ring.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "raisin_sdk/robot_state.hpp"
+
+namespace raisin_sdk {
+
+/**
+ * @brief Recorded telemetry columns
+ */
+enum class TelemetryChannel {
+    VOLTAGE,
+    CURRENT,
+    BODY_TEMPERATURE,
+    ACTUATOR_TEMPERATURE,   ///< Per actuator
+    ACTUATOR_POSITION,      ///< Per actuator
+    ACTUATOR_VELOCITY,      ///< Per actuator
+    ACTUATOR_EFFORT         ///< Per actuator
+};
+
+/**
+ * @brief Value range covered by a channel's percentile histogram
+ * Values outside the range land in the edge bins; the reported percentile
+ * is still clamped to the window's exact min/max.
+ */
+struct TelemetryRange {
+    double min = 0.0;
+    double max = 1.0;
+};
+
+/**
+ * @brief TelemetryHistory settings
+ */
+struct TelemetryHistoryConfig {
+    size_t capacity = 6000;                          ///< Samples kept per column (60 s at 100 Hz)
+    size_t max_actuators = 32;                       ///< Actuators beyond this are not recorded
+    std::vector<double> windows = {1.0, 10.0, 60.0}; ///< Windows (s) with O(1) statistics
+    uint32_t histogram_bins = 64;                    ///< Percentile resolution (at most 256)
+    TelemetryRange voltage{0.0, 60.0};
+    TelemetryRange current{-20.0, 80.0};
+    TelemetryRange temperature{-20.0, 120.0};        ///< Body and actuator temperatures
+    TelemetryRange position{-6.3, 6.3};
+    TelemetryRange velocity{-40.0, 40.0};
+    TelemetryRange effort{-150.0, 150.0};
+};
+
+/**
+ * @brief Statistics of one column over a time window
+ */
+struct WindowStats {
+    size_t count = 0;     ///< Samples in the window (0 = no data, other fields unset)
+    double min = 0.0;
+    double max = 0.0;
+    double mean = 0.0;
+    double stddev = 0.0;  ///< Population standard deviation
+    double p05 = 0.0;     ///< Approximate for tracked windows, exact otherwise
+    double p50 = 0.0;
+    double p95 = 0.0;
+};
+
+namespace detail {
+
+/**
+ * @brief Growable ring of sample sequence numbers for monotonic min/max queues
+ */
+class SequenceQueue {
+public:
+    bool empty() const { return size_ == 0; }
+    uint64_t front() const { return buffer_[head_]; }
+    uint64_t back() const { return buffer_[(head_ + size_ - 1) & mask_]; }
+    void popFront() { head_ = (head_ + 1) & mask_; --size_; }
+    void popBack() { --size_; }
+    void clear() { head_ = size_ = 0; }
+
+    void pushBack(uint64_t seq) {
+        if (size_ == buffer_.size()) grow();
+        buffer_[(head_ + size_) & mask_] = seq;
+        ++size_;
+    }
+
+private:
+    void grow() {
+        std::vector<uint64_t> grown(std::max<size_t>(buffer_.size() * 2, 16));
+        for (size_t i = 0; i < size_; ++i) grown[i] = buffer_[(head_ + i) & mask_];
+        buffer_.swap(grown);
+        head_ = 0;
+        mask_ = buffer_.size() - 1;
+    }
+
+    std::vector<uint64_t> buffer_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+    size_t mask_ = 0;
+};
+
+}  // namespace detail
+
+/**
+ * @brief Fixed-capacity columnar history of robot_state telemetry
+ *
+ * Windows are measured back from the newest sample's stamp. Thread-safe:
+ * record() and the queries take an internal mutex, so the network thread
+ * can feed the history while a monitoring thread queries it. The actuator
+ * columns follow the order of the robot's actuator list; when that list
+ * changes the history starts over.
+ *
+ * @code
+ * auto history = client.enableTelemetryHistory();
+ * raisin_sdk::WindowStats current = history->stats(raisin_sdk::TelemetryChannel::CURRENT, 10.0);
+ * int knee = history->findActuator("FR_calf");
+ * auto temp = history->stats(raisin_sdk::TelemetryChannel::ACTUATOR_TEMPERATURE, 60.0, knee);
+ * @endcode
+ */
+class TelemetryHistory {
+public:
+    explicit TelemetryHistory(const TelemetryHistoryConfig& config = {}) : config_(config) {
+        config_.capacity = std::max<size_t>(config_.capacity, 2);
+        config_.histogram_bins = std::clamp<uint32_t>(config_.histogram_bins, 1, 256);
+        config_.windows.erase(std::remove_if(config_.windows.begin(), config_.windows.end(),
+                                             [](double w) { return !(w > 0.0); }),
+                              config_.windows.end());
+        stamps_.assign(config_.capacity, 0.0);
+        windows_.resize(config_.windows.size());
+        for (size_t w = 0; w < windows_.size(); ++w) {
+            windows_[w].seconds = config_.windows[w];
+        }
+        layout();
+    }
+
+    const TelemetryHistoryConfig& config() const { return config_; }
+
+    /// Record one decoded robot_state (stamp in seconds, increasing)
+    void record(const ExtendedRobotState& state, double stamp = now()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!sameActuators(state.actuators)) {
+            names_.clear();
+            for (size_t a = 0; a < std::min(state.actuators.size(), config_.max_actuators); ++a) {
+                names_.push_back(state.actuators[a].name);
+            }
+            layout();
+        }
+        if (head_ > 0 && stamp < stamps_[(head_ - 1) % config_.capacity]) {
+            stamp = stamps_[(head_ - 1) % config_.capacity];   // keep the ring ordered
+        }
+
+        // Make room: the slot of seq head_ - capacity is about to be reused
+        for (Window& window : windows_) {
+            while (window.tail < head_ &&
+                   (window.tail + config_.capacity <= head_ ||
+                    stamps_[window.tail % config_.capacity] <= stamp - window.seconds)) {
+                evict(window);
+            }
+        }
+
+        const size_t slot = head_ % config_.capacity;
+        stamps_[slot] = stamp;
+        store(0, slot, state.voltage);
+        store(1, slot, state.current);
+        store(2, slot, state.body_temperature);
+        for (size_t a = 0; a < names_.size(); ++a) {
+            const ActuatorInfo& act = state.actuators[a];
+            store(actuatorColumn(TelemetryChannel::ACTUATOR_TEMPERATURE, a), slot, act.temperature);
+            store(actuatorColumn(TelemetryChannel::ACTUATOR_POSITION, a), slot, act.position);
+            store(actuatorColumn(TelemetryChannel::ACTUATOR_VELOCITY, a), slot, act.velocity);
+            store(actuatorColumn(TelemetryChannel::ACTUATOR_EFFORT, a), slot, act.effort);
+        }
+
+        for (Window& window : windows_) {
+            if (window.tail == head_) rebase(window, slot);
+            for (size_t c = 0; c < activeColumns(); ++c) {
+                const size_t cell = c * config_.capacity + slot;
+                const double v = values_[cell];
+                const double d = v - window.ref[c];
+                window.sum[c] += d;
+                window.sumSq[c] += d * d;
+                ++window.histogram[c * config_.histogram_bins + bins_[cell]];
+                detail::SequenceQueue& lo = window.minQueue[c];
+                while (!lo.empty() && valueAt(c, lo.back()) >= v) lo.popBack();
+                lo.pushBack(head_);
+                detail::SequenceQueue& hi = window.maxQueue[c];
+                while (!hi.empty() && valueAt(c, hi.back()) <= v) hi.popBack();
+                hi.pushBack(head_);
+            }
+        }
+        ++head_;
+    }
+
+    /**
+     * @brief Statistics of a channel over the last seconds
+     * O(1) when seconds equals one of config().windows (percentiles from the
+     * window histogram), otherwise a scan of the samples in the window.
+     * @param actuator Actuator index for ACTUATOR_* channels (see findActuator())
+     */
+    WindowStats stats(TelemetryChannel channel, double seconds, int actuator = -1) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        WindowStats out;
+        const size_t column = columnOf(channel, actuator);
+        if (column == kNoColumn || head_ == 0) return out;
+        for (const Window& window : windows_) {
+            if (window.seconds == seconds) {
+                trackedStats(window, column, out);
+                return out;
+            }
+        }
+        scanStats(column, seconds, out);
+        return out;
+    }
+
+    /**
+     * @brief Copy a column's samples from the last seconds, oldest first
+     * @param stamps Optional output of the matching sample stamps
+     * @return Number of samples copied
+     */
+    size_t samples(TelemetryChannel channel, double seconds, std::vector<double>& values,
+                   int actuator = -1, std::vector<double>* stamps = nullptr) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        values.clear();
+        if (stamps) stamps->clear();
+        const size_t column = columnOf(channel, actuator);
+        if (column == kNoColumn || head_ == 0) return 0;
+        for (uint64_t seq = windowStart(seconds); seq < head_; ++seq) {
+            values.push_back(valueAt(column, seq));
+            if (stamps) stamps->push_back(stamps_[seq % config_.capacity]);
+        }
+        return values.size();
+    }
+
+    /// Index of the named actuator's columns, or -1
+    int findActuator(const std::string& name) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t a = 0; a < names_.size(); ++a) {
+            if (names_[a] == name) return static_cast<int>(a);
+        }
+        return -1;
+    }
+
+    /// Recorded actuator names in column order
+    std::vector<std::string> actuatorNames() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return names_;
+    }
+
+    /// Samples currently held (at most config().capacity)
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return static_cast<size_t>(std::min<uint64_t>(head_, config_.capacity));
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        reset();
+    }
+
+    /// Steady-clock time in seconds, the default record() stamp
+    static double now() {
+        return std::chrono::duration<double>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    static constexpr size_t kScalarColumns = 3;
+    static constexpr size_t kActuatorChannels = 4;
+    static constexpr size_t kNoColumn = static_cast<size_t>(-1);
+
+    struct Window {
+        double seconds = 0.0;
+        uint64_t tail = 0;                 ///< Oldest sample in the window
+        uint64_t evicted = 0;              ///< Evictions since sums were last recomputed
+        std::vector<double> sum;           ///< Sum of (value - ref) per column
+        std::vector<double> sumSq;
+        std::vector<double> ref;           ///< Offset that keeps sumSq well conditioned
+        std::vector<detail::SequenceQueue> minQueue;
+        std::vector<detail::SequenceQueue> maxQueue;
+        std::vector<uint32_t> histogram;   ///< columns x bins
+    };
+
+    /// Size the columns for the current actuator list and start over
+    void layout() {
+        const size_t columns = activeColumns();
+        values_.assign(columns * config_.capacity, 0.0);
+        bins_.assign(columns * config_.capacity, 0);
+        for (Window& window : windows_) {
+            window.sum.assign(columns, 0.0);
+            window.sumSq.assign(columns, 0.0);
+            window.ref.assign(columns, 0.0);
+            window.minQueue.assign(columns, detail::SequenceQueue());
+            window.maxQueue.assign(columns, detail::SequenceQueue());
+            window.histogram.assign(columns * config_.histogram_bins, 0);
+        }
+        reset();
+    }
+
+    void reset() {
+        head_ = 0;
+        for (Window& window : windows_) {
+            window.tail = 0;
+            window.evicted = 0;
+            std::fill(window.sum.begin(), window.sum.end(), 0.0);
+            std::fill(window.sumSq.begin(), window.sumSq.end(), 0.0);
+            std::fill(window.histogram.begin(), window.histogram.end(), 0);
+            for (auto& q : window.minQueue) q.clear();
+            for (auto& q : window.maxQueue) q.clear();
+        }
+    }
+
+    bool sameActuators(const std::vector<ActuatorInfo>& actuators) const {
+        if (names_.size() != std::min(actuators.size(), config_.max_actuators)) return false;
+        for (size_t a = 0; a < names_.size(); ++a) {
+            if (names_[a] != actuators[a].name) return false;
+        }
+        return true;
+    }
+
+    size_t activeColumns() const { return kScalarColumns + kActuatorChannels * names_.size(); }
+
+    size_t actuatorColumn(TelemetryChannel channel, size_t actuator) const {
+        const size_t offset = static_cast<size_t>(channel) - kScalarColumns;
+        return kScalarColumns + offset * names_.size() + actuator;
+    }
+
+    size_t columnOf(TelemetryChannel channel, int actuator) const {
+        if (static_cast<size_t>(channel) < kScalarColumns) return static_cast<size_t>(channel);
+        if (actuator < 0 || static_cast<size_t>(actuator) >= names_.size()) return kNoColumn;
+        return actuatorColumn(channel, static_cast<size_t>(actuator));
+    }
+
+    const TelemetryRange& rangeOf(size_t column) const {
+        if (column == 0) return config_.voltage;
+        if (column == 1) return config_.current;
+        if (column == 2) return config_.temperature;
+        switch ((column - kScalarColumns) / names_.size()) {
+            case 0: return config_.temperature;
+            case 1: return config_.position;
+            case 2: return config_.velocity;
+            default: return config_.effort;
+        }
+    }
+
+    /// Non-finite readings repeat the previous sample so the running sums stay finite
+    void store(size_t column, size_t slot, double value) {
+        const size_t cell = column * config_.capacity + slot;
+        if (!std::isfinite(value)) {
+            value = head_ > 0 ? values_[column * config_.capacity + (head_ - 1) % config_.capacity] : 0.0;
+        }
+        values_[cell] = value;
+        const TelemetryRange& range = rangeOf(column);
+        const double t = (value - range.min) / (range.max - range.min) * config_.histogram_bins;
+        bins_[cell] = static_cast<uint8_t>(std::clamp(t, 0.0, config_.histogram_bins - 1.0));
+    }
+
+    double valueAt(size_t column, uint64_t seq) const {
+        return values_[column * config_.capacity + seq % config_.capacity];
+    }
+
+    void evict(Window& window) {
+        const size_t slot = window.tail % config_.capacity;
+        for (size_t c = 0; c < activeColumns(); ++c) {
+            const size_t cell = c * config_.capacity + slot;
+            const double d = values_[cell] - window.ref[c];
+            window.sum[c] -= d;
+            window.sumSq[c] -= d * d;
+            --window.histogram[c * config_.histogram_bins + bins_[cell]];
+            if (!window.minQueue[c].empty() && window.minQueue[c].front() == window.tail) window.minQueue[c].popFront();
+            if (!window.maxQueue[c].empty() && window.maxQueue[c].front() == window.tail) window.maxQueue[c].popFront();
+        }
+        ++window.tail;
+        // Add/subtract drift: recompute exactly every capacity evictions (O(1) amortized)
+        if (++window.evicted >= config_.capacity && window.tail < head_) {
+            rebase(window, window.tail % config_.capacity);
+        }
+    }
+
+    /// Recompute the window sums around the values at refSlot
+    void rebase(Window& window, size_t refSlot) {
+        window.evicted = 0;
+        for (size_t c = 0; c < activeColumns(); ++c) {
+            const double ref = values_[c * config_.capacity + refSlot];
+            double sum = 0.0;
+            double sumSq = 0.0;
+            for (uint64_t seq = window.tail; seq < head_; ++seq) {
+                const double d = valueAt(c, seq) - ref;
+                sum += d;
+                sumSq += d * d;
+            }
+            window.ref[c] = ref;
+            window.sum[c] = sum;
+            window.sumSq[c] = sumSq;
+        }
+    }
+
+    uint64_t windowStart(double seconds) const {
+        const uint64_t oldest = head_ > config_.capacity ? head_ - config_.capacity : 0;
+        const double cutoff = stamps_[(head_ - 1) % config_.capacity] - seconds;
+        uint64_t seq = head_ - 1;
+        while (seq > oldest && stamps_[(seq - 1) % config_.capacity] > cutoff) --seq;
+        return seq;
+    }
+
+    void trackedStats(const Window& window, size_t column, WindowStats& out) const {
+        const uint64_t n = head_ - window.tail;
+        out.count = static_cast<size_t>(n);
+        out.min = valueAt(column, window.minQueue[column].front());
+        out.max = valueAt(column, window.maxQueue[column].front());
+        const double mean = window.sum[column] / n;
+        out.mean = window.ref[column] + mean;
+        out.stddev = std::sqrt(std::max(0.0, window.sumSq[column] / n - mean * mean));
+
+        const uint32_t* histogram = &window.histogram[column * config_.histogram_bins];
+        const TelemetryRange& range = rangeOf(column);
+        const double width = (range.max - range.min) / config_.histogram_bins;
+        auto percentile = [&](double q) {
+            const double target = q * n;
+            uint64_t below = 0;
+            for (uint32_t b = 0; b < config_.histogram_bins; ++b) {
+                if (histogram[b] == 0) continue;
+                if (below + histogram[b] >= target) {
+                    const double fraction = (target - below) / histogram[b];
+                    return std::clamp(range.min + (b + fraction) * width, out.min, out.max);
+                }
+                below += histogram[b];
+            }
+            return out.max;
+        };
+        out.p05 = percentile(0.05);
+        out.p50 = percentile(0.50);
+        out.p95 = percentile(0.95);
+    }
+
+    void scanStats(size_t column, double seconds, WindowStats& out) const {
+        scratch_.clear();
+        for (uint64_t seq = windowStart(seconds); seq < head_; ++seq) {
+            scratch_.push_back(valueAt(column, seq));
+        }
+        const size_t n = scratch_.size();
+        out.count = n;
+        const double ref = scratch_.front();
+        double sum = 0.0;
+        double sumSq = 0.0;
+        for (double v : scratch_) {
+            sum += v - ref;
+            sumSq += (v - ref) * (v - ref);
+        }
+        const double mean = sum / n;
+        out.mean = ref + mean;
+        out.stddev = std::sqrt(std::max(0.0, sumSq / n - mean * mean));
+        auto percentile = [&](double q) {
+            auto nth = scratch_.begin() + static_cast<std::ptrdiff_t>(std::min(n - 1, static_cast<size_t>(q * n)));
+            std::nth_element(scratch_.begin(), nth, scratch_.end());
+            return *nth;
+        };
+        out.p05 = percentile(0.05);
+        out.p50 = percentile(0.50);
+        out.p95 = percentile(0.95);
+        auto [lo, hi] = std::minmax_element(scratch_.begin(), scratch_.end());
+        out.min = *lo;
+        out.max = *hi;
+    }
+
+    TelemetryHistoryConfig config_;
+    std::vector<std::string> names_;
+    std::vector<double> stamps_;
+    std::vector<double> values_;   ///< (3 + 4 x actuators) columns x capacity, column-major
+    std::vector<uint8_t> bins_;    ///< Histogram bin of each value
+    std::vector<Window> windows_;
+    uint64_t head_ = 0;            ///< Sequence number of the next sample
+    mutable std::vector<double> scratch_;
+    mutable std::mutex mutex_;
+};
+
+}  // namespace raisin_sdk
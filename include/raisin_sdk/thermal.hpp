@@ -0,0 +1,328 @@
+/**
+ * @file thermal.hpp
+ * @brief Per-actuator thermal model fitting and time-to-threshold forecasts
+ *
+ * Each actuator is modelled as a first-order thermal system
+ *
+ *     dT/dt = a * effort^2 - b * (T - T_ambient)
+ *
+ * (Joule heating grows with torque squared, Newton cooling with the
+ * difference to ambient). ThermalForecaster fits a, b and the ambient term
+ * per actuator by recursive least squares with forgetting on fixed-length
+ * intervals of the robot_state stream, so each message costs O(actuators)
+ * and memory does not grow. Forecasts extrapolate the model under the
+ * recent (smoothed) load.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "raisin_sdk/robot_state.hpp"
+
+namespace raisin_sdk {
+
+/**
+ * @brief ThermalForecaster settings
+ */
+struct ThermalForecastConfig {
+    double threshold = 80.0;            ///< Temperature (C) the forecast counts down to (e.g. derating onset)
+    double interval = 2.0;              ///< Fit interval (s): temperature and load are averaged over it
+    double forgetting = 0.998;          ///< RLS forgetting factor per interval (memory ~ interval / (1 - forgetting))
+    double load_time_constant = 60.0;   ///< Smoothing of effort^2 used as the forecast load (s)
+    double effort_scale = 50.0;         ///< Typical effort (Nm); normalizes the heating regressor
+    size_t min_intervals = 30;          ///< Intervals before a model counts as fitted
+    double max_dt = 1.0;                ///< Longer message gaps restart the current interval
+};
+
+/**
+ * @brief Forecast for one actuator
+ */
+struct ActuatorThermalForecast {
+    std::string name;
+    bool fitted = false;                 ///< Enough data for the model fields below
+    double temperature = 0.0;            ///< Latest measured temperature (C)
+    double heating_rate = 0.0;           ///< Model dT/dt now under the smoothed load (C/s)
+    double steady_state_temperature = std::numeric_limits<double>::infinity();  ///< Where the current load settles (C)
+    double time_constant_sec = std::numeric_limits<double>::infinity();         ///< Cooling time constant 1/b
+    double time_to_threshold_sec = std::numeric_limits<double>::infinity();     ///< 0 if already above, inf if never
+};
+
+/**
+ * @brief Incremental per-actuator thermal forecasting
+ *
+ * Thread-safe: update() and the queries take an internal mutex. The model
+ * follows the robot's actuator list; when it changes, fitting starts over.
+ *
+ * @code
+ * auto thermal = client.enableThermalForecast({75.0});
+ * std::vector<raisin_sdk::ActuatorThermalForecast> forecasts;
+ * thermal->forecast(forecasts);
+ * for (const auto& f : forecasts) {
+ *     if (f.fitted && f.time_to_threshold_sec < 300.0) {
+ *         std::cout << f.name << " reaches 75 C in " << f.time_to_threshold_sec << " s" << std::endl;
+ *     }
+ * }
+ * @endcode
+ */
+class ThermalForecaster {
+public:
+    explicit ThermalForecaster(const ThermalForecastConfig& config = {}) : config_(config) {
+        config_.interval = std::max(config_.interval, 1e-3);
+        config_.forgetting = std::clamp(config_.forgetting, 0.9, 1.0);
+        config_.effort_scale = std::max(config_.effort_scale, 1e-3);
+    }
+
+    const ThermalForecastConfig& config() const { return config_; }
+
+    /// Add one robot_state sample (stamp in seconds, increasing)
+    void update(const ExtendedRobotState& state, double stamp = now()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!sameActuators(state.actuators)) {
+            models_.assign(state.actuators.size(), Model());
+            names_.clear();
+            for (const auto& act : state.actuators) names_.push_back(act.name);
+            intervalStart_ = stamp;
+            lastStamp_ = stamp;
+        }
+        const double dt = stamp - lastStamp_;
+        lastStamp_ = stamp;
+        if (dt > config_.max_dt || dt < 0.0) {
+            for (Model& m : models_) m.restartInterval();
+            intervalStart_ = stamp;
+        }
+
+        const double alpha = dt > 0.0 ? 1.0 - std::exp(-dt / std::max(config_.load_time_constant, dt)) : 0.0;
+        const double inverseScale = 1.0 / config_.effort_scale;
+        for (size_t i = 0; i < models_.size(); ++i) {
+            const ActuatorInfo& act = state.actuators[i];
+            if (!std::isfinite(act.temperature) || !std::isfinite(act.effort)) continue;
+            const double effort = act.effort * inverseScale;
+            const double load = effort * effort;
+            Model& m = models_[i];
+            m.temperature = act.temperature;
+            m.load = m.hasLoad ? m.load + alpha * (load - m.load) : load;
+            m.hasLoad = true;
+            m.sumTemperature += act.temperature;
+            m.sumLoad += load;
+            ++m.samples;
+        }
+
+        const double elapsed = stamp - intervalStart_;
+        if (elapsed >= config_.interval) {
+            for (Model& m : models_) m.closeInterval(elapsed, config_.forgetting);
+            intervalStart_ = stamp;
+        }
+    }
+
+    /// Forecasts for all actuators, in the robot's actuator order (out is reused)
+    void forecast(std::vector<ActuatorThermalForecast>& out) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        out.resize(models_.size());
+        for (size_t i = 0; i < models_.size(); ++i) {
+            if (out[i].name != names_[i]) out[i].name = names_[i];
+            fill(models_[i], out[i]);
+        }
+    }
+
+    /// Forecast of one actuator (default-constructed if the name is unknown)
+    ActuatorThermalForecast forecast(const std::string& name) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ActuatorThermalForecast out;
+        for (size_t i = 0; i < names_.size(); ++i) {
+            if (names_[i] == name) {
+                out.name = name;
+                fill(models_[i], out);
+                break;
+            }
+        }
+        return out;
+    }
+
+    /**
+     * @brief Model temperature of an actuator after horizon seconds under the current load
+     * @return NaN if the actuator is unknown or not fitted yet
+     */
+    double predictTemperature(const std::string& name, double horizon) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < names_.size(); ++i) {
+            if (names_[i] != name) continue;
+            const Model& m = models_[i];
+            if (!fitted(m)) break;
+            const double rate = m.rate(m.temperature, m.load);
+            const double b = m.coolingRate();
+            if (b <= kMinCooling) return m.temperature + rate * horizon;
+            const double steady = m.temperature + rate / b;
+            return steady + (m.temperature - steady) * std::exp(-b * horizon);
+        }
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    /**
+     * @brief Actuator expected to reach the threshold first
+     * @return Index into forecast() order, or -1 if no fitted actuator is heading there
+     */
+    int soonestOverheat(double* seconds = nullptr) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        int best = -1;
+        double bestTime = std::numeric_limits<double>::infinity();
+        ActuatorThermalForecast f;
+        for (size_t i = 0; i < models_.size(); ++i) {
+            fill(models_[i], f);
+            if (f.fitted && f.time_to_threshold_sec < bestTime) {
+                bestTime = f.time_to_threshold_sec;
+                best = static_cast<int>(i);
+            }
+        }
+        if (seconds) *seconds = bestTime;
+        return best;
+    }
+
+    void reset() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        models_.clear();
+        names_.clear();
+    }
+
+    /// Steady-clock time in seconds, the default update() stamp
+    static double now() {
+        return std::chrono::duration<double>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    static constexpr double kTemperatureRef = 50.0;   ///< Centre/scale of the temperature regressor (C)
+    static constexpr double kMinCooling = 1e-5;       ///< Below this (1/s) cooling is treated as unidentified
+
+    /**
+     * @brief RLS fit of dT/dt = th0 * load + th1 * (T - ref) / ref + th2
+     * so a = th0, b = -th1 / ref and the ambient term is th2.
+     */
+    struct Model {
+        double theta[3] = {0.0, 0.0, 0.0};
+        double p[3][3] = {{1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}, {0.0, 0.0, 1.0}};
+        size_t intervals = 0;
+        double temperature = 0.0;       ///< Latest reading
+        double load = 0.0;              ///< Smoothed normalized effort^2
+        bool hasLoad = false;
+        double sumTemperature = 0.0;    ///< Sums over the open interval
+        double sumLoad = 0.0;
+        size_t samples = 0;             ///< Finite readings in the open interval
+        bool hasPrevious = false;       ///< Previous interval means are valid
+        double prevTemperature = 0.0;
+        double prevLoad = 0.0;
+        double prevDuration = 0.0;
+
+        double rate(double t, double u) const {
+            return theta[0] * u + theta[1] * (t - kTemperatureRef) / kTemperatureRef + theta[2];
+        }
+
+        double coolingRate() const { return -theta[1] / kTemperatureRef; }
+
+        void restartInterval() {
+            sumTemperature = sumLoad = 0.0;
+            samples = 0;
+            hasPrevious = false;
+        }
+
+        /// Regress the change between consecutive interval means on their midpoint state
+        void closeInterval(double duration, double forgetting) {
+            if (samples == 0) {  // no finite reading: no mean to difference against
+                restartInterval();
+                return;
+            }
+            const double meanTemperature = sumTemperature / samples;
+            const double meanLoad = sumLoad / samples;
+            sumTemperature = sumLoad = 0.0;
+            samples = 0;
+            if (hasPrevious) {
+                const double dt = 0.5 * (prevDuration + duration);
+                const double y = (meanTemperature - prevTemperature) / dt;
+                const double midTemperature = 0.5 * (meanTemperature + prevTemperature);
+                const double phi[3] = {0.5 * (meanLoad + prevLoad),
+                                       (midTemperature - kTemperatureRef) / kTemperatureRef, 1.0};
+                fit(phi, y, forgetting);
+                ++intervals;
+            }
+            prevTemperature = meanTemperature;
+            prevLoad = meanLoad;
+            prevDuration = duration;
+            hasPrevious = true;
+        }
+
+        void fit(const double phi[3], double y, double forgetting) {
+            double pphi[3];
+            for (int i = 0; i < 3; ++i) {
+                pphi[i] = p[i][0] * phi[0] + p[i][1] * phi[1] + p[i][2] * phi[2];
+            }
+            const double denom = forgetting + phi[0] * pphi[0] + phi[1] * pphi[1] + phi[2] * pphi[2];
+            const double error = y - (theta[0] * phi[0] + theta[1] * phi[1] + theta[2] * phi[2]);
+            for (int i = 0; i < 3; ++i) {
+                theta[i] += pphi[i] / denom * error;
+            }
+            for (int i = 0; i < 3; ++i) {
+                for (int j = i; j < 3; ++j) {
+                    p[i][j] = (p[i][j] - pphi[i] * pphi[j] / denom) / forgetting;
+                    p[j][i] = p[i][j];
+                }
+            }
+            // Heating cannot be negative and cooling cannot pump heat in
+            theta[0] = std::max(theta[0], 0.0);
+            theta[1] = std::min(theta[1], 0.0);
+        }
+    };
+
+    bool fitted(const Model& m) const { return m.intervals >= config_.min_intervals; }
+
+    void fill(const Model& m, ActuatorThermalForecast& out) const {
+        const double inf = std::numeric_limits<double>::infinity();
+        out.temperature = m.temperature;
+        out.fitted = fitted(m);
+        out.heating_rate = 0.0;
+        out.steady_state_temperature = inf;
+        out.time_constant_sec = inf;
+        out.time_to_threshold_sec = inf;
+        if (!out.fitted) return;
+
+        const double threshold = config_.threshold;
+        const double rate = m.rate(m.temperature, m.load);
+        const double b = m.coolingRate();
+        out.heating_rate = rate;
+        if (m.temperature >= threshold) {
+            out.time_to_threshold_sec = 0.0;
+        }
+        if (b > kMinCooling) {
+            const double steady = m.temperature + rate / b;
+            out.steady_state_temperature = steady;
+            out.time_constant_sec = 1.0 / b;
+            if (m.temperature < threshold && steady > threshold) {
+                out.time_to_threshold_sec = std::log((steady - m.temperature) / (steady - threshold)) / b;
+            }
+        } else if (m.temperature < threshold && rate > 0.0) {
+            out.time_to_threshold_sec = (threshold - m.temperature) / rate;
+        }
+    }
+
+    bool sameActuators(const std::vector<ActuatorInfo>& actuators) const {
+        if (names_.size() != actuators.size()) return false;
+        for (size_t i = 0; i < names_.size(); ++i) {
+            if (names_[i] != actuators[i].name) return false;
+        }
+        return true;
+    }
+
+    ThermalForecastConfig config_;
+    std::vector<Model> models_;
+    std::vector<std::string> names_;
+    double intervalStart_ = 0.0;
+    double lastStamp_ = 0.0;
+    mutable std::mutex mutex_;
+};
+
+}  // namespace raisin_sdk
@@ -0,0 +1,497 @@
+/**
+ * @file voxel_grid.hpp
+ * @brief Hashed voxel-grid downsampling for live point clouds
+ *
+ * VoxelGridFilter reduces a cloud to one point per occupied voxel, either
+ * the centroid of the voxel's points or the first point that fell in it.
+ * Voxels are found through open-addressing hash tables that are reused
+ * across frames, and large clouds are split across a WorkerPool by
+ * partitioning voxels on their hash.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "raisin_sdk/parallel.hpp"
+#include "raisin_sdk/point_cloud.hpp"
+#include "raisin_sdk/point_cloud_soa.hpp"
+
+namespace raisin_sdk {
+
+/**
+ * @brief Which point represents a voxel
+ */
+enum class VoxelMode {
+    CENTROID = 0,     ///< Mean of all points in the voxel
+    FIRST_POINT = 1   ///< First point (in message order) that fell in the voxel
+};
+
+/**
+ * @brief Voxel-grid downsampling settings
+ */
+struct VoxelGridConfig {
+    float voxel_size = 0.0f;                 ///< Voxel edge length in metres (<= 0 disables)
+    VoxelMode mode = VoxelMode::CENTROID;    ///< Representative point per voxel
+    size_t parallel_threshold = 100000;      ///< Clouds smaller than this run single-threaded
+
+    bool enabled() const { return voxel_size > 0.0f; }
+};
+
+namespace detail {
+
+/// Marks points that are not finite or outside the key range
+constexpr uint64_t kInvalidVoxelKey = ~0ull;
+
+/// Voxel indices per axis that fit in a key: [-kVoxelIndexRange, kVoxelIndexRange)
+constexpr int64_t kVoxelIndexRange = int64_t(1) << 20;
+
+/**
+ * @brief floor(scaled) as a voxel index, clamped to one past the key range
+ * Keeps the integer cast defined for large or non-finite input (NaN maps low);
+ * clamped results still fall outside the range packVoxelIndex accepts.
+ */
+inline int64_t voxelIndex(double scaled) {
+    constexpr double kLimit = static_cast<double>(kVoxelIndexRange + 1);
+    if (!(scaled > -kLimit)) return -(kVoxelIndexRange + 1);
+    if (scaled > kLimit) return kVoxelIndexRange + 1;
+    return static_cast<int64_t>(std::floor(scaled));
+}
+
+/**
+ * @brief Pack signed integer voxel coordinates into 63 bits (21 bits per axis)
+ * Covers +-2^20 voxels per axis, e.g. +-52 km at 5 cm voxels.
+ */
+inline uint64_t packVoxelIndex(int64_t ix, int64_t iy, int64_t iz) {
+    constexpr int64_t kBias = kVoxelIndexRange;
+    constexpr int64_t kMax = (int64_t(1) << 21) - 1;
+    ix += kBias;
+    iy += kBias;
+    iz += kBias;
+    if (ix < 0 || iy < 0 || iz < 0 || ix > kMax || iy > kMax || iz > kMax) return kInvalidVoxelKey;
+
+    return static_cast<uint64_t>(ix) | (static_cast<uint64_t>(iy) << 21) |
+           (static_cast<uint64_t>(iz) << 42);
+}
+
+/// Voxel key of a point (kInvalidVoxelKey if not finite or out of range)
+inline uint64_t packVoxelKey(float x, float y, float z, float inverseSize) {
+    if (!std::isfinite(x) || !std::isfinite(y) || !std::isfinite(z)) return kInvalidVoxelKey;
+    return packVoxelIndex(voxelIndex(x * inverseSize), voxelIndex(y * inverseSize),
+                          voxelIndex(z * inverseSize));
+}
+
+/// splitmix64 finalizer; spreads adjacent voxel keys over the table
+inline uint64_t hashVoxelKey(uint64_t key) {
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ull;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebull;
+    key ^= key >> 31;
+    return key;
+}
+
+/**
+ * @brief Open-addressing (linear probing) map from voxel key to uint32 index
+ *
+ * Slots carry a generation stamp, so prepare() empties the table in O(1)
+ * instead of clearing it; storage only grows. erase() uses backward-shift
+ * deletion, so long-lived tables never accumulate tombstones. The hash
+ * passed in must always be hashVoxelKey(key).
+ */
+class VoxelHashTable {
+public:
+    /// Empty the table and make room for about `expected` entries
+    void prepare(size_t expected) {
+        size_t capacity = 16;
+        while (capacity < expected * 2) capacity <<= 1;
+        if (capacity > keys_.size()) {
+            keys_.assign(capacity, 0);
+            values_.assign(capacity, 0);
+            stamps_.assign(capacity, 0);
+            generation_ = 0;
+        }
+        mask_ = keys_.size() - 1;
+        if (++generation_ == 0) {
+            std::fill(stamps_.begin(), stamps_.end(), 0);
+            generation_ = 1;
+        }
+        size_ = 0;
+    }
+
+    /**
+     * @brief Find key, inserting it with newValue if absent
+     * @param inserted Set to true if the key was new
+     * @return Stored value for key
+     */
+    uint32_t findOrInsert(uint64_t key, uint64_t hash, uint32_t newValue, bool& inserted) {
+        if ((size_ + 1) * 2 > keys_.size()) grow();
+        size_t slot = hash & mask_;
+        for (;;) {
+            if (stamps_[slot] != generation_) {
+                stamps_[slot] = generation_;
+                keys_[slot] = key;
+                values_[slot] = newValue;
+                ++size_;
+                inserted = true;
+                return newValue;
+            }
+            if (keys_[slot] == key) {
+                inserted = false;
+                return values_[slot];
+            }
+            slot = (slot + 1) & mask_;
+        }
+    }
+
+    /// Pointer to the value stored for key, or nullptr
+    uint32_t* find(uint64_t key, uint64_t hash) {
+        if (keys_.empty()) return nullptr;
+        size_t slot = hash & mask_;
+        while (stamps_[slot] == generation_) {
+            if (keys_[slot] == key) return &values_[slot];
+            slot = (slot + 1) & mask_;
+        }
+        return nullptr;
+    }
+
+    const uint32_t* find(uint64_t key, uint64_t hash) const {
+        return const_cast<VoxelHashTable*>(this)->find(key, hash);
+    }
+
+    /// Remove key; returns false if it was not present
+    bool erase(uint64_t key, uint64_t hash) {
+        if (keys_.empty()) return false;
+        size_t slot = hash & mask_;
+        while (stamps_[slot] == generation_ && keys_[slot] != key) {
+            slot = (slot + 1) & mask_;
+        }
+        if (stamps_[slot] != generation_) return false;
+
+        // Shift later members of the probe run back into the hole
+        size_t hole = slot;
+        size_t next = (hole + 1) & mask_;
+        while (stamps_[next] == generation_) {
+            const size_t home = hashVoxelKey(keys_[next]) & mask_;
+            const bool movable = hole <= next ? (home <= hole || home > next)
+                                              : (home <= hole && home > next);
+            if (movable) {
+                keys_[hole] = keys_[next];
+                values_[hole] = values_[next];
+                hole = next;
+            }
+            next = (next + 1) & mask_;
+        }
+        stamps_[hole] = generation_ - 1;
+        --size_;
+        return true;
+    }
+
+    size_t size() const { return size_; }
+
+private:
+    std::vector<uint64_t> keys_;
+    std::vector<uint32_t> values_;
+    std::vector<uint32_t> stamps_;
+    uint32_t generation_ = 0;
+    size_t mask_ = 0;
+    size_t size_ = 0;
+
+    void grow() {
+        std::vector<uint64_t> oldKeys;
+        std::vector<uint32_t> oldValues;
+        std::vector<uint32_t> oldStamps;
+        oldKeys.swap(keys_);
+        oldValues.swap(values_);
+        oldStamps.swap(stamps_);
+        const uint32_t oldGeneration = generation_;
+
+        const size_t capacity = std::max<size_t>(16, oldKeys.size() * 2);
+        keys_.assign(capacity, 0);
+        values_.assign(capacity, 0);
+        stamps_.assign(capacity, 0);
+        generation_ = 1;
+        mask_ = capacity - 1;
+        size_ = 0;
+
+        for (size_t i = 0; i < oldKeys.size(); ++i) {
+            if (oldStamps[i] != oldGeneration) continue;
+            bool inserted;
+            findOrInsert(oldKeys[i], hashVoxelKey(oldKeys[i]), oldValues[i], inserted);
+        }
+    }
+};
+
+}  // namespace detail
+
+/**
+ * @brief Voxel-grid downsampler with reusable tables
+ *
+ * One instance per stream; not thread-safe. All internal buffers keep
+ * their capacity between calls, so steady-state frames do not allocate.
+ *
+ * Output order is deterministic: voxels are emitted grouped by hash
+ * partition, in order of first occurrence within each partition.
+ */
+class VoxelGridFilter {
+public:
+    explicit VoxelGridFilter(const VoxelGridConfig& config = {},
+                             std::shared_ptr<WorkerPool> pool = nullptr)
+        : config_(config), pool_(std::move(pool)) {}
+
+    const VoxelGridConfig& config() const { return config_; }
+    void setConfig(const VoxelGridConfig& config) { config_ = config; }
+
+    /// Downsample straight from a PointCloud2 view (no intermediate copy)
+    void apply(const PointCloudView& in, std::vector<Point3D>& out) {
+        if (!in.hasXYZ()) {
+            out.clear();
+            return;
+        }
+        build(in.size(), [&in](size_t i) { return in.point(i); }, nullptr);
+        emitPoints(out, [&in](size_t i) { return in.point(i); });
+    }
+
+    void apply(const std::vector<Point3D>& in, std::vector<Point3D>& out) {
+        build(in.size(), [&in](size_t i) { return in[i]; }, nullptr);
+        emitPoints(out, [&in](size_t i) { return in[i]; });
+    }
+
+    /**
+     * @brief Downsample any indexable source into caller-owned storage
+     * @param pointAt  pointAt(i) -> Point3D for i in [0, n); called concurrently
+     * @param allocate allocate(count) -> Point3D* with room for count points
+     *
+     * Lets memory-mapped files or message buffers be reduced without first
+     * converting them to a point vector.
+     */
+    template <typename PointFn, typename AllocFn>
+    void apply(size_t n, const PointFn& pointAt, const AllocFn& allocate) {
+        build(n, pointAt, nullptr);
+        writePoints(allocate(total_), pointAt);
+    }
+
+    /**
+     * @brief Downsample an SoA cloud
+     * Centroid mode averages x/y/z/intensity; ring and time are taken from
+     * the voxel's first point in both modes.
+     */
+    void apply(const PointCloudSoA& in, PointCloudSoA& out);
+
+    /// Number of occupied voxels in the last apply()
+    size_t voxelCount() const { return total_; }
+
+private:
+    struct Voxel {
+        double sum_x = 0.0;
+        double sum_y = 0.0;
+        double sum_z = 0.0;
+        double sum_intensity = 0.0;
+        uint32_t count = 0;
+        uint32_t first = 0;
+    };
+
+    VoxelGridConfig config_;
+    std::shared_ptr<WorkerPool> pool_;   ///< WorkerPool::shared() if not given, on first large cloud
+
+    static constexpr uint8_t kNoPartition = 0xFF;   ///< partition_ entry of a point with no voxel
+
+    std::vector<uint64_t> keys_;
+    std::vector<uint8_t> partition_;         ///< Owning partition per point (parallel builds)
+    std::vector<size_t> bucketCount_;        ///< Per (block, partition) count, then scatter offset
+    std::vector<size_t> partitionStart_;     ///< Start of each partition's bucket in order_
+    std::vector<uint32_t> order_;            ///< Point indices bucketed by partition
+    std::vector<detail::VoxelHashTable> tables_;
+    std::vector<std::vector<Voxel>> voxels_;
+    std::vector<size_t> outputOffset_;
+    size_t numPartitions_ = 1;
+    size_t total_ = 0;
+
+    template <typename PointFn>
+    void build(size_t n, const PointFn& pointAt, const float* intensity) {
+        if (n >= config_.parallel_threshold && !pool_) pool_ = WorkerPool::shared();
+        const bool parallel = n >= config_.parallel_threshold && pool_->concurrency() > 1;
+        numPartitions_ = parallel ? std::min<size_t>(pool_->concurrency(), 64) : 1;
+        const float inverseSize = config_.enabled() ? 1.0f / config_.voxel_size : 0.0f;
+
+        keys_.resize(n);
+        if (tables_.size() < numPartitions_) tables_.resize(numPartitions_);
+        if (voxels_.size() < numPartitions_) voxels_.resize(numPartitions_);
+
+        // Phase 2 body: fold point i into its partition's voxels
+        const bool centroid = config_.mode == VoxelMode::CENTROID;
+        auto accumulatePoint = [&](detail::VoxelHashTable& table, std::vector<Voxel>& voxels, size_t i) {
+            const uint64_t key = keys_[i];
+            bool inserted;
+            const uint32_t index = table.findOrInsert(
+                key, detail::hashVoxelKey(key), static_cast<uint32_t>(voxels.size()), inserted);
+            if (inserted) {
+                Voxel voxel;
+                voxel.first = static_cast<uint32_t>(i);
+                voxels.push_back(voxel);
+            }
+            if (centroid) {
+                const Point3D p = pointAt(i);
+                Voxel& voxel = voxels[index];
+                voxel.sum_x += p.x;
+                voxel.sum_y += p.y;
+                voxel.sum_z += p.z;
+                if (intensity) voxel.sum_intensity += intensity[i];
+                ++voxel.count;
+            }
+        };
+
+        auto computeKey = [&](size_t i) {
+            const Point3D p = pointAt(i);
+            const uint64_t key = config_.enabled()
+                ? detail::packVoxelKey(p.x, p.y, p.z, inverseSize)
+                : static_cast<uint64_t>(i);  // disabled: every point is its own voxel
+            keys_[i] = key;
+            return key;
+        };
+
+        if (!parallel) {
+            auto& table = tables_[0];
+            auto& voxels = voxels_[0];
+            voxels.clear();
+            table.prepare(n / 4 + 16);
+            for (size_t i = 0; i < n; ++i) computeKey(i);
+            for (size_t i = 0; i < n; ++i) {
+                if (keys_[i] != detail::kInvalidVoxelKey) accumulatePoint(table, voxels, i);
+            }
+        } else {
+            // Phase 1: voxel key and owning partition of every point, counted
+            // per (block, partition) so phase 2 can bucket indices without a sort
+            const size_t partitions = numPartitions_;
+            const size_t blocks = partitions;
+            partition_.resize(n);
+            bucketCount_.assign(blocks * partitions, 0);
+            auto blockBegin = [n, blocks](size_t b) { return n * b / blocks; };
+            pool_->parallelFor(blocks, [&](size_t b) {
+                size_t* counts = bucketCount_.data() + b * partitions;
+                for (size_t i = blockBegin(b), end = blockBegin(b + 1); i < end; ++i) {
+                    const uint64_t key = computeKey(i);
+                    uint8_t part = kNoPartition;
+                    if (key != detail::kInvalidVoxelKey) {
+                        part = static_cast<uint8_t>((detail::hashVoxelKey(key) >> 32) % partitions);
+                        ++counts[part];
+                    }
+                    partition_[i] = part;
+                }
+            });
+
+            // Exclusive prefix over (partition, block): each block scatters into
+            // its own slice, so every bucket stays in ascending point order
+            partitionStart_.assign(partitions + 1, 0);
+            size_t offset = 0;
+            for (size_t part = 0; part < partitions; ++part) {
+                partitionStart_[part] = offset;
+                for (size_t b = 0; b < blocks; ++b) {
+                    const size_t count = bucketCount_[b * partitions + part];
+                    bucketCount_[b * partitions + part] = offset;
+                    offset += count;
+                }
+            }
+            partitionStart_[partitions] = offset;
+            order_.resize(offset);
+            pool_->parallelFor(blocks, [&](size_t b) {
+                size_t* next = bucketCount_.data() + b * partitions;
+                for (size_t i = blockBegin(b), end = blockBegin(b + 1); i < end; ++i) {
+                    const uint8_t part = partition_[i];
+                    if (part != kNoPartition) order_[next[part]++] = static_cast<uint32_t>(i);
+                }
+            });
+
+            // Phase 2: each partition accumulates its own bucket of points
+            pool_->parallelFor(partitions, [&](size_t part) {
+                auto& table = tables_[part];
+                auto& voxels = voxels_[part];
+                voxels.clear();
+                const size_t begin = partitionStart_[part];
+                const size_t end = partitionStart_[part + 1];
+                table.prepare((end - begin) / 4 + 16);
+                for (size_t k = begin; k < end; ++k) accumulatePoint(table, voxels, order_[k]);
+            });
+        }
+
+        outputOffset_.assign(numPartitions_ + 1, 0);
+        for (size_t p = 0; p < numPartitions_; ++p) {
+            outputOffset_[p + 1] = outputOffset_[p] + voxels_[p].size();
+        }
+        total_ = outputOffset_[numPartitions_];
+    }
+
+    /// Phase 3: write one point per voxel, partitions in parallel
+    template <typename EmitFn>
+    void forEachVoxel(const EmitFn& emit) {
+        auto run = [&](size_t part) {
+            size_t o = outputOffset_[part];
+            for (const Voxel& voxel : voxels_[part]) {
+                emit(o++, voxel);
+            }
+        };
+        if (numPartitions_ > 1) {
+            pool_->parallelFor(numPartitions_, run);
+        } else {
+            run(0);
+        }
+    }
+
+    template <typename PointFn>
+    void emitPoints(std::vector<Point3D>& out, const PointFn& pointAt) {
+        out.resize(total_);
+        writePoints(out.data(), pointAt);
+    }
+
+    template <typename PointFn>
+    void writePoints(Point3D* out, const PointFn& pointAt) {
+        const bool centroid = config_.mode == VoxelMode::CENTROID;
+        forEachVoxel([&](size_t o, const Voxel& voxel) {
+            if (centroid) {
+                const double inv = 1.0 / voxel.count;
+                out[o] = {static_cast<float>(voxel.sum_x * inv),
+                          static_cast<float>(voxel.sum_y * inv),
+                          static_cast<float>(voxel.sum_z * inv)};
+            } else {
+                out[o] = pointAt(voxel.first);
+            }
+        });
+    }
+};
+
+inline void VoxelGridFilter::apply(const PointCloudSoA& in, PointCloudSoA& out) {
+    build(in.size(), [&in](size_t i) { return in.point(i); },
+          in.has_intensity ? in.intensity.data() : nullptr);
+
+    out.has_intensity = in.has_intensity;
+    out.has_ring = in.has_ring;
+    out.has_time = in.has_time;
+    out.resize(total_);
+
+    const bool centroid = config_.mode == VoxelMode::CENTROID;
+    forEachVoxel([&](size_t o, const Voxel& voxel) {
+        const size_t first = voxel.first;
+        if (centroid) {
+            const double inv = 1.0 / voxel.count;
+            out.x[o] = static_cast<float>(voxel.sum_x * inv);
+            out.y[o] = static_cast<float>(voxel.sum_y * inv);
+            out.z[o] = static_cast<float>(voxel.sum_z * inv);
+            out.intensity[o] = static_cast<float>(voxel.sum_intensity * inv);
+        } else {
+            out.x[o] = in.x[first];
+            out.y[o] = in.y[first];
+            out.z[o] = in.z[first];
+            out.intensity[o] = in.intensity[first];
+        }
+        if (out.has_ring) out.ring[o] = in.ring[first];
+        if (out.has_time) out.time[o] = in.time[first];
+    });
+}
+
+}  // namespace raisin_sdk
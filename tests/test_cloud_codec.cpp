@@ -0,0 +1,139 @@
+/**
+ * @file test_cloud_codec.cpp
+ * @brief Round trips through CloudEncoder and CloudFrameDecoder
+ *
+ * Positions must come back within half a quantum, intensity within half an
+ * intensity step and ring exactly. Empty frames decode to empty clouds;
+ * truncated frames and non-positive quanta are rejected with an error.
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <vector>
+
+#include "raisin_sdk/cloud_codec.hpp"
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const char* what) {
+    if (!ok) {
+        std::printf("FAILED: %s\n", what);
+        ++failures;
+    }
+}
+
+/// Scan-like cloud with intensity and ring, plus one non-finite point the encoder skips
+raisin_sdk::PointCloudSoA makeCloud(size_t n) {
+    raisin_sdk::PointCloudSoA cloud;
+    cloud.has_intensity = true;
+    cloud.has_ring = true;
+    cloud.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        const double angle = 0.01 * static_cast<double>(i);
+        const double range = 5.0 + 0.37 * static_cast<double>(i % 13);
+        cloud.x[i] = static_cast<float>(range * std::cos(angle));
+        cloud.y[i] = static_cast<float>(range * std::sin(angle));
+        cloud.z[i] = static_cast<float>(-1.0 + 0.05 * static_cast<double>(i % 32));
+        cloud.intensity[i] = static_cast<float>((i * 7) % 250);
+        cloud.ring[i] = static_cast<uint16_t>(i % 32);
+    }
+    cloud.x[n / 2] = std::numeric_limits<float>::quiet_NaN();
+    return cloud;
+}
+
+void testSoARoundTrip() {
+    const raisin_sdk::PointCloudSoA cloud = makeCloud(5000);
+    raisin_sdk::CloudCodecConfig config;
+    raisin_sdk::CloudEncoder encoder(config);
+    std::vector<uint8_t> frame;
+    check(encoder.encode(cloud, frame), "encode SoA");
+    check(raisin_sdk::CloudFrameDecoder::frameSize(frame.data(), frame.size()) == frame.size(),
+          "frameSize matches the encoded frame");
+
+    raisin_sdk::CloudFrameDecoder decoder;
+    raisin_sdk::PointCloudSoA out;
+    check(decoder.decode(frame, out), "decode SoA");
+    check(out.size() == cloud.size() - 1, "non-finite point dropped");
+    check(out.has_intensity && out.has_ring && !out.has_time, "channel flags");
+    if (out.size() != cloud.size() - 1) return;
+
+    float maxError = 0.0f, maxIntensityError = 0.0f;
+    bool ringExact = true;
+    for (size_t i = 0, j = 0; i < cloud.size(); ++i) {
+        if (!std::isfinite(cloud.x[i])) continue;
+        maxError = std::fmax(maxError, std::fabs(out.x[j] - cloud.x[i]));
+        maxError = std::fmax(maxError, std::fabs(out.y[j] - cloud.y[i]));
+        maxError = std::fmax(maxError, std::fabs(out.z[j] - cloud.z[i]));
+        maxIntensityError = std::fmax(maxIntensityError, std::fabs(out.intensity[j] - cloud.intensity[i]));
+        ringExact = ringExact && out.ring[j] == cloud.ring[i];
+        ++j;
+    }
+    check(maxError <= 0.5f * config.quantum + 1e-5f, "positions within half a quantum");
+    check(maxIntensityError <= 0.5f * config.intensity_quantum + 1e-4f, "intensity within half a step");
+    check(ringExact, "ring exact");
+
+    // Positions-only decode of the same frame
+    std::vector<raisin_sdk::Point3D> points;
+    check(decoder.decode(frame, points) && points.size() == out.size() && points[7].x == out.x[7],
+          "positions-only decode");
+}
+
+void testEmptyFrame() {
+    raisin_sdk::CloudEncoder encoder;
+    std::vector<uint8_t> frame;
+    check(encoder.encode(std::vector<raisin_sdk::Point3D>(), frame), "encode empty");
+    check(frame.size() >= raisin_sdk::detail::kCloudFrameHeaderSize, "empty frame has a header");
+
+    raisin_sdk::CloudFrameDecoder decoder;
+    raisin_sdk::PointCloudSoA out = makeCloud(10);
+    check(decoder.decode(frame, out) && out.empty() && !out.has_intensity && !out.has_ring, "decode empty");
+}
+
+void testTruncatedFrame() {
+    raisin_sdk::CloudEncoder encoder;
+    std::vector<uint8_t> frame;
+    check(encoder.encode(makeCloud(1000), frame), "encode for truncation");
+
+    raisin_sdk::CloudFrameDecoder decoder;
+    raisin_sdk::PointCloudSoA out;
+    check(!decoder.decode(frame.data(), raisin_sdk::detail::kCloudFrameHeaderSize - 1, out),
+          "truncated header rejected");
+    check(raisin_sdk::CloudFrameDecoder::frameSize(frame.data(), 8) == 0, "frameSize of a partial header");
+    check(!decoder.decode(frame.data(), frame.size() - 1, out) && !decoder.lastError().empty(),
+          "truncated payload rejected");
+
+    std::vector<uint8_t> corrupt = frame;
+    corrupt[0] ^= 0xff;
+    check(!decoder.decode(corrupt, out), "bad magic rejected");
+}
+
+void testInvalidQuantum() {
+    raisin_sdk::CloudCodecConfig config;
+    config.quantum = 0.0f;
+    raisin_sdk::CloudEncoder encoder(config);
+    std::vector<uint8_t> frame(4);
+    check(!encoder.encode(makeCloud(100), frame) && frame.empty() && !encoder.lastError().empty(),
+          "zero quantum rejected");
+
+    config.quantum = 0.001f;
+    config.intensity_quantum = -1.0f;
+    encoder.setConfig(config);
+    check(!encoder.encode(makeCloud(100), frame), "negative intensity quantum rejected");
+    check(encoder.encode(std::vector<raisin_sdk::Point3D>{{1.0f, 2.0f, 3.0f}}, frame),
+          "intensity quantum unused without intensity");
+}
+
+}  // namespace
+
+int main() {
+    testSoARoundTrip();
+    testEmptyFrame();
+    testTruncatedFrame();
+    testInvalidQuantum();
+    std::printf("CloudCodec round trips -> %s\n", failures == 0 ? "OK" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
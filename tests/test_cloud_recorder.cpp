@@ -0,0 +1,134 @@
+/**
+ * @file test_cloud_recorder.cpp
+ * @brief CloudRecorder binary and binary_compressed output read back through PcdFile
+ *
+ * Each frame must reopen with the recorded point count, fields, exact
+ * positions and the pose in VIEWPOINT. Binary files are also checked
+ * channel by channel through their interleaved records.
+ */
+
+#include <unistd.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "raisin_sdk/cloud_recorder.hpp"
+#include "raisin_sdk/pcd_file.hpp"
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const std::string& what) {
+    if (!ok) {
+        std::printf("FAILED: %s\n", what.c_str());
+        ++failures;
+    }
+}
+
+raisin_sdk::PointCloudSoA makeCloud(size_t n, size_t frame) {
+    raisin_sdk::PointCloudSoA cloud;
+    cloud.has_intensity = true;
+    cloud.has_ring = true;
+    cloud.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        cloud.x[i] = 0.01f * static_cast<float>(i) + static_cast<float>(frame);
+        cloud.y[i] = -0.02f * static_cast<float>(i % 97);
+        cloud.z[i] = 0.5f * static_cast<float>(i % 16);
+        cloud.intensity[i] = static_cast<float>(i % 200);
+        cloud.ring[i] = static_cast<uint16_t>(i % 16);
+    }
+    return cloud;
+}
+
+template <typename T>
+T readAt(const uint8_t* record, uint32_t offset) {
+    T value;
+    std::memcpy(&value, record + offset, sizeof(T));
+    return value;
+}
+
+void testFormat(raisin_sdk::RecordFormat format, const std::filesystem::path& dir) {
+    const bool compressed = format == raisin_sdk::RecordFormat::PCD_BINARY_COMPRESSED;
+    const std::string label = compressed ? "binary_compressed" : "binary";
+    constexpr size_t kFrames = 3;
+    constexpr size_t kPoints = 4000;
+
+    raisin_sdk::CloudRecorderConfig config;
+    config.path = dir.string();
+    config.format = format;
+    raisin_sdk::CloudRecorder recorder;
+    check(recorder.open(config), label + ": open");
+    for (size_t f = 0; f < kFrames; ++f) {
+        const auto pose = raisin_sdk::CloudPose::fromYaw(1.0 + f, 2.0, 0.5, 0.25 * f);
+        check(recorder.record(makeCloud(kPoints, f), pose, 1000.0 + f), label + ": record");
+    }
+    recorder.close();
+    const raisin_sdk::RecorderStats stats = recorder.stats();
+    check(stats.written == kFrames && stats.dropped == 0 && !stats.failed, label + ": all frames written");
+
+    for (size_t f = 0; f < kFrames; ++f) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "cloud_%06zu.pcd", f + 1);
+        const std::string frameLabel = label + " frame " + std::to_string(f + 1);
+        raisin_sdk::PcdFile pcd;
+        if (!pcd.open((dir / name).string())) {
+            check(false, frameLabel + ": reopen (" + pcd.lastError() + ")");
+            continue;
+        }
+        check(pcd.format() == (compressed ? raisin_sdk::PcdFile::DataFormat::BINARY_COMPRESSED
+                                          : raisin_sdk::PcdFile::DataFormat::BINARY),
+              frameLabel + ": data format");
+        check(pcd.size() == kPoints && pcd.hasXYZ(), frameLabel + ": point count");
+        check(pcd.field("intensity") && pcd.field("ring") && pcd.fields().size() == 5, frameLabel + ": fields");
+
+        const auto pose = raisin_sdk::CloudPose::fromYaw(1.0 + f, 2.0, 0.5, 0.25 * f);
+        const double* vp = pcd.viewpoint();
+        check(std::fabs(vp[0] - pose.x) < 1e-6 && std::fabs(vp[3] - pose.qw) < 1e-6 &&
+                  std::fabs(vp[6] - pose.qz) < 1e-6,
+              frameLabel + ": viewpoint");
+        if (pcd.size() != kPoints) continue;
+
+        const raisin_sdk::PointCloudSoA expected = makeCloud(kPoints, f);
+        bool positions = true;
+        for (size_t i = 0; i < kPoints; ++i) {
+            const raisin_sdk::Point3D p = pcd.point(i);
+            positions = positions && p.x == expected.x[i] && p.y == expected.y[i] && p.z == expected.z[i];
+        }
+        check(positions, frameLabel + ": positions exact");
+
+        if (!compressed) {
+            const uint8_t* records = pcd.packedXYZ();
+            check(records && pcd.pointStep() == 18, frameLabel + ": interleaved records");
+            if (!records || !pcd.field("intensity") || !pcd.field("ring")) continue;
+            const uint32_t intensityOffset = pcd.field("intensity")->offset;
+            const uint32_t ringOffset = pcd.field("ring")->offset;
+            bool channels = true;
+            for (size_t i = 0; i < kPoints; ++i) {
+                const uint8_t* record = records + i * pcd.pointStep();
+                channels = channels && readAt<float>(record, intensityOffset) == expected.intensity[i] &&
+                           readAt<uint16_t>(record, ringOffset) == expected.ring[i];
+            }
+            check(channels, frameLabel + ": intensity and ring exact");
+        }
+    }
+}
+
+}  // namespace
+
+int main() {
+    const std::filesystem::path root = std::filesystem::temp_directory_path() /
+                                       ("raisin_sdk_test_cloud_recorder_" + std::to_string(::getpid()));
+    testFormat(raisin_sdk::RecordFormat::PCD_BINARY, root / "binary");
+    testFormat(raisin_sdk::RecordFormat::PCD_BINARY_COMPRESSED, root / "compressed");
+    std::error_code ec;
+    std::filesystem::remove_all(root, ec);
+
+    std::printf("CloudRecorder PCD read-back -> %s\n", failures == 0 ? "OK" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}